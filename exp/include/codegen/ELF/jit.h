@@ -0,0 +1,72 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_BACKEND_ELF_JIT_H
+#define EXP_BACKEND_ELF_JIT_H
+
+#include "codegen/ELF/object.h"
+
+/**
+ * @brief the address an undefined symbol of an object is bound to
+ * when it is loaded.
+ */
+typedef struct ELF_JitBinding {
+    StringView name;
+    u64        address;
+} ELF_JitBinding;
+
+/**
+ * @brief the .text section of an ELF_Object, relocated into
+ * executable memory.
+ *
+ * @note each undefined symbol is reached through a stub placed
+ * after .text, which jumps to the absolute address it is bound to,
+ * so bindings need not be within reach of a rel32.
+ */
+typedef struct ELF_Jit {
+    u8  *memory;
+    u64  size;
+    u64  symbol_count;
+    u64 *symbol_addresses;
+} ELF_Jit;
+
+/**
+ * @brief map <object> into memory, binding its undefined symbols
+ * to the given addresses, and make it executable.
+ *
+ * @note diagnostics are written to stderr.
+ *
+ * @return EXIT_FAILURE if a symbol is unbound, or a relocation is
+ * unsupported, EXIT_SUCCESS otherwise
+ */
+i32 elf_jit_load(ELF_Jit *restrict jit,
+                 ELF_Object const *restrict object,
+                 u64                   binding_count,
+                 ELF_JitBinding const *bindings);
+
+void elf_jit_unload(ELF_Jit *restrict jit);
+
+/**
+ * @brief the address of the symbol <name> within the loaded object
+ *
+ * @return false if <name> is not defined by the object
+ */
+bool elf_jit_symbol(ELF_Jit const *restrict jit,
+                    ELF_Object const *restrict object,
+                    StringView name,
+                    u64 *restrict address);
+
+#endif // !EXP_BACKEND_ELF_JIT_H
@@ -0,0 +1,99 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_BACKEND_ELF_LINKER_H
+#define EXP_BACKEND_ELF_LINKER_H
+
+#include "support/string.h"
+
+/**
+ * @brief an ELF64 relocatable object given to the linker.
+ *
+ * @note objects given directly are always linked, objects which
+ * are members of an archive are only linked if they define a
+ * symbol which is otherwise undefined.
+ */
+typedef struct ELF_LinkerObject {
+    StringView name;
+    StringView bytes;
+    bool       included;
+    u64       *section_addresses;
+} ELF_LinkerObject;
+
+typedef struct ELF_LinkerObjects {
+    u64               count;
+    u64               capacity;
+    ELF_LinkerObject *buffer;
+} ELF_LinkerObjects;
+
+/**
+ * @brief a global symbol defined by one of the linked objects.
+ */
+typedef struct ELF_LinkerSymbol {
+    StringView name;
+    u64        object;
+    u16        section;
+    u64        value;
+    bool       weak;
+} ELF_LinkerSymbol;
+
+typedef struct ELF_LinkerSymbols {
+    u64               count;
+    u64               capacity;
+    ELF_LinkerSymbol *buffer;
+} ELF_LinkerSymbols;
+
+/**
+ * @brief a minimal static linker for x86-64 ELF objects.
+ *
+ * @note the linker does not own the bytes of its inputs,
+ * they must outlive the linker.
+ */
+typedef struct ELF_Linker {
+    ELF_LinkerObjects objects;
+    ELF_LinkerSymbols symbols;
+} ELF_Linker;
+
+void elf_linker_create(ELF_Linker *restrict linker);
+void elf_linker_destroy(ELF_Linker *restrict linker);
+
+void elf_linker_add_object(ELF_Linker *restrict linker,
+                           StringView name,
+                           StringView bytes);
+
+/**
+ * @brief add each member of the ar(1) archive <bytes> as an
+ * object which is only linked if it is needed.
+ *
+ * @return EXIT_FAILURE if the archive is malformed, EXIT_SUCCESS otherwise
+ */
+i32 elf_linker_add_archive(ELF_Linker *restrict linker,
+                           StringView name,
+                           StringView bytes);
+
+/**
+ * @brief link the objects into a static executable whose
+ * entry point is the symbol <entry>.
+ *
+ * @note diagnostics are written to stderr.
+ *
+ * @return EXIT_FAILURE on any error, EXIT_SUCCESS otherwise
+ */
+i32 elf_linker_link(ELF_Linker *restrict linker,
+                    StringView entry,
+                    String *restrict executable);
+
+#endif // !EXP_BACKEND_ELF_LINKER_H
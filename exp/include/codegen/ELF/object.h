@@ -0,0 +1,121 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_BACKEND_ELF_OBJECT_H
+#define EXP_BACKEND_ELF_OBJECT_H
+
+#include "support/string.h"
+
+/**
+ * @brief a symbol within an ELF relocatable object.
+ *
+ * @note all symbols are global. a symbol which is referenced
+ * but never defined is emitted as undefined, and left for the
+ * linker to resolve.
+ */
+typedef struct ELF_Symbol {
+    StringView name;
+    u64        offset;
+    u64        size;
+    bool       defined;
+} ELF_Symbol;
+
+/**
+ * @brief a relocation against the .text section.
+ *
+ * @note type is one of the R_X86_64_* relocation types.
+ */
+typedef struct ELF_Relocation {
+    u64 offset;
+    u32 symbol;
+    u32 type;
+    i64 addend;
+} ELF_Relocation;
+
+typedef struct ELF_Symbols {
+    u64         count;
+    u64         capacity;
+    ELF_Symbol *buffer;
+} ELF_Symbols;
+
+typedef struct ELF_Relocations {
+    u64             count;
+    u64             capacity;
+    ELF_Relocation *buffer;
+} ELF_Relocations;
+
+/**
+ * @brief an in memory representation of an ELF64 relocatable
+ * object file, holding a single .text section.
+ */
+typedef struct ELF_Object {
+    String          text;
+    ELF_Symbols     symbols;
+    ELF_Relocations relocations;
+} ELF_Object;
+
+void elf_object_create(ELF_Object *restrict object);
+void elf_object_destroy(ELF_Object *restrict object);
+
+/**
+ * @brief the offset of the next byte appended to the .text section
+ */
+u64 elf_object_text_offset(ELF_Object const *restrict object);
+
+void elf_object_append_text(ELF_Object *restrict object,
+                            u8 const *bytes,
+                            u64       length);
+
+/**
+ * @brief return the index of the symbol with the given name,
+ * adding an undefined symbol if no such symbol exists yet.
+ */
+u32 elf_object_symbol(ELF_Object *restrict object, StringView name);
+
+/**
+ * @brief define the symbol <name> to be the <size> bytes of .text
+ * starting at <offset>
+ */
+void elf_object_define_symbol(ELF_Object *restrict object,
+                              StringView name,
+                              u64        offset,
+                              u64        size);
+
+void elf_object_relocation(ELF_Object *restrict object,
+                           u64 offset,
+                           u32 symbol,
+                           u32 type,
+                           i64 addend);
+
+/**
+ * @brief serialize the object into the bytes of an ELF64 relocatable file
+ *
+ * @param object the object to serialize
+ * @param file_name the name of the source file, recorded as an STT_FILE symbol
+ * @param buffer the buffer to append the file to
+ */
+void elf_object_serialize(ELF_Object const *restrict object,
+                          StringView file_name,
+                          String *restrict buffer);
+
+/**
+ * @brief serialize the object and write it to the file at <path>
+ */
+void elf_object_write(ELF_Object const *restrict object,
+                      StringView file_name,
+                      StringView path);
+
+#endif // !EXP_BACKEND_ELF_OBJECT_H
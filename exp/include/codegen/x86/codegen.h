@@ -17,10 +17,14 @@
 #ifndef EXP_BACKEND_X86_CODEGEN_H
 #define EXP_BACKEND_X86_CODEGEN_H
 
+#include "codegen/ELF/object.h"
 #include "codegen/x86/env/context.h"
 #include "env/context.h"
 
 i32 x86_codegen(Context *context);
+i32 x86_codegen_buffer(Context *context, String *restrict buffer);
+i32 x86_codegen_object(Context *context);
+i32 x86_codegen_object_buffer(Context *context, ELF_Object *restrict object);
 
 void x86_codegen_symbol(Symbol *restrict symbol,
                         x86_Context *restrict x86_context);
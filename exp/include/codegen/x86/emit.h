@@ -19,6 +19,15 @@
 
 #include "codegen/x86/env/context.h"
 
+/**
+ * @brief append the assembly of every symbol to <buffer>
+ */
+void x86_emit_buffer(x86_Context *restrict x86_context,
+                     String *restrict buffer);
+
+/**
+ * @brief write the assembly of every symbol to the assembly artifact
+ */
 void x86_emit(x86_Context *restrict x86_context);
 
 #endif // !EXP_BACKEND_X86_EMIT_H
@@ -0,0 +1,38 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_BACKEND_X86_ENCODE_H
+#define EXP_BACKEND_X86_ENCODE_H
+
+#include "codegen/ELF/object.h"
+#include "codegen/x86/env/context.h"
+
+/**
+ * @brief encode the x86 symbols directly into an ELF relocatable
+ * object, written to the object path of the context.
+ *
+ * @note this is the alternative to x86_emit followed by assemble,
+ * it does not round trip through assembly text or the assembler.
+ */
+void x86_encode(x86_Context *restrict x86_context);
+
+/**
+ * @brief encode the x86 symbols into <object>, which is left in memory
+ */
+void x86_encode_object(x86_Context *restrict x86_context,
+                       ELF_Object *restrict object);
+
+#endif // !EXP_BACKEND_X86_ENCODE_H
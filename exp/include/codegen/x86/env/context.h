@@ -20,11 +20,16 @@
 #include "codegen/x86/env/symbols.h"
 #include "env/context.h"
 
+/**
+ * @note <arena> holds the data which only the backend uses, such as
+ * each x86_Allocation, it is released with the x86_Context.
+ */
 typedef struct x86_Context {
     x86_SymbolTable symbols;
     Context        *context;
     Function       *body;
     x86_Function   *x86_body;
+    Arena           arena;
 } x86_Context;
 
 // x64 context functions
@@ -38,8 +43,9 @@ x86_Symbol *x86_context_symbol(x86_Context *x86_context, StringView name);
 // context constants functions
 Value *x86_context_value_at(x86_Context *x86_context, u32 index);
 
-// context global symbol table functions
-// StringView x86_context_global_labels_at(x86_Context *x86_context, u32 index);
+// context global labels functions
+ConstantString *x86_context_global_labels_at(x86_Context *x86_context,
+                                             u32          index);
 
 // context x64 function functions
 void x86_context_enter_function(x86_Context *x86_context, StringView name);
@@ -20,6 +20,7 @@
 #include "codegen/x86/imr/location.h"
 #include "imr/lifetime.h"
 #include "imr/type.h"
+#include "support/arena.h"
 
 /*
  * #TODO: since the only unique piece of information here is the
@@ -34,8 +35,11 @@ typedef struct x86_Allocation {
     Type const  *type;
 } x86_Allocation;
 
-x86_Allocation *x86_allocation_allocate();
-void            x86_allocation_deallocate(x86_Allocation *restrict allocation);
+/**
+ * @brief allocate a zeroed allocation from <arena>, it is
+ * freed along with the arena.
+ */
+x86_Allocation *x86_allocation_allocate(Arena *restrict arena);
 
 bool x86_allocation_location_eq(x86_Allocation *restrict allocation,
                                 x86_Location location);
@@ -47,14 +47,18 @@ typedef struct x86_AllocationBuffer {
 /**
  * @brief manages where SSA locals are allocated
  *
+ * @note each x86_Allocation is allocated from <arena>, which
+ * is owned by the x86_Context and outlives the allocator.
  */
 typedef struct x64_Allocator {
     x86_GPRP             gprp;
     x86_StackAllocations stack_allocations;
     x86_AllocationBuffer allocations;
+    Arena               *arena;
 } x86_Allocator;
 
-void x86_allocator_create(x86_Allocator *restrict allocator);
+void x86_allocator_create(x86_Allocator *restrict allocator,
+                          Arena *restrict arena);
 void x86_allocator_destroy(x86_Allocator *restrict allocator);
 
 bool x86_allocator_uses_stack(x86_Allocator *restrict allocator);
@@ -41,5 +41,9 @@ void x86_bytecode_emit(x86_Bytecode *restrict bc,
                        String *restrict buffer,
                        Context *restrict context);
 
+void x86_bytecode_encode(x86_Bytecode *restrict bc,
+                         ELF_Object *restrict object,
+                         Context *restrict context);
+
 #endif // !EXP_BACKEND_X86_BYTECODE_H
 
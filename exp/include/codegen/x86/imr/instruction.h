@@ -17,6 +17,7 @@
 #ifndef EXP_BACKEND_X64_INSTRUCTION_H
 #define EXP_BACKEND_X64_INSTRUCTION_H
 
+#include "codegen/ELF/object.h"
 #include "codegen/x86/imr/operand.h"
 #include "env/context.h"
 #include "support/string.h"
@@ -58,4 +59,12 @@ void x86_instruction_emit(x86_Instruction I,
                           String *restrict buffer,
                           Context *restrict context);
 
+/**
+ * @brief encode the instruction as machine code, appending it to the
+ * .text section of <object>
+ */
+void x86_instruction_encode(x86_Instruction I,
+                            ELF_Object *restrict object,
+                            Context *restrict context);
+
 #endif // !EXP_BACKEND_X64_INSTRUCTION_H
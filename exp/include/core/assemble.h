@@ -17,7 +17,19 @@
 #ifndef EXP_CORE_ASSEMBLE_H
 #define EXP_CORE_ASSEMBLE_H
 #include "env/context.h"
+#include "support/process.h"
 
 i32 assemble(Context *restrict context);
 
+/**
+ * @brief start assembling, without waiting for as(1) to finish.
+ */
+void assemble_spawn(Context *restrict context, Process *restrict as);
+
+/**
+ * @brief assemble <assembly> by piping it to as(1), without
+ * writing the assembly artifact.
+ */
+i32 assemble_buffer(Context *restrict context, StringView assembly);
+
 #endif // !EXP_CORE_ASSEMBLE_H
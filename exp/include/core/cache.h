@@ -0,0 +1,65 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_CORE_CACHE_H
+#define EXP_CORE_CACHE_H
+#include "env/context.h"
+#include "env/function_cache.h"
+
+/**
+ * @brief a directory of previously built artifacts, keyed by a hash
+ * of everything which determines their contents.
+ *
+ * @note the key of a context covers the source path and bytes, the
+ * options which select and shape the artifacts, the compiler version,
+ * and the runtime libraries. the cache is not modified once created,
+ * so it may be shared by contexts compiling on different threads.
+ * <functions> caches the functions of a source whose artifacts
+ * missed, within the same directory.
+ */
+typedef struct Cache {
+    String        directory;
+    u64           seed;
+    FunctionCache functions;
+} Cache;
+
+/**
+ * @brief open the cache directory, creating it if necessary.
+ *
+ * @note the directory is $EXP_CACHE_DIR, $XDG_CACHE_HOME/exp
+ * or $HOME/.cache/exp, whichever is found first.
+ */
+void cache_create(Cache *restrict cache);
+void cache_destroy(Cache *restrict cache);
+
+/**
+ * @brief compute the key of <context>, and copy its artifacts out
+ * of the cache if they are all present.
+ *
+ * @return true on a cache hit
+ */
+bool cache_retrieve(Cache const *restrict cache,
+                    Context *restrict context,
+                    String *restrict key);
+
+/**
+ * @brief copy the artifacts of <context> into the cache under <key>
+ */
+void cache_store(Cache const *restrict cache,
+                 Context *restrict context,
+                 StringView key);
+
+#endif // !EXP_CORE_CACHE_H
@@ -16,9 +16,15 @@
 // along with exp.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef EXP_CODEGEN_CODEGEN_H
 #define EXP_CODEGEN_CODEGEN_H
+#include "codegen/ELF/object.h"
 #include "env/context.h"
 
 i32 codegen_ir(Context *restrict context);
 i32 codegen_assembly(Context *restrict context);
+i32 codegen_assembly_buffer(Context *restrict context,
+                            String *restrict buffer);
+i32 codegen_object(Context *restrict context);
+i32 codegen_object_buffer(Context *restrict context,
+                          ELF_Object *restrict object);
 
 #endif // !EXP_CODEGEN_CODEGEN_H
@@ -16,8 +16,22 @@
 // along with exp.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef EXP_CORE_COMPILE_H
 #define EXP_CORE_COMPILE_H
+#include "env/context_pool.h"
 #include "support/scalar.h"
+#include "support/string.h"
 
 i32 compile(i32 argc, char const *argv[]);
 
+/**
+ * @brief as compile, drawing the interners of each context from
+ * <pool>, and returning them to it afterwards.
+ *
+ * @param artifacts if not NULL, the path of every artifact left
+ * behind by a successful unit is appended, one per line.
+ */
+i32 compile_with_pool(i32 argc,
+                      char const *argv[],
+                      ContextPool *pool,
+                      String      *artifacts);
+
 #endif // !EXP_CORE_COMPILE_H
@@ -22,8 +22,21 @@
 #ifndef EXP_CORE_EVALUATE_H
 #define EXP_CORE_EVALUATE_H
 
-#include "support/scalar.h"
+#include "env/context.h"
 
-i32 evaluate();
+/**
+ * @brief interpret the function main of the analyzed <context>,
+ * without generating any code.
+ *
+ * @note each frame is a register file holding every local of the
+ * function, indexed by SSA number, tuples take one register per
+ * scalar element. frames are taken from a contiguous stack. all
+ * scalars are computed as i64, then wrapped to the width, and
+ * signedness, of the local they are written to.
+ *
+ * @param result the value returned by main
+ * @return EXIT_FAILURE if evaluation fails, EXIT_SUCCESS otherwise
+ */
+i32 evaluate(Context *restrict context, i64 *restrict result);
 
 #endif // !EXP_CORE_EVALUATE_H
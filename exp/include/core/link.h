@@ -17,7 +17,15 @@
 #ifndef EXP_CORE_LINK_H
 #define EXP_CORE_LINK_H
 #include "env/context.h"
+#include "support/process.h"
 
 i32 link(Context *restrict context);
 
+/**
+ * @brief start linking with ld(1), without waiting for it to finish.
+ *
+ * @warning the builtin linker runs in process, it cannot be spawned.
+ */
+void link_spawn(Context *restrict context, Process *restrict ld);
+
 #endif // !EXP_CORE_LINK_H
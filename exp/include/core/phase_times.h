@@ -0,0 +1,88 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_CORE_PHASE_TIMES_H
+#define EXP_CORE_PHASE_TIMES_H
+
+#include <stdio.h>
+
+#include "support/string.h"
+#include "support/timer.h"
+
+/**
+ * @brief the phases of compiling a single translation unit.
+ *
+ * @note analyze covers both type and lifetime inference. codegen is
+ * the emission of the assembly, or of the object when it is encoded
+ * directly.
+ */
+typedef enum Phase : u8 {
+    PHASE_PARSE,
+    PHASE_ANALYZE,
+    PHASE_IR,
+    PHASE_CODEGEN,
+    PHASE_ASSEMBLE,
+    PHASE_LINK,
+    PHASE_COUNT,
+} Phase;
+
+typedef struct PhaseTime {
+    u64 nanoseconds;
+    i64 resident_bytes;
+} PhaseTime;
+
+/**
+ * @brief the wall clock time, and the change in resident set size,
+ * of each phase of a translation unit.
+ *
+ * @note the resident set size is that of the whole process, so when
+ * units are compiled in parallel the deltas of one unit include the
+ * allocations of the others. the assemble and link phases of a unit
+ * which spawns as(1) or ld(1) run from the spawn until the wait.
+ */
+typedef struct PhaseTimes {
+    PhaseTime phases[PHASE_COUNT];
+} PhaseTimes;
+
+void phase_times_create(PhaseTimes *restrict times);
+
+StringView phase_name(Phase phase);
+
+/**
+ * @brief add the time, and the memory, taken since <start> to <phase>
+ */
+void phase_times_record(PhaseTimes *restrict times,
+                        Phase       phase,
+                        TimerSample start);
+
+/**
+ * @brief the sum of all phases
+ */
+PhaseTime phase_times_total(PhaseTimes const *restrict times);
+
+/**
+ * @brief print one row per phase, and a total, as a table
+ */
+void phase_times_print(PhaseTimes const *restrict times, FILE *restrict file);
+
+/**
+ * @brief append the phases as a JSON object, mapping the name of
+ * each phase to its nanoseconds and resident_bytes.
+ */
+void phase_times_append_json(PhaseTimes const *restrict times,
+                             String *restrict json);
+
+#endif // !EXP_CORE_PHASE_TIMES_H
@@ -0,0 +1,46 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_CORE_RUN_H
+#define EXP_CORE_RUN_H
+#include "support/scalar.h"
+
+/**
+ * @brief compile the source file given on the command line into
+ * executable memory, and call its main function.
+ *
+ * @note no assembly, object, or executable is written, and neither
+ * as(1) nor ld(1) is run. the functions of the runtime library are
+ * bound to equivalents within the compiler.
+ *
+ * @return the value returned by main, or passed to _exp_sysexit,
+ * EXIT_FAILURE if the source could not be compiled
+ */
+i32 run(i32 argc, char const *argv[]);
+
+/**
+ * @brief analyze the source file given on the command line, and
+ * evaluate its main function with the bytecode interpreter.
+ *
+ * @note nothing is generated, so this is the quickest way to run
+ * a small program. calls to the runtime library are not supported.
+ *
+ * @return the value returned by main,
+ * EXIT_FAILURE if the source could not be analyzed or evaluated
+ */
+i32 interpret(i32 argc, char const *argv[]);
+
+#endif // !EXP_CORE_RUN_H
@@ -0,0 +1,51 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_CORE_SERVER_H
+#define EXP_CORE_SERVER_H
+#include "support/string.h"
+
+/**
+ * @brief the path of the socket the server listens on.
+ *
+ * @note this is $EXP_SERVER_SOCKET if it is set, otherwise
+ * a path in /tmp which is unique to the user.
+ */
+void server_socket_path(String *restrict path);
+
+/**
+ * @brief accept and compile requests from clients, until
+ * interrupted by SIGINT or SIGTERM.
+ *
+ * @note requests are compiled by a worker process per hardware
+ * thread. each worker adopts the working directory, stdout and stderr
+ * of one client at a time, and keeps the interners of its contexts
+ * between requests. a worker stopped by a request which fails fatally
+ * is replaced.
+ */
+i32 server();
+
+/**
+ * @brief forward the command line to the server, and return the
+ * result of compiling it.
+ *
+ * @note diagnostics are written by the server directly to our
+ * stdout and stderr. the path of each artifact created is then
+ * written to stdout, one per line.
+ */
+i32 client(i32 argc, char const *argv[]);
+
+#endif // !EXP_CORE_SERVER_H
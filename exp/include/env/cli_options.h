@@ -20,9 +20,18 @@
 #include "env/context_options.h"
 #include "support/string.h"
 
+/**
+ * @brief the source files given on the command line, in order.
+ */
+typedef struct CLISources {
+    u64     count;
+    u64     capacity;
+    String *buffer;
+} CLISources;
+
 typedef struct CLIOptions {
     ContextOptions context_options;
-    String         source;
+    CLISources     sources;
 } CLIOptions;
 
 void cli_options_init(CLIOptions *restrict cli_options);
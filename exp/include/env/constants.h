@@ -20,10 +20,33 @@
 
 #include "imr/value.h"
 
+/**
+ * @brief a slot of the hash index over the constants.
+ *
+ * @note entry is the index of the constant plus one, so that
+ * a zeroed slot is empty.
+ */
+typedef struct ConstantsSlot {
+    u64 hash;
+    u32 entry;
+} ConstantsSlot;
+
+/**
+ * @brief the constants of a translation unit, each of which
+ * is stored once.
+ *
+ * @note the dense buffer is what Operands index into, the table
+ * only serves to find an existing constant equal to a new one.
+ * hits and misses count the outcomes of those searches.
+ */
 typedef struct Constants {
-    u32 count;
-    u32 capacity;
-    Value *buffer;
+    u32            count;
+    u32            capacity;
+    Value         *buffer;
+    u64            table_capacity;
+    ConstantsSlot *table;
+    u64            hits;
+    u64            misses;
 } Constants;
 
 /**
@@ -43,6 +66,9 @@ void constants_destroy(Constants *restrict values);
 /**
  * @brief add a new Value to the Values buffer
  *
+ * @note if an equal Value is already present, <value> is
+ * destroyed and the existing constant is returned.
+ *
  * @param values
  * @param value
  * @return Value*
@@ -20,17 +20,24 @@
 #include "env/constants.h"
 #include "env/context_options.h"
 #include "env/error.h"
+#include "env/labels.h"
 #include "env/string_interner.h"
 #include "env/symbol_table.h"
 #include "env/type_interner.h"
+#include "support/arena.h"
+#include "support/io.h"
 
 /**
  * @brief A context models a Translation Unit.
  *
+ * @note <arena> holds the objects which live as long as the
+ * translation unit, such as the Locals of every function, they
+ * are all released when the context is destroyed.
  */
 typedef struct Context {
     ContextOptions options;
     String         source_path;
+    MappedFile     source;
     String         ir_path;
     String         assembly_path;
     String         object_path;
@@ -39,9 +46,13 @@ typedef struct Context {
     StringInterner string_interner;
     TypeInterner   type_interner;
     SymbolTable    global_symbol_table;
+    Labels         global_labels;
     Constants      constants;
     Error          current_error;
     Function      *current_function;
+    Arena          arena;
+
+    struct FunctionCache const *function_cache;
 } Context;
 
 /**
@@ -66,6 +77,12 @@ bool context_shall_create_executable_artifact(Context const *restrict context);
 bool context_shall_cleanup_ir_artifact(Context const *restrict context);
 bool context_shall_cleanup_assembly_artifact(Context const *restrict context);
 bool context_shall_cleanup_object_artifact(Context const *restrict context);
+bool context_shall_encode_object_artifact(Context const *restrict context);
+bool context_shall_builtin_link_artifact(Context const *restrict context);
+bool context_shall_stream_assembly_artifact(Context const *restrict context);
+bool context_shall_stream_object_artifact(Context const *restrict context);
+bool context_shall_cache_artifacts(Context const *restrict context);
+bool context_shall_report_phase_times(Context const *restrict context);
 
 void context_create_ir_artifact(Context *restrict context);
 void context_create_assembly_artifact(Context *restrict context);
@@ -76,9 +93,17 @@ void context_cleanup_assembly_artifact(Context *restrict context);
 void context_cleanup_object_artifact(Context *restrict context);
 
 StringView context_source_path(Context const *restrict context);
+/**
+ * @brief the contents of the source file, mapped into memory on
+ * first use, and unmapped when the context is destroyed.
+ *
+ * @note the contents are followed by a zero byte.
+ */
+StringView context_source(Context *restrict context);
 StringView context_ir_path(Context const *restrict context);
 StringView context_assembly_path(Context const *restrict context);
 StringView context_object_path(Context const *restrict context);
+void context_assign_object_path(Context *restrict context, StringView path);
 StringView context_executable_path(Context const *restrict context);
 
 // current error functions
@@ -105,8 +130,8 @@ Type const *context_function_type(Context *restrict context,
                                   TupleType   argument_types);
 
 // labels functions
-// u32        context_labels_insert(Context *restrict context, StringView
-// symbol); StringView context_labels_at(Context *restrict context, u32 index);
+u32 context_labels_insert(Context *restrict context, ConstantString *label);
+ConstantString *context_labels_at(Context *restrict context, u32 index);
 
 // symbol table functions
 Symbol *context_global_symbol_table_at(Context *restrict context,
@@ -124,7 +149,13 @@ Local *context_declare_argument(Context *restrict context);
 Local *context_declare_local(Context *restrict context);
 Local *context_lookup_argument(Context *restrict context, u8 index);
 Local *context_lookup_local(Context *restrict context, u32 ssa);
-Local *context_lookup_local_name(Context *restrict context, StringView name);
+Local *context_lookup_local_name(Context *restrict context,
+                                 ConstantString const *name);
+void   context_enter_scope(Context *restrict context);
+void   context_leave_scope(Context *restrict context);
+void   context_bind_local(Context *restrict context,
+                          Local *restrict local,
+                          ConstantString const *name);
 
 void context_leave_function(Context *restrict context);
 
@@ -132,6 +163,13 @@ void context_leave_function(Context *restrict context);
 Operand context_constants_append(Context *restrict context, Value value);
 Value  *context_constants_at(Context *restrict context, u32 index);
 
+/**
+ * @brief an immediate Operand holding <value>, or, when <value> does
+ * not fit within 32 bits, a constant Operand holding it instead.
+ */
+Operand context_immediate_i64(Context *restrict context, i64 value);
+Operand context_immediate_u64(Context *restrict context, u64 value);
+
 // Bytecode functions
 void    context_emit_return(Context *restrict context, Operand B);
 Operand context_emit_call(Context *restrict context, Operand B, Operand C);
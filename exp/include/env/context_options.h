@@ -33,6 +33,12 @@ typedef struct ContextOptions {
     bool cleanup_ir_artifact        : 1;
     bool cleanup_assembly_artifact  : 1;
     bool cleanup_object_artifact    : 1;
+    bool encode_object_artifact     : 1;
+    bool builtin_link_artifact      : 1;
+    bool stream_artifacts           : 1;
+    bool cache_artifacts            : 1;
+    bool report_phase_times         : 1;
+    bool report_phase_times_json    : 1;
 } ContextOptions;
 
 #endif // !EXP_ENV_CONTEXT_OPTIONS_H
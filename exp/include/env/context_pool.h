@@ -0,0 +1,62 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_ENV_CONTEXT_POOL_H
+#define EXP_ENV_CONTEXT_POOL_H
+
+#include "env/context.h"
+
+/**
+ * @brief the interners of a context which has been released
+ * back to the pool.
+ */
+typedef struct ContextPoolEntry {
+    StringInterner string_interner;
+    TypeInterner   type_interner;
+} ContextPoolEntry;
+
+/**
+ * @brief retains the interners of finished contexts, so that a long
+ * running process does not reallocate their tables for every context.
+ *
+ * @note the pool is not synchronized, contexts must be acquired and
+ * released from a single thread.
+ */
+typedef struct ContextPool {
+    u64               count;
+    u64               capacity;
+    ContextPoolEntry *buffer;
+} ContextPool;
+
+void context_pool_create(ContextPool *restrict pool);
+void context_pool_destroy(ContextPool *restrict pool);
+
+/**
+ * @brief give a newly created context warm interners from the pool,
+ * if the pool has any.
+ */
+void context_pool_acquire(ContextPool *restrict pool,
+                          Context *restrict context);
+
+/**
+ * @brief clear the interners of the context and return them to the pool.
+ *
+ * @note the context must still be destroyed.
+ */
+void context_pool_release(ContextPool *restrict pool,
+                          Context *restrict context);
+
+#endif // !EXP_ENV_CONTEXT_POOL_H
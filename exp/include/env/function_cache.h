@@ -0,0 +1,58 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_ENV_FUNCTION_CACHE_H
+#define EXP_ENV_FUNCTION_CACHE_H
+
+#include "env/context.h"
+
+/**
+ * @brief the analyzed IMR of individual functions, kept in the build
+ * cache directory, so that a function whose source and dependencies
+ * are unchanged need not be parsed or analyzed again.
+ *
+ * @note each entry is named by the cache key of its symbol, mixed with
+ * <seed>. entries are written by way of a temporary file, so the cache
+ * may be shared by contexts compiling on different threads.
+ */
+typedef struct FunctionCache {
+    String directory;
+    u64    seed;
+} FunctionCache;
+
+void function_cache_create(FunctionCache *restrict cache,
+                           StringView directory,
+                           u64        seed);
+void function_cache_destroy(FunctionCache *restrict cache);
+
+/**
+ * @brief define <symbol> from the entry named by its cache key
+ *
+ * @return true on a cache hit, in which case the symbol is a typed
+ * function, false otherwise, in which case the symbol is unchanged.
+ */
+bool function_cache_retrieve(FunctionCache const *restrict cache,
+                             Context *restrict context,
+                             Symbol *restrict symbol);
+
+/**
+ * @brief store every analyzed function of <context> which may be cached
+ * and was not itself taken from the cache.
+ */
+void function_cache_store(FunctionCache const *restrict cache,
+                          Context *restrict context);
+
+#endif // !EXP_ENV_FUNCTION_CACHE_H
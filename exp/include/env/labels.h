@@ -14,20 +14,27 @@
 //
 // You should have received a copy of the GNU General Public License
 // along with exp.  If not, see <https://www.gnu.org/licenses/>.
-#ifndef EXP_ENV_GLOBAL_SYMBOLS_H
-#define EXP_ENV_GLOBAL_SYMBOLS_H
-#include "support/string_view.h"
+#ifndef EXP_ENV_LABELS_H
+#define EXP_ENV_LABELS_H
+#include "support/constant_string.h"
 
-typedef struct GlobalLabels {
-    u32 count;
-    u32 capacity;
-    StringView *buffer;
+/**
+ * @brief the global names referenced by the bytecode.
+ *
+ * @note a label Operand holds an index into this table, which
+ * keeps the Operand within 32 bits. The names are interned,
+ * so each name is held once and is compared by pointer.
+ */
+typedef struct Labels {
+    u32              count;
+    u32              capacity;
+    ConstantString **buffer;
 } Labels;
 
 Labels labels_create();
-void labels_destroy(Labels *restrict symbols);
+void   labels_destroy(Labels *restrict labels);
 
-u32 labels_insert(Labels *restrict symbols, StringView symbol);
-StringView labels_at(Labels *restrict symbols, u32 index);
+u32             labels_insert(Labels *restrict labels, ConstantString *label);
+ConstantString *labels_at(Labels const *restrict labels, u32 index);
 
-#endif // !EXP_ENV_GLOBAL_SYMBOLS_H
+#endif // !EXP_ENV_LABELS_H
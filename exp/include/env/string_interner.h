@@ -17,6 +17,7 @@
 #ifndef EXP_ENV_STRING_INTERNER_H
 #define EXP_ENV_STRING_INTERNER_H
 
+#include "support/arena.h"
 #include "support/constant_string.h"
 
 /**
@@ -36,17 +37,33 @@
  * thus invalidating the string view returned by the string interner
  * as it is a pointer into the old buffer. Causing chaos somewhere down the
  * line.
+ *
+ * @note the strings are bump allocated from an Arena, so they are
+ * freed all at once. each slot of the table holds the hash of its
+ * string, so that probing and growth compare hashes before bytes and
+ * never rehash a string. the capacity is always a power of two.
  */
+typedef struct StringInternerSlot {
+    u64             hash;
+    ConstantString *string;
+} StringInternerSlot;
+
 typedef struct StringInterner {
-    u64              capacity;
-    u64              count;
-    ConstantString **buffer;
+    u64                 capacity;
+    u64                 count;
+    StringInternerSlot *buffer;
+    Arena               arena;
 } StringInterner;
 
 StringInterner string_interner_create();
 
 void string_interner_destroy(StringInterner *restrict string_interner);
 
+/**
+ * @brief remove every string, keeping the table allocated for reuse.
+ */
+void string_interner_clear(StringInterner *restrict string_interner);
+
 ConstantString *string_interner_insert(StringInterner *restrict string_interner,
                                        StringView sv);
 
@@ -26,19 +26,44 @@ typedef enum SymbolKind {
     SYMBOL_KIND_FUNCTION,
 } SymbolKind;
 
+/**
+ * @note <source_offset> and <source_length> give the span of the
+ * definition within the source, and <source_hash> is a hash of that
+ * text. <cache_key> also covers the definitions this one depends on,
+ * and names the function within the function cache, zero if it may
+ * not be cached. <cached> is set when the function was taken from the
+ * cache rather than parsed.
+ */
 typedef struct Symbol {
     StringView  name;
     Type const *type;
     SymbolKind  kind;
+    u32         source_offset;
+    u32         source_length;
+    u64         source_hash;
+    u64         cache_key;
+    bool        cached;
     union {
         u8       empty;
         Function function_body;
     };
 } Symbol;
 
+/**
+ * @brief an open addressed table of the global symbols, using
+ * Robin Hood insertion.
+ *
+ * @note tags[i] holds 32 bits of the hash of elements[i]->name,
+ * and is zero when the slot is empty. the low bits of a tag select
+ * the home slot of the symbol, so probe distances are recovered
+ * from the tags alone, and the table grows without rehashing any
+ * names. elements[i] is nullptr when the slot is empty, so the
+ * table may be walked by the elements alone.
+ */
 typedef struct SymbolTable {
     u64      count;
     u64      capacity;
+    u32     *tags;
     Symbol **elements;
 } SymbolTable;
 
@@ -47,4 +72,17 @@ void        symbol_table_destroy(SymbolTable *restrict symbol_table);
 
 Symbol *symbol_table_at(SymbolTable *restrict symbol_table, StringView name);
 
+/**
+ * @brief the symbols of the table, ordered by name.
+ *
+ * @note walking the elements directly visits the symbols in hash
+ * order, which depends on the capacity of the table. anything which
+ * is written out must use this order instead, so that the same source
+ * always produces the same artifacts.
+ *
+ * @return an array of symbol_table->count symbols, the caller
+ * must deallocate the array.
+ */
+Symbol **symbol_table_sorted(SymbolTable const *restrict symbol_table);
+
 #endif // !EXP_ENV_SYMBOL_TABLE_H
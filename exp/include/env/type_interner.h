@@ -19,10 +19,11 @@
 #include <stddef.h>
 
 #include "imr/type.h"
+#include "support/arena.h"
 
 /**
  * @brief Type TypeList is a simple dynamic array of pointers
- * to dynamically allocated types.
+ * to the types allocated from the TypeInterner's arena.
  *
  * used for types that all follow the same pattern,
  * but each individual type has a fixed form.
@@ -40,27 +41,50 @@ typedef struct TypeList {
     Type **buffer;
 } TypeList;
 
+typedef struct TypeInternerSlot {
+    u64         hash;
+    Type const *type;
+} TypeInternerSlot;
+
+/**
+ * @brief an open addressed hash set of the tuple and function
+ * types held by a TypeInterner.
+ *
+ * @note types are hashed and compared by the pointers to their
+ * element types, which are themselves canonical. so structurally
+ * equal types are found without recursing into their elements.
+ */
+typedef struct TypeTable {
+    u64               capacity;
+    u64               count;
+    TypeInternerSlot *buffer;
+} TypeTable;
+
 /**
  * @brief The TypeInterner holds unique instances of
  * every type used.
  *
  * @note Types retrieved from the same TypeInterner
  * can be equality compared using their pointer values.
+ * tuple and function types are hash-consed, requesting a type
+ * structurally equal to an existing one returns the existing one.
  *
  */
 typedef struct TypeInterner {
-    Type     nil_type;
-    Type     boolean_type;
-    Type     u8_type;
-    Type     u16_type;
-    Type     u32_type;
-    Type     u64_type;
-    Type     i8_type;
-    Type     i16_type;
-    Type     i32_type;
-    Type     i64_type;
-    TypeList tuple_types;
-    TypeList function_types;
+    Type      nil_type;
+    Type      boolean_type;
+    Type      u8_type;
+    Type      u16_type;
+    Type      u32_type;
+    Type      u64_type;
+    Type      i8_type;
+    Type      i16_type;
+    Type      i32_type;
+    Type      i64_type;
+    TypeList  tuple_types;
+    TypeList  function_types;
+    TypeTable table;
+    Arena     arena;
 } TypeInterner;
 
 /**
@@ -77,6 +101,14 @@ TypeInterner type_interner_create();
  */
 void type_interner_destroy(TypeInterner *restrict type_interner);
 
+/**
+ * @brief remove every tuple and function type, keeping the
+ * lists, table and arena allocated for reuse.
+ *
+ * @param type_interner
+ */
+void type_interner_clear(TypeInterner *restrict type_interner);
+
 Type const *type_interner_nil_type(TypeInterner *restrict type_interner);
 Type const *type_interner_boolean_type(TypeInterner *restrict type_interner);
 Type const *type_interner_u8_type(TypeInterner *restrict type_interner);
@@ -87,9 +119,22 @@ Type const *type_interner_i8_type(TypeInterner *restrict type_interner);
 Type const *type_interner_i16_type(TypeInterner *restrict type_interner);
 Type const *type_interner_i32_type(TypeInterner *restrict type_interner);
 Type const *type_interner_i64_type(TypeInterner *restrict type_interner);
+/**
+ * @brief return the unique tuple type with the given elements
+ *
+ * @note the interner takes ownership of <tuple>, and destroys
+ * it if an equal tuple type already exists.
+ */
 Type const *type_interner_tuple_type(TypeInterner *restrict type_interer,
                                      TupleType tuple);
 
+/**
+ * @brief return the unique function type with the given return
+ * and argument types
+ *
+ * @note the interner takes ownership of <argument_types>, and
+ * destroys it if an equal function type already exists.
+ */
 Type const *type_interner_function_type(TypeInterner *restrict type_interner,
                                         Type const *return_type,
                                         TupleType   argument_types);
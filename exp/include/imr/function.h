@@ -45,11 +45,20 @@ typedef struct Function {
 void function_create(Function *restrict function);
 void function_destroy(Function *restrict function);
 
-Local *function_declare_argument(Function *restrict function);
-Local *function_declare_local(Function *restrict function);
+Local *function_declare_argument(Function *restrict function,
+                                 Arena *restrict arena);
+Local *function_declare_local(Function *restrict function,
+                              Arena *restrict arena);
 Local *function_lookup_argument(Function *restrict function, u8 index);
 Local *function_lookup_local(Function *restrict function, u32 ssa);
-Local *function_lookup_local_name(Function *restrict function, StringView name);
+Local *function_lookup_local_name(Function *restrict function,
+                                  ConstantString const *name);
+
+void function_enter_scope(Function *restrict function);
+void function_leave_scope(Function *restrict function);
+void function_bind_local(Function *restrict function,
+                         Local *restrict local,
+                         ConstantString const *name);
 
 struct Context;
 void print_function(String *restrict string,
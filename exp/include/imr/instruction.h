@@ -34,6 +34,10 @@ typedef enum Opcode : u8 {
     OPCODE_MOD,
 } Opcode;
 
+/**
+ * @brief an Instruction is 16 bytes, the kinds are packed beside
+ * the opcode, and each operand is a 32 bit payload.
+ */
 typedef struct Instruction {
     Opcode      opcode;
     OperandKind A_kind;
@@ -44,6 +48,8 @@ typedef struct Instruction {
     OperandData C_data;
 } Instruction;
 
+static_assert(sizeof(Instruction) == 16, "an Instruction must be 16 bytes");
+
 Instruction instruction_return(Operand result);
 Instruction instruction_call(Operand dst, Operand label, Operand args);
 Instruction instruction_let(Operand dst, Operand src);
@@ -19,17 +19,82 @@
 #define EXP_IMR_LOCALS_H
 
 #include "imr/local.h"
+#include "support/arena.h"
+#include "support/constant_string.h"
+
+/**
+ * @brief the binding of a name to a local, <shadowed> is the index of
+ * the binding of the same name it hides, or u32_MAX.
+ */
+typedef struct LocalBinding {
+    ConstantString const *name;
+    Local                *local;
+    u32                   shadowed;
+} LocalBinding;
+
+/**
+ * @brief a slot of the index, holding the innermost binding of <name>,
+ * or u32_MAX once every binding of the name has gone out of scope.
+ */
+typedef struct LocalNameSlot {
+    ConstantString const *name;
+    u32                   binding;
+} LocalNameSlot;
+
+/**
+ * @brief an open addressing index from names to the locals bound to
+ * them.
+ *
+ * @note names are interned, so they are hashed and compared by address.
+ * bindings form a stack, <scopes> holds the height of the stack as each
+ * enclosing scope was entered, so that leaving a scope can restore
+ * whatever its bindings shadowed. the capacity of the slots is a power
+ * of two.
+ */
+typedef struct LocalNames {
+    u32            slot_count;
+    u32            slot_capacity;
+    LocalNameSlot *slots;
+    u32            binding_count;
+    u32            binding_capacity;
+    LocalBinding  *bindings;
+    u32            scope_count;
+    u32            scope_capacity;
+    u32           *scopes;
+} LocalNames;
 
 typedef struct Locals {
-    u32     count;
-    u32     capacity;
-    Local **buffer;
+    u32        count;
+    u32        capacity;
+    Local    **buffer;
+    LocalNames names;
 } Locals;
 
 void   locals_create(Locals *restrict locals);
 void   locals_destroy(Locals *restrict locals);
-Local *locals_declare(Locals *restrict locals);
+/**
+ * @brief declare a new local, allocated from <arena>.
+ *
+ * @note the locals only hold pointers to each Local, which
+ * are freed all at once with the arena.
+ */
+Local *locals_declare(Locals *restrict locals, Arena *restrict arena);
 Local *locals_lookup(Locals *restrict locals, u32 ssa);
-Local *locals_lookup_name(Locals *restrict locals, StringView name);
+
+void locals_enter_scope(Locals *restrict locals);
+void locals_leave_scope(Locals *restrict locals);
+
+/**
+ * @brief name <local>, the name shadows any other local of the same
+ * name until the current scope is left.
+ */
+void locals_bind_name(Locals *restrict locals,
+                      Local *restrict local,
+                      ConstantString const *name);
+
+/**
+ * @return the innermost local bound to <name>, or NULL
+ */
+Local *locals_lookup_name(Locals *restrict locals, ConstantString const *name);
 
 #endif // !EXP_IMR_LOCALS_H
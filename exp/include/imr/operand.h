@@ -17,7 +17,6 @@
 #ifndef EXP_IMR_OPERAND_H
 #define EXP_IMR_OPERAND_H
 
-#include "support/constant_string.h"
 #include "support/scalar.h"
 #include "support/string.h"
 
@@ -35,18 +34,24 @@ typedef enum OperandKind : u8 {
     OPERAND_KIND_I64,
 } OperandKind;
 
+/**
+ * @brief the payload of an Operand, which is kept within 32 bits.
+ *
+ * @note <label> is an index into the global labels of the Context.
+ * a u64 immediate is held in <u32_>, and an i64 immediate in <i32_>,
+ * zero and sign extended respectively. wider values are held in
+ * the constants of the Context, see context_immediate.
+ */
 typedef union OperandData {
-    u32             ssa;
-    u32             constant;
-    ConstantString *label;
-    u8              u8_;
-    u16             u16_;
-    u32             u32_;
-    u64             u64_;
-    i8              i8_;
-    i16             i16_;
-    i32             i32_;
-    i64             i64_;
+    u32 ssa;
+    u32 constant;
+    u32 label;
+    u8  u8_;
+    u16 u16_;
+    u32 u32_;
+    i8  i8_;
+    i16 i16_;
+    i32 i32_;
 } OperandData;
 
 typedef struct Operand {
@@ -59,7 +64,7 @@ struct Context;
 Operand operand(OperandKind kind, OperandData data);
 Operand operand_ssa(u32 ssa);
 Operand operand_constant(u32 index);
-Operand operand_label(ConstantString *cs);
+Operand operand_label(u32 index);
 Operand operand_u8(u8 u8_);
 Operand operand_u16(u16 u16_);
 Operand operand_u32(u32 u32_);
@@ -70,6 +75,12 @@ Operand operand_i32(i32 i32_);
 Operand operand_i64(i64 i64_);
 
 bool operand_equality(Operand A, Operand B);
+
+/**
+ * @brief fold the operand into <hash>, such that operands which
+ * compare equal by operand_equality hash equally.
+ */
+u64  operand_hash(u64 hash, Operand A);
 bool operand_is_index(Operand A);
 u64  operand_as_index(Operand A);
 
@@ -55,6 +55,19 @@ typedef struct FunctionType {
 
 bool function_type_equality(FunctionType const *A, FunctionType const *B);
 
+/**
+ * @brief the size and alignment in bytes of a Type, and for a
+ * tuple the offset of each element.
+ *
+ * @note layouts are computed once, when the TypeInterner creates
+ * the type. <offsets> is nullptr for every type but a tuple.
+ */
+typedef struct TypeLayout {
+    u64        size;
+    u64        alignment;
+    u64 const *offsets;
+} TypeLayout;
+
 /**
  * @brief represents Types in the compiler
  *
@@ -66,7 +79,8 @@ bool function_type_equality(FunctionType const *A, FunctionType const *B);
  * create the type.
  */
 typedef struct Type {
-    TypeKind kind;
+    TypeKind   kind;
+    TypeLayout layout;
     union {
         u8           scalar_type;
         TupleType    tuple_type;
@@ -88,6 +102,9 @@ Type type_create_tuple(TupleType tuple_type);
 Type type_create_function(Type const *result, TupleType args);
 void type_destroy(Type *type);
 
+/**
+ * @note both types must come from the same TypeInterner.
+ */
 bool type_equality(Type const *t1, Type const *t2);
 bool type_is_scalar(Type const *t);
 bool type_is_index(Type const *t);
@@ -167,6 +167,15 @@ Value value_create_tuple(Tuple tuple);
  */
 bool value_equality(Value *v1, Value *v2);
 
+/**
+ * @brief hash the value, such that values which compare
+ * equal by value_equality hash equally.
+ *
+ * @param v
+ * @return u64
+ */
+u64 value_hash(Value const *v);
+
 bool value_is_index(Value const *v);
 u64  value_as_index(Value const *v);
 
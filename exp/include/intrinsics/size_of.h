@@ -24,10 +24,21 @@
  * @brief returns the size in bytes of the given type.
  *
  * @note this is the number of bytes to store a <value> with <type>.
+ * it is read from the layout computed when the type was interned.
  *
  * @param type
  * @return u64
  */
 u64 size_of(Type const *restrict type);
 
+/**
+ * @brief returns the offset in bytes of element <index> of the
+ * tuple <type>.
+ *
+ * @param type
+ * @param index
+ * @return u64
+ */
+u64 offset_of(Type const *restrict type, u64 index);
+
 #endif // !EXP_INTRINSICS_SIZEOF_H
@@ -0,0 +1,66 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_SCANNING_DEFINITIONS_H
+#define EXP_SCANNING_DEFINITIONS_H
+
+#include "scanning/tokens.h"
+
+/**
+ * @brief a top level definition, found by scanning ahead of the parser.
+ *
+ * @note <first> is the index of the "fn" token and <last> is the index
+ * of the closing brace. <source_hash> covers the text of the definition
+ * alone, while <key> also covers the key of every definition which is
+ * named within it, so that the key changes when anything the
+ * definition depends upon changes. definitions which take part in a
+ * cycle, or depend on one that does, have a key of zero.
+ */
+typedef struct Definition {
+    StringView name;
+    u32        first;
+    u32        last;
+    u64        source_hash;
+    u64        key;
+} Definition;
+
+typedef struct Definitions {
+    u32          count;
+    u32          capacity;
+    Definition  *buffer;
+    Definition **by_name;
+} Definitions;
+
+void definitions_create(Definitions *restrict definitions);
+void definitions_destroy(Definitions *restrict definitions);
+
+/**
+ * @brief find every well formed top level definition within <tokens>,
+ * in the order they appear, and compute their keys.
+ *
+ * @note scanning stops at the first definition which is not well
+ * formed, the parser reports the error.
+ */
+void definitions_scan(Definitions *restrict definitions,
+                      Tokens const *restrict tokens);
+
+/**
+ * @return the definition named <name>, or nullptr
+ */
+Definition *definitions_lookup(Definitions const *restrict definitions,
+                               StringView name);
+
+#endif // !EXP_SCANNING_DEFINITIONS_H
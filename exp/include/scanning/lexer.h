@@ -26,8 +26,6 @@ typedef struct Lexer {
     const char *buffer;
     const char *token;
     const char *cursor;
-    u64         line;
-    u64         column;
     u64         length;
 } Lexer;
 
@@ -48,7 +46,8 @@ void lexer_reset(Lexer *restrict lexer);
 /**
  * @brief set the buffer the lexer scans
  *
- * @note the lexer expects the buffer to be null terminated
+ * @note the lexer reads nothing past the first <length> bytes
+ * of <buffer>, so the buffer need not be padded or terminated.
  *
  * @param lexer
  * @param buffer
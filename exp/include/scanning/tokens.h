@@ -0,0 +1,75 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_SCANNING_TOKENS_H
+#define EXP_SCANNING_TOKENS_H
+
+#include "scanning/token.h"
+#include "support/string_view.h"
+
+/**
+ * @brief the tokens of a buffer, stored as parallel arrays.
+ *
+ * @note the text of token i is the <lengths[i]> bytes of the buffer
+ * starting at <offsets[i]>. the line of a token is computed on
+ * demand, as it is only needed for diagnostics. the last token
+ * is always TOK_END.
+ */
+typedef struct Tokens {
+    char const *buffer;
+    u32         count;
+    u32         capacity;
+    u8         *kinds;
+    u32        *offsets;
+    u32        *lengths;
+} Tokens;
+
+void tokens_create(Tokens *restrict tokens);
+void tokens_destroy(Tokens *restrict tokens);
+
+void tokens_append(Tokens *restrict tokens,
+                   Token kind,
+                   u32   offset,
+                   u32   length);
+
+/**
+ * @brief scan all of <buffer> into <tokens>
+ *
+ * @note the buffer must be null terminated, no longer than
+ * UINT32_MAX bytes, and must outlive the tokens. large buffers
+ * are scanned in chunks, concurrently.
+ */
+void tokens_scan(Tokens *restrict tokens, char const *buffer, u64 length);
+
+/**
+ * @brief as tokens_scan, splitting the buffer into <chunk_count>
+ * chunks at newlines, each scanned on its own thread.
+ *
+ * @note the result is identical to scanning the buffer whole.
+ */
+void tokens_scan_chunked(Tokens *restrict tokens,
+                         char const *buffer,
+                         u64         length,
+                         u64         chunk_count);
+
+/**
+ * @note indices past the end refer to the final TOK_END
+ */
+Token      tokens_kind(Tokens const *restrict tokens, u32 index);
+StringView tokens_text(Tokens const *restrict tokens, u32 index);
+u64        tokens_line(Tokens const *restrict tokens, u32 index);
+
+#endif // !EXP_SCANNING_TOKENS_H
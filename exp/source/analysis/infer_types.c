@@ -167,7 +167,8 @@ static bool infer_types_operand(Type const **result,
     }
 
     case OPERAND_KIND_LABEL: {
-        StringView  name   = constant_string_to_view(data.label);
+        StringView  name   = constant_string_to_view(
+            context_labels_at(context, data.label));
         Symbol     *global = context_global_symbol_table_at(context, name);
         Type const *type   = global->type;
         if (type == NULL) {
@@ -454,13 +455,15 @@ static bool infer_types_global(Type const **result,
         // the function body. This only breaks when we have mutual recursion,
         // otherwise, when the global is successfully typed.
         // the question is, how do we accomplish this?
-        Function   *body = context_enter_function(c, element->name);
+        // the callee may be typed while in the midst of typing its caller,
+        // so the caller must be restored afterwards.
+        Function   *caller = c->current_function;
+        Function   *body   = context_enter_function(c, element->name);
         Type const *Rty;
-        if (!infer_types_function(&Rty, c)) {
-            context_leave_function(c);
-            return false;
-        }
+        bool        typed = infer_types_function(&Rty, c);
         context_leave_function(c);
+        c->current_function = caller;
+        if (!typed) { return false; }
 
         if ((body->return_type != NULL) &&
             (!type_equality(Rty, body->return_type))) {
@@ -0,0 +1,215 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <elf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "codegen/ELF/jit.h"
+#include "support/allocation.h"
+#include "support/message.h"
+#include "support/numeric_conversions.h"
+#include "support/panic.h"
+
+/*
+ * jmp *0(%rip), followed by the absolute address to jump to,
+ * padded to 16 bytes.
+ */
+#define ELF_JIT_STUB_SIZE 16
+
+static void elf_jit_error(StringView problem, StringView detail) {
+    String buffer = string_create();
+    string_append(&buffer, SV("jit: "));
+    string_append(&buffer, problem);
+    string_append(&buffer, detail);
+    message(MESSAGE_ERROR, NULL, 0, string_to_view(&buffer), stderr);
+    string_destroy(&buffer);
+}
+
+static u64 elf_jit_stubs_offset(ELF_Object const *restrict object) {
+    return (object->text.length + ELF_JIT_STUB_SIZE - 1) &
+           ~(u64)(ELF_JIT_STUB_SIZE - 1);
+}
+
+static bool elf_jit_binding(u64                   binding_count,
+                            ELF_JitBinding const *bindings,
+                            StringView            name,
+                            u64 *restrict address) {
+    for (u64 index = 0; index < binding_count; ++index) {
+        if (string_view_equal(bindings[index].name, name)) {
+            *address = bindings[index].address;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void elf_jit_write_stub(u8 *restrict stub, u64 address) {
+    static u8 const jmp[] = {0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+    memset(stub, 0xCC, ELF_JIT_STUB_SIZE);
+    memcpy(stub, jmp, sizeof(jmp));
+    memcpy(stub + sizeof(jmp), &address, sizeof(address));
+}
+
+/*
+ * defined symbols are found within .text, undefined symbols
+ * are given the next stub.
+ */
+static bool elf_jit_resolve(ELF_Jit *restrict jit,
+                            ELF_Object const *restrict object,
+                            u64                   binding_count,
+                            ELF_JitBinding const *bindings) {
+    bool success = true;
+    u64  stub    = elf_jit_stubs_offset(object);
+    for (u64 index = 0; index < object->symbols.count; ++index) {
+        ELF_Symbol const *symbol = object->symbols.buffer + index;
+        if (symbol->defined) {
+            jit->symbol_addresses[index] =
+                (u64)(uintptr_t)(jit->memory + symbol->offset);
+            continue;
+        }
+
+        u64 address = 0;
+        if (!elf_jit_binding(binding_count, bindings, symbol->name, &address)) {
+            elf_jit_error(SV("undefined symbol "), symbol->name);
+            success = false;
+            continue;
+        }
+
+        elf_jit_write_stub(jit->memory + stub, address);
+        jit->symbol_addresses[index] = (u64)(uintptr_t)(jit->memory + stub);
+        stub += ELF_JIT_STUB_SIZE;
+    }
+    return success;
+}
+
+static bool elf_jit_relocate(ELF_Jit *restrict jit,
+                             ELF_Object const *restrict object) {
+    bool success = true;
+    for (u64 index = 0; index < object->relocations.count; ++index) {
+        ELF_Relocation const *relocation = object->relocations.buffer + index;
+        u64 width = (relocation->type == R_X86_64_64) ? 8 : 4;
+        if ((relocation->symbol >= object->symbols.count) ||
+            (relocation->offset > object->text.length) ||
+            (width > (object->text.length - relocation->offset))) {
+            elf_jit_error(SV("malformed relocation"), SV(""));
+            success = false;
+            continue;
+        }
+
+        u8 *location = jit->memory + relocation->offset;
+        u64 S        = jit->symbol_addresses[relocation->symbol];
+        i64 A        = relocation->addend;
+        u64 P        = (u64)(uintptr_t)location;
+        i64 value    = 0;
+        switch (relocation->type) {
+        case R_X86_64_64:    value = (i64)S + A; break;
+        case R_X86_64_PC32:
+        case R_X86_64_PLT32: value = (i64)S + A - (i64)P; break;
+        default: {
+            elf_jit_error(SV("unsupported relocation type"), SV(""));
+            success = false;
+            continue;
+        }
+        }
+
+        if (width == 8) {
+            u64 bits = (u64)value;
+            memcpy(location, &bits, sizeof(bits));
+            continue;
+        }
+
+        if (!i64_in_range_i32(value)) {
+            elf_jit_error(SV("relocation overflow"), SV(""));
+            success = false;
+            continue;
+        }
+
+        u32 bits = (u32)value;
+        memcpy(location, &bits, sizeof(bits));
+    }
+    return success;
+}
+
+i32 elf_jit_load(ELF_Jit *restrict jit,
+                 ELF_Object const *restrict object,
+                 u64                   binding_count,
+                 ELF_JitBinding const *bindings) {
+    assert(jit != nullptr);
+    assert(object != nullptr);
+
+    u64 undefined = 0;
+    for (u64 index = 0; index < object->symbols.count; ++index) {
+        if (!object->symbols.buffer[index].defined) { ++undefined; }
+    }
+
+    jit->size = elf_jit_stubs_offset(object) + (undefined * ELF_JIT_STUB_SIZE);
+    if (jit->size == 0) { jit->size = ELF_JIT_STUB_SIZE; }
+    void *memory = mmap(nullptr,
+                        jit->size,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1,
+                        0);
+    if (memory == MAP_FAILED) { PANIC_ERRNO("mmap failed"); }
+    jit->memory = memory;
+    StringView text = string_to_view(&object->text);
+    memcpy(jit->memory, text.ptr, text.length);
+
+    jit->symbol_count     = object->symbols.count;
+    jit->symbol_addresses = callocate(jit->symbol_count + 1, sizeof(u64));
+
+    bool success = elf_jit_resolve(jit, object, binding_count, bindings);
+    if (success) { success = elf_jit_relocate(jit, object); }
+
+    // the memory is never writable and executable at once.
+    if (mprotect(jit->memory, jit->size, PROT_READ | PROT_EXEC) == -1) {
+        PANIC_ERRNO("mprotect failed");
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void elf_jit_unload(ELF_Jit *restrict jit) {
+    assert(jit != nullptr);
+    if (munmap(jit->memory, jit->size) == -1) { PANIC_ERRNO("munmap failed"); }
+    deallocate(jit->symbol_addresses);
+    jit->memory           = nullptr;
+    jit->size             = 0;
+    jit->symbol_count     = 0;
+    jit->symbol_addresses = nullptr;
+}
+
+bool elf_jit_symbol(ELF_Jit const *restrict jit,
+                    ELF_Object const *restrict object,
+                    StringView name,
+                    u64 *restrict address) {
+    assert(jit != nullptr);
+    assert(object != nullptr);
+    for (u64 index = 0; index < object->symbols.count; ++index) {
+        ELF_Symbol const *symbol = object->symbols.buffer + index;
+        if (symbol->defined && string_view_equal(symbol->name, name)) {
+            *address = jit->symbol_addresses[index];
+            return true;
+        }
+    }
+    return false;
+}
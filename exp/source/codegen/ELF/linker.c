@@ -0,0 +1,952 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <elf.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codegen/ELF/linker.h"
+#include "support/allocation.h"
+#include "support/array_growth.h"
+#include "support/message.h"
+#include "support/numeric_conversions.h"
+#include "support/panic.h"
+#include "support/unreachable.h"
+
+/*
+ * the executable is laid out the same way ld lays out a small
+ * static executable. the first segment maps the headers, .text,
+ * and .rodata. the second segment (if needed) maps .data and .bss.
+ * each segment is mapped at ELF_LINKER_BASE_ADDRESS plus its file
+ * offset, so the file offset of any address is (address - base).
+ */
+#define ELF_LINKER_BASE_ADDRESS 0x400000
+#define ELF_LINKER_PAGE_SIZE    0x1000
+
+typedef enum ELF_OutputKind : u8 {
+    ELF_OUTPUT_TEXT,
+    ELF_OUTPUT_RODATA,
+    ELF_OUTPUT_DATA,
+    ELF_OUTPUT_BSS,
+    ELF_OUTPUT_NONE,
+} ELF_OutputKind;
+
+typedef struct ELF_OutputSection {
+    u64 offset;
+    u64 size;
+    u64 align;
+} ELF_OutputSection;
+
+typedef struct ELF_ObjectSymbols {
+    Elf64_Shdr symtab;
+    Elf64_Shdr strtab;
+    u64        count;
+} ELF_ObjectSymbols;
+
+static void elf_linker_error(StringView subject,
+                             StringView problem,
+                             StringView detail) {
+    String buffer = string_create();
+    string_append(&buffer, subject);
+    string_append(&buffer, SV(": "));
+    string_append(&buffer, problem);
+    string_append(&buffer, detail);
+    message(MESSAGE_ERROR, NULL, 0, string_to_view(&buffer), stderr);
+    string_destroy(&buffer);
+}
+
+static u64 elf_align_up(u64 value, u64 align) {
+    if (align <= 1) { return value; }
+    return (value + align - 1) & ~(align - 1);
+}
+
+void elf_linker_create(ELF_Linker *restrict linker) {
+    assert(linker != nullptr);
+    linker->objects.count    = 0;
+    linker->objects.capacity = 0;
+    linker->objects.buffer   = nullptr;
+    linker->symbols.count    = 0;
+    linker->symbols.capacity = 0;
+    linker->symbols.buffer   = nullptr;
+}
+
+void elf_linker_destroy(ELF_Linker *restrict linker) {
+    assert(linker != nullptr);
+    for (u64 index = 0; index < linker->objects.count; ++index) {
+        deallocate(linker->objects.buffer[index].section_addresses);
+    }
+    linker->objects.count    = 0;
+    linker->objects.capacity = 0;
+    deallocate(linker->objects.buffer);
+    linker->objects.buffer   = nullptr;
+    linker->symbols.count    = 0;
+    linker->symbols.capacity = 0;
+    deallocate(linker->symbols.buffer);
+    linker->symbols.buffer = nullptr;
+}
+
+static bool elf_linker_objects_full(ELF_LinkerObjects *restrict objects) {
+    return (objects->count + 1) >= objects->capacity;
+}
+
+static void elf_linker_objects_grow(ELF_LinkerObjects *restrict objects) {
+    Growth_u64 g =
+        array_growth_u64(objects->capacity, sizeof(ELF_LinkerObject));
+    objects->buffer   = reallocate_tagged("elf", objects->buffer, g.alloc_size);
+    objects->capacity = g.new_capacity;
+}
+
+static void elf_linker_append_object(ELF_Linker *restrict linker,
+                                     StringView name,
+                                     StringView bytes,
+                                     bool       included) {
+    ELF_LinkerObjects *objects = &linker->objects;
+    if (elf_linker_objects_full(objects)) { elf_linker_objects_grow(objects); }
+
+    objects->buffer[objects->count++] =
+        (ELF_LinkerObject){.name              = name,
+                           .bytes             = bytes,
+                           .included          = included,
+                           .section_addresses = nullptr};
+}
+
+void elf_linker_add_object(ELF_Linker *restrict linker,
+                           StringView name,
+                           StringView bytes) {
+    assert(linker != nullptr);
+    elf_linker_append_object(linker, name, bytes, true);
+}
+
+/*
+ * the ar(1) format is the global header "!<arch>\n" followed by
+ * members, each of which is a 60 byte header followed by the member
+ * data, padded to an even length. the GNU variant stores the symbol
+ * index in a member named "/" and long names in a member named "//".
+ */
+#define AR_MAGIC        "!<arch>\n"
+#define AR_HEADER_SIZE  60
+#define AR_NAME_LENGTH  16
+#define AR_SIZE_OFFSET  48
+#define AR_SIZE_LENGTH  10
+#define AR_FMAG_OFFSET  58
+
+static StringView ar_member_name(StringView header, StringView long_names) {
+    char const *name = header.ptr;
+    if ((name[0] == '/') && (name[1] >= '0') && (name[1] <= '9')) {
+        u64 offset = 0;
+        u64 length = 1;
+        while ((length < AR_NAME_LENGTH) && (name[length] >= '0') &&
+               (name[length] <= '9')) {
+            ++length;
+        }
+
+        if (!str_to_u64(&offset, name + 1, length - 1) ||
+            (offset >= long_names.length)) {
+            return SV("<unknown>");
+        }
+
+        u64 end = offset;
+        while ((end < long_names.length) && (long_names.ptr[end] != '/') &&
+               (long_names.ptr[end] != '\n')) {
+            ++end;
+        }
+        return string_view(long_names.ptr + offset, end - offset);
+    }
+
+    u64 length = 0;
+    while ((length < AR_NAME_LENGTH) && (name[length] != '/') &&
+           (name[length] != ' ')) {
+        ++length;
+    }
+    return string_view(name, length);
+}
+
+i32 elf_linker_add_archive(ELF_Linker *restrict linker,
+                           StringView name,
+                           StringView bytes) {
+    assert(linker != nullptr);
+    u64 magic_length = sizeof(AR_MAGIC) - 1;
+    if ((bytes.length < magic_length) ||
+        (memcmp(bytes.ptr, AR_MAGIC, magic_length) != 0)) {
+        elf_linker_error(name, SV("not an archive"), SV(""));
+        return EXIT_FAILURE;
+    }
+
+    StringView long_names = SV("");
+    u64        cursor     = magic_length;
+    while (cursor < bytes.length) {
+        if ((bytes.length - cursor) < AR_HEADER_SIZE) {
+            elf_linker_error(name, SV("truncated archive member"), SV(""));
+            return EXIT_FAILURE;
+        }
+
+        StringView header = string_view(bytes.ptr + cursor, AR_HEADER_SIZE);
+        if ((header.ptr[AR_FMAG_OFFSET] != '`') ||
+            (header.ptr[AR_FMAG_OFFSET + 1] != '\n')) {
+            elf_linker_error(name, SV("malformed archive member"), SV(""));
+            return EXIT_FAILURE;
+        }
+
+        u64 size_length = 0;
+        while ((size_length < AR_SIZE_LENGTH) &&
+               (header.ptr[AR_SIZE_OFFSET + size_length] != ' ')) {
+            ++size_length;
+        }
+
+        u64 size = 0;
+        if (!str_to_u64(&size, header.ptr + AR_SIZE_OFFSET, size_length) ||
+            (size > (bytes.length - cursor - AR_HEADER_SIZE))) {
+            elf_linker_error(name, SV("malformed archive member"), SV(""));
+            return EXIT_FAILURE;
+        }
+
+        StringView data =
+            string_view(bytes.ptr + cursor + AR_HEADER_SIZE, size);
+        StringView member = ar_member_name(header, long_names);
+
+        if ((header.ptr[0] == '/') && (header.ptr[1] == '/')) {
+            long_names = data;
+        } else if ((header.ptr[0] == '/') && (header.ptr[1] == ' ')) {
+            // the symbol index, we read the symbol tables directly.
+        } else if ((data.length >= SELFMAG) &&
+                   (memcmp(data.ptr, ELFMAG, SELFMAG) == 0)) {
+            elf_linker_append_object(linker, member, data, false);
+        }
+
+        cursor += AR_HEADER_SIZE + size + (size & 1);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static bool elf_bytes_read(StringView bytes, u64 offset, void *out, u64 size) {
+    if ((offset > bytes.length) || (size > (bytes.length - offset))) {
+        return false;
+    }
+    memcpy(out, bytes.ptr + offset, size);
+    return true;
+}
+
+static Elf64_Ehdr elf_object_header(ELF_LinkerObject const *restrict object) {
+    Elf64_Ehdr header;
+    bool valid = elf_bytes_read(object->bytes, 0, &header, sizeof(header));
+    assert(valid);
+    (void)valid;
+    return header;
+}
+
+static Elf64_Shdr elf_object_section(ELF_LinkerObject const *restrict object,
+                                     u64 index) {
+    Elf64_Ehdr header = elf_object_header(object);
+    assert(index < header.e_shnum);
+    Elf64_Shdr section;
+    bool       valid = elf_bytes_read(object->bytes,
+                                header.e_shoff + (index * sizeof(section)),
+                                &section,
+                                sizeof(section));
+    assert(valid);
+    (void)valid;
+    return section;
+}
+
+static bool elf_object_validate(ELF_LinkerObject const *restrict object) {
+    Elf64_Ehdr header;
+    if (!elf_bytes_read(object->bytes, 0, &header, sizeof(header)) ||
+        (memcmp(header.e_ident, ELFMAG, SELFMAG) != 0)) {
+        elf_linker_error(object->name, SV("not an ELF file"), SV(""));
+        return false;
+    }
+
+    if ((header.e_ident[EI_CLASS] != ELFCLASS64) ||
+        (header.e_ident[EI_DATA] != ELFDATA2LSB) ||
+        (header.e_machine != EM_X86_64) || (header.e_type != ET_REL)) {
+        elf_linker_error(
+            object->name, SV("not an x86-64 relocatable object"), SV(""));
+        return false;
+    }
+
+    if ((header.e_shentsize != sizeof(Elf64_Shdr)) ||
+        (header.e_shoff > object->bytes.length) ||
+        (((object->bytes.length - header.e_shoff) / sizeof(Elf64_Shdr)) <
+         header.e_shnum)) {
+        elf_linker_error(object->name, SV("malformed section table"), SV(""));
+        return false;
+    }
+
+    for (u64 index = 0; index < header.e_shnum; ++index) {
+        Elf64_Shdr section = elf_object_section(object, index);
+        if (section.sh_type == SHT_NOBITS) { continue; }
+        if ((section.sh_offset > object->bytes.length) ||
+            (section.sh_size > (object->bytes.length - section.sh_offset))) {
+            elf_linker_error(object->name, SV("malformed section"), SV(""));
+            return false;
+        }
+
+        if (section.sh_type == SHT_REL) {
+            elf_linker_error(
+                object->name, SV("SHT_REL sections are unsupported"), SV(""));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool elf_object_symbols(ELF_LinkerObject const *restrict object,
+                               ELF_ObjectSymbols *restrict symbols) {
+    Elf64_Ehdr header = elf_object_header(object);
+    for (u64 index = 0; index < header.e_shnum; ++index) {
+        Elf64_Shdr section = elf_object_section(object, index);
+        if (section.sh_type != SHT_SYMTAB) { continue; }
+        if (section.sh_link >= header.e_shnum) { return false; }
+
+        symbols->symtab = section;
+        symbols->strtab = elf_object_section(object, section.sh_link);
+        symbols->count  = section.sh_size / sizeof(Elf64_Sym);
+        return true;
+    }
+
+    return false;
+}
+
+static Elf64_Sym elf_object_symbol(ELF_LinkerObject const *restrict object,
+                                   ELF_ObjectSymbols const *restrict symbols,
+                                   u64 index) {
+    assert(index < symbols->count);
+    Elf64_Sym symbol;
+    bool      valid =
+        elf_bytes_read(object->bytes,
+                       symbols->symtab.sh_offset + (index * sizeof(symbol)),
+                       &symbol,
+                       sizeof(symbol));
+    assert(valid);
+    (void)valid;
+    return symbol;
+}
+
+static StringView elf_object_string(ELF_LinkerObject const *restrict object,
+                                    Elf64_Shdr const *restrict strtab,
+                                    u32 offset) {
+    if (offset >= strtab->sh_size) { return SV(""); }
+    char const *begin = object->bytes.ptr + strtab->sh_offset + offset;
+    u64 length = strnlen(begin, strtab->sh_size - offset);
+    return string_view(begin, length);
+}
+
+static bool elf_symbol_is_global(Elf64_Sym const *restrict symbol) {
+    u8 bind = ELF64_ST_BIND(symbol->st_info);
+    return (bind == STB_GLOBAL) || (bind == STB_WEAK);
+}
+
+static ELF_LinkerSymbol *elf_linker_lookup(ELF_Linker *restrict linker,
+                                           StringView name) {
+    ELF_LinkerSymbols *symbols = &linker->symbols;
+    for (u64 index = 0; index < symbols->count; ++index) {
+        ELF_LinkerSymbol *symbol = symbols->buffer + index;
+        if (string_view_equal(symbol->name, name)) { return symbol; }
+    }
+    return nullptr;
+}
+
+static bool elf_linker_symbols_full(ELF_LinkerSymbols *restrict symbols) {
+    return (symbols->count + 1) >= symbols->capacity;
+}
+
+static void elf_linker_symbols_grow(ELF_LinkerSymbols *restrict symbols) {
+    Growth_u64 g =
+        array_growth_u64(symbols->capacity, sizeof(ELF_LinkerSymbol));
+    symbols->buffer   = reallocate_tagged("elf", symbols->buffer, g.alloc_size);
+    symbols->capacity = g.new_capacity;
+}
+
+/**
+ * @brief add the global symbols defined by <object> to the symbol table.
+ */
+static bool elf_linker_define_symbols(ELF_Linker *restrict linker,
+                                      u64 object_index) {
+    ELF_LinkerObject *object = linker->objects.buffer + object_index;
+    ELF_ObjectSymbols symbols;
+    if (!elf_object_symbols(object, &symbols)) { return true; }
+
+    bool success = true;
+    for (u64 index = symbols.symtab.sh_info; index < symbols.count; ++index) {
+        Elf64_Sym symbol = elf_object_symbol(object, &symbols, index);
+        if (!elf_symbol_is_global(&symbol)) { continue; }
+        if (symbol.st_shndx == SHN_UNDEF) { continue; }
+
+        StringView name =
+            elf_object_string(object, &symbols.strtab, symbol.st_name);
+        if (symbol.st_shndx == SHN_COMMON) {
+            elf_linker_error(
+                object->name, SV("common symbols are unsupported: "), name);
+            success = false;
+            continue;
+        }
+
+        bool              weak     = ELF64_ST_BIND(symbol.st_info) == STB_WEAK;
+        ELF_LinkerSymbol *existing = elf_linker_lookup(linker, name);
+        if (existing != nullptr) {
+            if (weak) { continue; }
+            if (!existing->weak) {
+                elf_linker_error(
+                    object->name, SV("multiple definition of "), name);
+                success = false;
+                continue;
+            }
+        } else {
+            ELF_LinkerSymbols *table = &linker->symbols;
+            if (elf_linker_symbols_full(table)) {
+                elf_linker_symbols_grow(table);
+            }
+            existing = table->buffer + table->count++;
+        }
+
+        *existing = (ELF_LinkerSymbol){.name    = name,
+                                       .object  = object_index,
+                                       .section = symbol.st_shndx,
+                                       .value   = symbol.st_value,
+                                       .weak    = weak};
+    }
+
+    return success;
+}
+
+/**
+ * @brief is <name> the entry symbol, or referenced by an included object,
+ * and not yet defined.
+ */
+static bool elf_linker_is_needed(ELF_Linker *restrict linker,
+                                 StringView entry,
+                                 StringView name) {
+    if (elf_linker_lookup(linker, name) != nullptr) { return false; }
+    if (string_view_equal(entry, name)) { return true; }
+
+    for (u64 i = 0; i < linker->objects.count; ++i) {
+        ELF_LinkerObject *object = linker->objects.buffer + i;
+        if (!object->included) { continue; }
+
+        ELF_ObjectSymbols symbols;
+        if (!elf_object_symbols(object, &symbols)) { continue; }
+
+        for (u64 j = symbols.symtab.sh_info; j < symbols.count; ++j) {
+            Elf64_Sym symbol = elf_object_symbol(object, &symbols, j);
+            if (symbol.st_shndx != SHN_UNDEF) { continue; }
+            StringView reference =
+                elf_object_string(object, &symbols.strtab, symbol.st_name);
+            if (string_view_equal(reference, name)) { return true; }
+        }
+    }
+
+    return false;
+}
+
+static bool elf_linker_object_is_needed(ELF_Linker *restrict linker,
+                                        StringView entry,
+                                        ELF_LinkerObject const *object) {
+    ELF_ObjectSymbols symbols;
+    if (!elf_object_symbols(object, &symbols)) { return false; }
+
+    for (u64 index = symbols.symtab.sh_info; index < symbols.count; ++index) {
+        Elf64_Sym symbol = elf_object_symbol(object, &symbols, index);
+        if (!elf_symbol_is_global(&symbol)) { continue; }
+        if (symbol.st_shndx == SHN_UNDEF) { continue; }
+
+        StringView name =
+            elf_object_string(object, &symbols.strtab, symbol.st_name);
+        if (elf_linker_is_needed(linker, entry, name)) { return true; }
+    }
+
+    return false;
+}
+
+static bool elf_linker_resolve(ELF_Linker *restrict linker, StringView entry) {
+    bool success = true;
+    for (u64 index = 0; index < linker->objects.count; ++index) {
+        if (!linker->objects.buffer[index].included) { continue; }
+        success &= elf_linker_define_symbols(linker, index);
+    }
+
+    // pull in archive members until every reference they can satisfy is.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (u64 index = 0; index < linker->objects.count; ++index) {
+            ELF_LinkerObject *object = linker->objects.buffer + index;
+            if (object->included) { continue; }
+            if (!elf_linker_object_is_needed(linker, entry, object)) {
+                continue;
+            }
+
+            object->included = true;
+            success &= elf_linker_define_symbols(linker, index);
+            changed = true;
+        }
+    }
+
+    for (u64 i = 0; i < linker->objects.count; ++i) {
+        ELF_LinkerObject *object = linker->objects.buffer + i;
+        if (!object->included) { continue; }
+
+        ELF_ObjectSymbols symbols;
+        if (!elf_object_symbols(object, &symbols)) { continue; }
+
+        for (u64 j = symbols.symtab.sh_info; j < symbols.count; ++j) {
+            Elf64_Sym symbol = elf_object_symbol(object, &symbols, j);
+            if (symbol.st_shndx != SHN_UNDEF) { continue; }
+            if (ELF64_ST_BIND(symbol.st_info) == STB_WEAK) { continue; }
+
+            StringView name =
+                elf_object_string(object, &symbols.strtab, symbol.st_name);
+            if (elf_linker_lookup(linker, name) == nullptr) {
+                elf_linker_error(
+                    object->name, SV("undefined reference to "), name);
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+static ELF_OutputKind elf_output_kind(Elf64_Shdr const *restrict section) {
+    if (!(section->sh_flags & SHF_ALLOC)) { return ELF_OUTPUT_NONE; }
+    if (section->sh_type == SHT_NOBITS) { return ELF_OUTPUT_BSS; }
+    if (section->sh_flags & SHF_EXECINSTR) { return ELF_OUTPUT_TEXT; }
+    if (section->sh_flags & SHF_WRITE) { return ELF_OUTPUT_DATA; }
+    return ELF_OUTPUT_RODATA;
+}
+
+/**
+ * @brief assign every allocated section of every included object
+ * an address within the executable.
+ *
+ * @return the number of program headers the executable needs.
+ */
+static u16 elf_linker_layout(ELF_Linker *restrict linker,
+                             ELF_OutputSection outputs[ELF_OUTPUT_NONE]) {
+    for (u8 kind = 0; kind < ELF_OUTPUT_NONE; ++kind) {
+        outputs[kind] = (ELF_OutputSection){.offset = 0, .size = 0, .align = 1};
+    }
+
+    // first, the offset of each input section within its output section
+    for (u8 kind = 0; kind < ELF_OUTPUT_NONE; ++kind) {
+        ELF_OutputSection *output = outputs + kind;
+        for (u64 i = 0; i < linker->objects.count; ++i) {
+            ELF_LinkerObject *object = linker->objects.buffer + i;
+            if (!object->included) { continue; }
+
+            Elf64_Ehdr header = elf_object_header(object);
+            if (object->section_addresses == nullptr) {
+                object->section_addresses =
+                    callocate_tagged("elf", header.e_shnum, sizeof(u64));
+            }
+
+            for (u64 j = 0; j < header.e_shnum; ++j) {
+                Elf64_Shdr section = elf_object_section(object, j);
+                if (elf_output_kind(&section) != kind) { continue; }
+
+                u64 align = section.sh_addralign;
+                if (align == 0) { align = 1; }
+                if (align > output->align) { output->align = align; }
+
+                u64 offset = elf_align_up(output->size, align);
+                object->section_addresses[j] = offset;
+                output->size = offset + section.sh_size;
+            }
+        }
+    }
+
+    bool has_data =
+        (outputs[ELF_OUTPUT_DATA].size + outputs[ELF_OUTPUT_BSS].size) > 0;
+    // the text segment, the optional data segment, and PT_GNU_STACK
+    u16 segments = has_data ? 3 : 2;
+
+    u64 headers = sizeof(Elf64_Ehdr) + (segments * sizeof(Elf64_Phdr));
+    outputs[ELF_OUTPUT_TEXT].offset =
+        elf_align_up(headers, outputs[ELF_OUTPUT_TEXT].align);
+    outputs[ELF_OUTPUT_RODATA].offset =
+        elf_align_up(outputs[ELF_OUTPUT_TEXT].offset +
+                         outputs[ELF_OUTPUT_TEXT].size,
+                     outputs[ELF_OUTPUT_RODATA].align);
+    u64 text_end =
+        outputs[ELF_OUTPUT_RODATA].offset + outputs[ELF_OUTPUT_RODATA].size;
+
+    u64 data_align = ELF_LINKER_PAGE_SIZE;
+    if (outputs[ELF_OUTPUT_DATA].align > data_align) {
+        data_align = outputs[ELF_OUTPUT_DATA].align;
+    }
+    outputs[ELF_OUTPUT_DATA].offset = elf_align_up(text_end, data_align);
+    outputs[ELF_OUTPUT_BSS].offset =
+        elf_align_up(outputs[ELF_OUTPUT_DATA].offset +
+                         outputs[ELF_OUTPUT_DATA].size,
+                     outputs[ELF_OUTPUT_BSS].align);
+
+    // then the address of each input section
+    for (u64 i = 0; i < linker->objects.count; ++i) {
+        ELF_LinkerObject *object = linker->objects.buffer + i;
+        if (!object->included) { continue; }
+
+        Elf64_Ehdr header = elf_object_header(object);
+        for (u64 j = 0; j < header.e_shnum; ++j) {
+            Elf64_Shdr     section = elf_object_section(object, j);
+            ELF_OutputKind kind    = elf_output_kind(&section);
+            if (kind == ELF_OUTPUT_NONE) { continue; }
+
+            object->section_addresses[j] += ELF_LINKER_BASE_ADDRESS +
+                                            outputs[kind].offset;
+        }
+    }
+
+    return segments;
+}
+
+static bool elf_linker_symbol_address(ELF_Linker *restrict linker,
+                                      StringView name,
+                                      u64 *restrict address) {
+    ELF_LinkerSymbol *symbol = elf_linker_lookup(linker, name);
+    if (symbol == nullptr) { return false; }
+
+    if (symbol->section == SHN_ABS) {
+        *address = symbol->value;
+        return true;
+    }
+
+    ELF_LinkerObject *object = linker->objects.buffer + symbol->object;
+    *address = object->section_addresses[symbol->section] + symbol->value;
+    return true;
+}
+
+static bool elf_linker_relocation_symbol(ELF_Linker *restrict linker,
+                                         ELF_LinkerObject *restrict object,
+                                         ELF_ObjectSymbols const *symbols,
+                                         u64 index,
+                                         u64 *restrict address) {
+    if (index >= symbols->count) {
+        elf_linker_error(object->name, SV("malformed relocation"), SV(""));
+        return false;
+    }
+
+    Elf64_Sym  symbol = elf_object_symbol(object, symbols, index);
+    StringView name =
+        elf_object_string(object, &symbols->strtab, symbol.st_name);
+
+    // globals bind to whichever definition won symbol resolution.
+    if (elf_symbol_is_global(&symbol)) {
+        if (elf_linker_symbol_address(linker, name, address)) { return true; }
+        if (ELF64_ST_BIND(symbol.st_info) == STB_WEAK) {
+            *address = 0;
+            return true;
+        }
+        elf_linker_error(object->name, SV("undefined reference to "), name);
+        return false;
+    }
+
+    if (symbol.st_shndx == SHN_ABS) {
+        *address = symbol.st_value;
+        return true;
+    }
+
+    Elf64_Ehdr header = elf_object_header(object);
+    if ((symbol.st_shndx == SHN_UNDEF) || (symbol.st_shndx >= header.e_shnum) ||
+        (object->section_addresses[symbol.st_shndx] == 0)) {
+        elf_linker_error(
+            object->name, SV("relocation against a discarded symbol "), name);
+        return false;
+    }
+
+    *address = object->section_addresses[symbol.st_shndx] + symbol.st_value;
+    return true;
+}
+
+static bool elf_linker_relocate(ELF_Linker *restrict linker,
+                                u64 object_index,
+                                u8 *restrict image) {
+    ELF_LinkerObject *object = linker->objects.buffer + object_index;
+    ELF_ObjectSymbols symbols;
+    if (!elf_object_symbols(object, &symbols)) { symbols.count = 0; }
+
+    bool       success = true;
+    Elf64_Ehdr header  = elf_object_header(object);
+    for (u64 i = 0; i < header.e_shnum; ++i) {
+        Elf64_Shdr rela = elf_object_section(object, i);
+        if (rela.sh_type != SHT_RELA) { continue; }
+        if (rela.sh_info >= header.e_shnum) {
+            elf_linker_error(object->name, SV("malformed relocation"), SV(""));
+            return false;
+        }
+
+        Elf64_Shdr target = elf_object_section(object, rela.sh_info);
+        if (elf_output_kind(&target) == ELF_OUTPUT_NONE) { continue; }
+        if (target.sh_type == SHT_NOBITS) {
+            elf_linker_error(object->name, SV("relocation in .bss"), SV(""));
+            return false;
+        }
+
+        u64 target_address = object->section_addresses[rela.sh_info];
+        u64 count          = rela.sh_size / sizeof(Elf64_Rela);
+        for (u64 j = 0; j < count; ++j) {
+            Elf64_Rela entry;
+            elf_bytes_read(object->bytes,
+                           rela.sh_offset + (j * sizeof(entry)),
+                           &entry,
+                           sizeof(entry));
+
+            u32 type = ELF64_R_TYPE(entry.r_info);
+            if (type == R_X86_64_NONE) { continue; }
+
+            u64 S = 0;
+            if (!elf_linker_relocation_symbol(
+                    linker, object, &symbols, ELF64_R_SYM(entry.r_info), &S)) {
+                success = false;
+                continue;
+            }
+
+            i64 A     = entry.r_addend;
+            u64 P     = target_address + entry.r_offset;
+            u64 width =
+                ((type == R_X86_64_64) || (type == R_X86_64_PC64)) ? 8 : 4;
+            if ((entry.r_offset > target.sh_size) ||
+                (width > (target.sh_size - entry.r_offset))) {
+                elf_linker_error(
+                    object->name, SV("relocation out of bounds"), SV(""));
+                success = false;
+                continue;
+            }
+
+            u8 *location = image + (P - ELF_LINKER_BASE_ADDRESS);
+            i64 value    = 0;
+            switch (type) {
+            case R_X86_64_64:   value = (i64)S + A; break;
+            case R_X86_64_PC64: value = (i64)S + A - (i64)P; break;
+            case R_X86_64_32:
+            case R_X86_64_32S:  value = (i64)S + A; break;
+            case R_X86_64_PC32:
+            case R_X86_64_PLT32: value = (i64)S + A - (i64)P; break;
+            default: {
+                elf_linker_error(
+                    object->name, SV("unsupported relocation type"), SV(""));
+                success = false;
+                continue;
+            }
+            }
+
+            if (width == 8) {
+                u64 bits = (u64)value;
+                memcpy(location, &bits, sizeof(bits));
+                continue;
+            }
+
+            bool fits = (type == R_X86_64_32) ? i64_in_range_u32(value)
+                                              : i64_in_range_i32(value);
+            if (!fits) {
+                elf_linker_error(
+                    object->name, SV("relocation overflow"), SV(""));
+                success = false;
+                continue;
+            }
+
+            u32 bits = (u32)value;
+            memcpy(location, &bits, sizeof(bits));
+        }
+    }
+
+    return success;
+}
+
+static void elf_linker_copy_sections(ELF_Linker *restrict linker,
+                                     u8 *restrict image) {
+    for (u64 i = 0; i < linker->objects.count; ++i) {
+        ELF_LinkerObject *object = linker->objects.buffer + i;
+        if (!object->included) { continue; }
+
+        Elf64_Ehdr header = elf_object_header(object);
+        for (u64 j = 0; j < header.e_shnum; ++j) {
+            Elf64_Shdr section = elf_object_section(object, j);
+            if (elf_output_kind(&section) == ELF_OUTPUT_NONE) { continue; }
+            if (section.sh_type == SHT_NOBITS) { continue; }
+
+            u64 offset = object->section_addresses[j] - ELF_LINKER_BASE_ADDRESS;
+            memcpy(image + offset,
+                   object->bytes.ptr + section.sh_offset,
+                   section.sh_size);
+        }
+    }
+}
+
+static void elf_linker_write_section_headers(
+    ELF_OutputSection const outputs[ELF_OUTPUT_NONE],
+    Elf64_Ehdr *restrict header,
+    String *restrict executable) {
+    static char const *names[ELF_OUTPUT_NONE] = {
+        ".text", ".rodata", ".data", ".bss"};
+
+    String     shstrtab = string_create();
+    Elf64_Shdr sections[ELF_OUTPUT_NONE + 2];
+    memset(sections, 0, sizeof(sections));
+    u16 count = 1;
+
+    string_append(&shstrtab, string_view("", 1));
+    for (u8 kind = 0; kind < ELF_OUTPUT_NONE; ++kind) {
+        ELF_OutputSection const *output = outputs + kind;
+        if (output->size == 0) { continue; }
+
+        Elf64_Shdr *section = sections + count++;
+        section->sh_name    = (u32)shstrtab.length;
+        string_append(&shstrtab, string_view_from_cstring(names[kind]));
+        string_append(&shstrtab, string_view("", 1));
+
+        section->sh_type      = SHT_PROGBITS;
+        section->sh_flags     = SHF_ALLOC;
+        section->sh_addr      = ELF_LINKER_BASE_ADDRESS + output->offset;
+        section->sh_offset    = output->offset;
+        section->sh_size      = output->size;
+        section->sh_addralign = output->align;
+        switch (kind) {
+        case ELF_OUTPUT_TEXT:   section->sh_flags |= SHF_EXECINSTR; break;
+        case ELF_OUTPUT_RODATA: break;
+        case ELF_OUTPUT_DATA:   section->sh_flags |= SHF_WRITE; break;
+        case ELF_OUTPUT_BSS:
+            section->sh_type = SHT_NOBITS;
+            section->sh_flags |= SHF_WRITE;
+            break;
+        default: EXP_UNREACHABLE();
+        }
+    }
+
+    Elf64_Shdr *section = sections + count;
+    section->sh_name    = (u32)shstrtab.length;
+    string_append(&shstrtab, SV(".shstrtab"));
+    string_append(&shstrtab, string_view("", 1));
+    section->sh_type      = SHT_STRTAB;
+    section->sh_offset    = executable->length;
+    section->sh_size      = shstrtab.length;
+    section->sh_addralign = 1;
+    header->e_shstrndx    = count++;
+    string_append_string(executable, &shstrtab);
+
+    u64 padding = elf_align_up(executable->length, 8) - executable->length;
+    string_append(executable, string_view("\0\0\0\0\0\0\0", padding));
+    header->e_shoff     = executable->length;
+    header->e_shentsize = sizeof(Elf64_Shdr);
+    header->e_shnum     = count;
+    string_append(executable,
+                  string_view((char const *)sections,
+                              count * sizeof(Elf64_Shdr)));
+
+    string_destroy(&shstrtab);
+}
+
+i32 elf_linker_link(ELF_Linker *restrict linker,
+                    StringView entry,
+                    String *restrict executable) {
+    assert(linker != nullptr);
+    assert(executable != nullptr);
+    assert(string_empty(executable));
+
+    for (u64 index = 0; index < linker->objects.count; ++index) {
+        if (!elf_object_validate(linker->objects.buffer + index)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!elf_linker_resolve(linker, entry)) { return EXIT_FAILURE; }
+
+    ELF_OutputSection outputs[ELF_OUTPUT_NONE];
+    u16               segments = elf_linker_layout(linker, outputs);
+
+    u64 entry_address = 0;
+    if (!elf_linker_symbol_address(linker, entry, &entry_address)) {
+        elf_linker_error(SV("exp"), SV("undefined entry symbol "), entry);
+        return EXIT_FAILURE;
+    }
+
+    u64 text_end =
+        outputs[ELF_OUTPUT_RODATA].offset + outputs[ELF_OUTPUT_RODATA].size;
+    u64 data_end =
+        outputs[ELF_OUTPUT_DATA].offset + outputs[ELF_OUTPUT_DATA].size;
+    u64 bss_end = outputs[ELF_OUTPUT_BSS].offset + outputs[ELF_OUTPUT_BSS].size;
+    u64 image_size = (segments == 3) ? data_end : text_end;
+
+    u8 *image = callocate_tagged("elf", image_size, sizeof(u8));
+    elf_linker_copy_sections(linker, image);
+
+    bool success = true;
+    for (u64 index = 0; index < linker->objects.count; ++index) {
+        if (!linker->objects.buffer[index].included) { continue; }
+        success &= elf_linker_relocate(linker, index, image);
+    }
+
+    if (!success) {
+        deallocate(image);
+        return EXIT_FAILURE;
+    }
+
+    Elf64_Ehdr header = {0};
+    memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS]   = ELFCLASS64;
+    header.e_ident[EI_DATA]    = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI]   = ELFOSABI_SYSV;
+    header.e_type              = ET_EXEC;
+    header.e_machine           = EM_X86_64;
+    header.e_version           = EV_CURRENT;
+    header.e_entry             = entry_address;
+    header.e_phoff             = sizeof(Elf64_Ehdr);
+    header.e_ehsize            = sizeof(Elf64_Ehdr);
+    header.e_phentsize         = sizeof(Elf64_Phdr);
+    header.e_phnum             = segments;
+
+    Elf64_Phdr programs[3];
+    memset(programs, 0, sizeof(programs));
+    programs[0] = (Elf64_Phdr){.p_type   = PT_LOAD,
+                               .p_flags  = PF_R | PF_X,
+                               .p_offset = 0,
+                               .p_vaddr  = ELF_LINKER_BASE_ADDRESS,
+                               .p_paddr  = ELF_LINKER_BASE_ADDRESS,
+                               .p_filesz = text_end,
+                               .p_memsz  = text_end,
+                               .p_align  = ELF_LINKER_PAGE_SIZE};
+
+    if (segments == 3) {
+        u64 data_offset = outputs[ELF_OUTPUT_DATA].offset;
+        programs[1] =
+            (Elf64_Phdr){.p_type   = PT_LOAD,
+                         .p_flags  = PF_R | PF_W,
+                         .p_offset = data_offset,
+                         .p_vaddr  = ELF_LINKER_BASE_ADDRESS + data_offset,
+                         .p_paddr  = ELF_LINKER_BASE_ADDRESS + data_offset,
+                         .p_filesz = data_end - data_offset,
+                         .p_memsz  = bss_end - data_offset,
+                         .p_align  = ELF_LINKER_PAGE_SIZE};
+    }
+
+    programs[segments - 1] = (Elf64_Phdr){
+        .p_type = PT_GNU_STACK, .p_flags = PF_R | PF_W, .p_align = 16};
+
+    string_append(executable, string_view((char const *)image, image_size));
+    deallocate(image);
+
+    elf_linker_write_section_headers(outputs, &header, executable);
+
+    // the headers are written last, into the space reserved for them.
+    char *bytes = (char *)string_to_cstring(executable);
+    memcpy(bytes, &header, sizeof(header));
+    memcpy(bytes + sizeof(header), programs, segments * sizeof(Elf64_Phdr));
+    return EXIT_SUCCESS;
+}
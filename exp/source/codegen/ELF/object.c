@@ -0,0 +1,339 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <elf.h>
+#include <string.h>
+
+#include "codegen/ELF/object.h"
+#include "support/allocation.h"
+#include "support/array_growth.h"
+#include "support/io.h"
+#include "support/panic.h"
+
+/*
+ * the layout of the sections within the object file we write.
+ * the STT_FILE and STT_SECTION symbols are always the first two
+ * (local) symbols of .symtab, so ELF_Object symbol i is .symtab
+ * entry (i + ELF_FIRST_GLOBAL_SYMBOL).
+ */
+enum {
+    ELF_SECTION_NULL,
+    ELF_SECTION_TEXT,
+    ELF_SECTION_RELA_TEXT,
+    ELF_SECTION_SYMTAB,
+    ELF_SECTION_STRTAB,
+    ELF_SECTION_SHSTRTAB,
+    ELF_SECTION_NOTE_GNU_STACK,
+    ELF_SECTION_COUNT,
+};
+
+enum {
+    ELF_SYMBOL_NULL,
+    ELF_SYMBOL_FILE,
+    ELF_SYMBOL_TEXT,
+    ELF_FIRST_GLOBAL_SYMBOL,
+};
+
+void elf_object_create(ELF_Object *restrict object) {
+    assert(object != nullptr);
+    object->text                 = string_create();
+    object->symbols.count        = 0;
+    object->symbols.capacity     = 0;
+    object->symbols.buffer       = nullptr;
+    object->relocations.count    = 0;
+    object->relocations.capacity = 0;
+    object->relocations.buffer   = nullptr;
+}
+
+void elf_object_destroy(ELF_Object *restrict object) {
+    assert(object != nullptr);
+    string_destroy(&object->text);
+    object->symbols.count    = 0;
+    object->symbols.capacity = 0;
+    deallocate(object->symbols.buffer);
+    object->symbols.buffer       = nullptr;
+    object->relocations.count    = 0;
+    object->relocations.capacity = 0;
+    deallocate(object->relocations.buffer);
+    object->relocations.buffer = nullptr;
+}
+
+u64 elf_object_text_offset(ELF_Object const *restrict object) {
+    assert(object != nullptr);
+    return object->text.length;
+}
+
+void elf_object_append_text(ELF_Object *restrict object,
+                            u8 const *bytes,
+                            u64       length) {
+    assert(object != nullptr);
+    string_append(&object->text, string_view((char const *)bytes, length));
+}
+
+static bool elf_symbols_full(ELF_Symbols *restrict symbols) {
+    return (symbols->count + 1) >= symbols->capacity;
+}
+
+static void elf_symbols_grow(ELF_Symbols *restrict symbols) {
+    Growth_u64 g = array_growth_u64(symbols->capacity, sizeof(ELF_Symbol));
+    symbols->buffer   = reallocate_tagged("elf", symbols->buffer, g.alloc_size);
+    symbols->capacity = g.new_capacity;
+}
+
+u32 elf_object_symbol(ELF_Object *restrict object, StringView name) {
+    assert(object != nullptr);
+    ELF_Symbols *symbols = &object->symbols;
+    for (u64 index = 0; index < symbols->count; ++index) {
+        if (string_view_equal(symbols->buffer[index].name, name)) {
+            return (u32)index;
+        }
+    }
+
+    if (elf_symbols_full(symbols)) { elf_symbols_grow(symbols); }
+    if (symbols->count >= u32_MAX) { PANIC("too many ELF symbols"); }
+
+    symbols->buffer[symbols->count] =
+        (ELF_Symbol){.name = name, .offset = 0, .size = 0, .defined = false};
+    return (u32)(symbols->count++);
+}
+
+void elf_object_define_symbol(ELF_Object *restrict object,
+                              StringView name,
+                              u64        offset,
+                              u64        size) {
+    assert(object != nullptr);
+    u32         index  = elf_object_symbol(object, name);
+    ELF_Symbol *symbol = object->symbols.buffer + index;
+    assert(!symbol->defined);
+    symbol->offset  = offset;
+    symbol->size    = size;
+    symbol->defined = true;
+}
+
+static bool elf_relocations_full(ELF_Relocations *restrict relocations) {
+    return (relocations->count + 1) >= relocations->capacity;
+}
+
+static void elf_relocations_grow(ELF_Relocations *restrict relocations) {
+    Growth_u64 g =
+        array_growth_u64(relocations->capacity, sizeof(ELF_Relocation));
+    relocations->buffer =
+        reallocate_tagged("elf", relocations->buffer, g.alloc_size);
+    relocations->capacity = g.new_capacity;
+}
+
+void elf_object_relocation(ELF_Object *restrict object,
+                           u64 offset,
+                           u32 symbol,
+                           u32 type,
+                           i64 addend) {
+    assert(object != nullptr);
+    assert(symbol < object->symbols.count);
+    ELF_Relocations *relocations = &object->relocations;
+    if (elf_relocations_full(relocations)) {
+        elf_relocations_grow(relocations);
+    }
+
+    relocations->buffer[relocations->count++] = (ELF_Relocation){
+        .offset = offset, .symbol = symbol, .type = type, .addend = addend};
+}
+
+static void elf_append(String *restrict buffer, void const *data, u64 size) {
+    string_append(buffer, string_view((char const *)data, size));
+}
+
+static void
+elf_append_padding(String *restrict buffer, u64 base, u64 alignment) {
+    static char const zeroes[16] = {0};
+    assert(alignment <= sizeof(zeroes));
+    u64 remainder = (buffer->length - base) % alignment;
+    if (remainder == 0) { return; }
+    string_append(buffer, string_view(zeroes, alignment - remainder));
+}
+
+static u32 elf_string_table_append(String *restrict table, StringView name) {
+    u64 offset = table->length;
+    if (offset > u32_MAX) { PANIC("ELF string table too large"); }
+    string_append(table, name);
+    string_append(table, string_view("", 1));
+    return (u32)offset;
+}
+
+void elf_object_serialize(ELF_Object const *restrict object,
+                          StringView file_name,
+                          String *restrict buffer) {
+    assert(object != nullptr);
+    assert(buffer != nullptr);
+
+    ELF_Symbols const     *symbols     = &object->symbols;
+    ELF_Relocations const *relocations = &object->relocations;
+
+    String strtab = string_create();
+    string_append(&strtab, string_view("", 1));
+    u32 file_name_offset = elf_string_table_append(&strtab, file_name);
+
+    String shstrtab = string_create();
+    string_append(&shstrtab, string_view("", 1));
+    u32 names[ELF_SECTION_COUNT] = {0};
+    names[ELF_SECTION_TEXT] = elf_string_table_append(&shstrtab, SV(".text"));
+    names[ELF_SECTION_RELA_TEXT] =
+        elf_string_table_append(&shstrtab, SV(".rela.text"));
+    names[ELF_SECTION_SYMTAB] =
+        elf_string_table_append(&shstrtab, SV(".symtab"));
+    names[ELF_SECTION_STRTAB] =
+        elf_string_table_append(&shstrtab, SV(".strtab"));
+    names[ELF_SECTION_SHSTRTAB] =
+        elf_string_table_append(&shstrtab, SV(".shstrtab"));
+    names[ELF_SECTION_NOTE_GNU_STACK] =
+        elf_string_table_append(&shstrtab, SV(".note.GNU-stack"));
+
+    u64        symtab_count = ELF_FIRST_GLOBAL_SYMBOL + symbols->count;
+    Elf64_Sym *symtab =
+        callocate_tagged("elf", symtab_count, sizeof(Elf64_Sym));
+    symtab[ELF_SYMBOL_FILE].st_name  = file_name_offset;
+    symtab[ELF_SYMBOL_FILE].st_info  = ELF64_ST_INFO(STB_LOCAL, STT_FILE);
+    symtab[ELF_SYMBOL_FILE].st_shndx = SHN_ABS;
+    symtab[ELF_SYMBOL_TEXT].st_info  = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+    symtab[ELF_SYMBOL_TEXT].st_shndx = ELF_SECTION_TEXT;
+    for (u64 index = 0; index < symbols->count; ++index) {
+        ELF_Symbol const *symbol = symbols->buffer + index;
+        Elf64_Sym        *entry  = symtab + ELF_FIRST_GLOBAL_SYMBOL + index;
+        entry->st_name = elf_string_table_append(&strtab, symbol->name);
+        if (symbol->defined) {
+            entry->st_info  = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+            entry->st_shndx = ELF_SECTION_TEXT;
+            entry->st_value = symbol->offset;
+            entry->st_size  = symbol->size;
+        } else {
+            entry->st_info  = ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE);
+            entry->st_shndx = SHN_UNDEF;
+        }
+    }
+
+    Elf64_Shdr sections[ELF_SECTION_COUNT] = {0};
+
+    Elf64_Ehdr header = {0};
+    header.e_ident[EI_MAG0]    = ELFMAG0;
+    header.e_ident[EI_MAG1]    = ELFMAG1;
+    header.e_ident[EI_MAG2]    = ELFMAG2;
+    header.e_ident[EI_MAG3]    = ELFMAG3;
+    header.e_ident[EI_CLASS]   = ELFCLASS64;
+    header.e_ident[EI_DATA]    = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI]   = ELFOSABI_SYSV;
+    header.e_type              = ET_REL;
+    header.e_machine           = EM_X86_64;
+    header.e_version           = EV_CURRENT;
+    header.e_ehsize            = sizeof(Elf64_Ehdr);
+    header.e_shentsize         = sizeof(Elf64_Shdr);
+    header.e_shnum             = ELF_SECTION_COUNT;
+    header.e_shstrndx          = ELF_SECTION_SHSTRTAB;
+
+    // the header is rewritten once the section header offset is known.
+    u64 header_offset = buffer->length;
+    elf_append(buffer, &header, sizeof(header));
+
+    Elf64_Shdr *text   = sections + ELF_SECTION_TEXT;
+    text->sh_name      = names[ELF_SECTION_TEXT];
+    text->sh_type      = SHT_PROGBITS;
+    text->sh_flags     = SHF_ALLOC | SHF_EXECINSTR;
+    text->sh_offset    = buffer->length - header_offset;
+    text->sh_size      = object->text.length;
+    text->sh_addralign = 16;
+    elf_append(buffer, string_to_cstring(&object->text), object->text.length);
+
+    elf_append_padding(buffer, header_offset, 8);
+    Elf64_Shdr *rela   = sections + ELF_SECTION_RELA_TEXT;
+    rela->sh_name      = names[ELF_SECTION_RELA_TEXT];
+    rela->sh_type      = SHT_RELA;
+    rela->sh_flags     = SHF_INFO_LINK;
+    rela->sh_offset    = buffer->length - header_offset;
+    rela->sh_size      = relocations->count * sizeof(Elf64_Rela);
+    rela->sh_link      = ELF_SECTION_SYMTAB;
+    rela->sh_info      = ELF_SECTION_TEXT;
+    rela->sh_addralign = 8;
+    rela->sh_entsize   = sizeof(Elf64_Rela);
+    for (u64 index = 0; index < relocations->count; ++index) {
+        ELF_Relocation const *relocation = relocations->buffer + index;
+        u64 symbol = relocation->symbol + (u64)ELF_FIRST_GLOBAL_SYMBOL;
+        Elf64_Rela entry = {.r_offset = relocation->offset,
+                            .r_info = ELF64_R_INFO(symbol, relocation->type),
+                            .r_addend = relocation->addend};
+        elf_append(buffer, &entry, sizeof(entry));
+    }
+
+    Elf64_Shdr *symtab_header   = sections + ELF_SECTION_SYMTAB;
+    symtab_header->sh_name      = names[ELF_SECTION_SYMTAB];
+    symtab_header->sh_type      = SHT_SYMTAB;
+    symtab_header->sh_offset    = buffer->length - header_offset;
+    symtab_header->sh_size      = symtab_count * sizeof(Elf64_Sym);
+    symtab_header->sh_link      = ELF_SECTION_STRTAB;
+    symtab_header->sh_info      = ELF_FIRST_GLOBAL_SYMBOL;
+    symtab_header->sh_addralign = 8;
+    symtab_header->sh_entsize   = sizeof(Elf64_Sym);
+    elf_append(buffer, symtab, symtab_count * sizeof(Elf64_Sym));
+
+    Elf64_Shdr *strtab_header   = sections + ELF_SECTION_STRTAB;
+    strtab_header->sh_name      = names[ELF_SECTION_STRTAB];
+    strtab_header->sh_type      = SHT_STRTAB;
+    strtab_header->sh_offset    = buffer->length - header_offset;
+    strtab_header->sh_size      = strtab.length;
+    strtab_header->sh_addralign = 1;
+    elf_append(buffer, string_to_cstring(&strtab), strtab.length);
+
+    Elf64_Shdr *shstrtab_header   = sections + ELF_SECTION_SHSTRTAB;
+    shstrtab_header->sh_name      = names[ELF_SECTION_SHSTRTAB];
+    shstrtab_header->sh_type      = SHT_STRTAB;
+    shstrtab_header->sh_offset    = buffer->length - header_offset;
+    shstrtab_header->sh_size      = shstrtab.length;
+    shstrtab_header->sh_addralign = 1;
+    elf_append(buffer, string_to_cstring(&shstrtab), shstrtab.length);
+
+    // an empty .note.GNU-stack marks the stack as non-executable,
+    // just as gas_directive_noexecstack does for assembly.
+    Elf64_Shdr *note   = sections + ELF_SECTION_NOTE_GNU_STACK;
+    note->sh_name      = names[ELF_SECTION_NOTE_GNU_STACK];
+    note->sh_type      = SHT_PROGBITS;
+    note->sh_offset    = buffer->length - header_offset;
+    note->sh_addralign = 1;
+
+    elf_append_padding(buffer, header_offset, 8);
+    header.e_shoff = buffer->length - header_offset;
+    elf_append(buffer, sections, sizeof(sections));
+
+    char *bytes = (char *)string_to_cstring(buffer);
+    memcpy(bytes + header_offset, &header, sizeof(header));
+
+    deallocate(symtab);
+    string_destroy(&shstrtab);
+    string_destroy(&strtab);
+}
+
+void elf_object_write(ELF_Object const *restrict object,
+                      StringView file_name,
+                      StringView path) {
+    String buffer = string_create();
+    elf_object_serialize(object, file_name, &buffer);
+
+    FILE *file = file_open(path.ptr, "w");
+    file_write(string_to_view(&buffer), file);
+    file_close(file);
+
+    string_destroy(&buffer);
+}
@@ -19,6 +19,7 @@
 
 #include "codegen/IR/codegen.h"
 #include "codegen/IR/directives.h"
+#include "support/allocation.h"
 #include "support/assert.h"
 #include "support/io.h"
 
@@ -30,9 +31,9 @@ i32 ir_codegen(Context *restrict context) {
     ir_directive_file(context_source_path(context), &buffer);
 
     SymbolTable *symbol_table = &context->global_symbol_table;
-    for (u64 index = 0; index < symbol_table->capacity; ++index) {
-        Symbol *symbol = symbol_table->elements[index];
-        if (symbol == NULL) { continue; }
+    Symbol     **symbols      = symbol_table_sorted(symbol_table);
+    for (u64 index = 0; index < symbol_table->count; ++index) {
+        Symbol *symbol = symbols[index];
 
         if (symbol->kind == SYMBOL_KIND_FUNCTION) {
             ir_directive_function(symbol->name, &buffer);
@@ -40,6 +41,7 @@ i32 ir_codegen(Context *restrict context) {
             string_append(&buffer, SV("\n"));
         }
     }
+    deallocate(symbols);
 
     StringView ir_path = context_ir_path(context);
     FILE      *file    = file_open(ir_path.ptr, "w");
@@ -21,6 +21,7 @@
 
 #include "codegen/x86/codegen.h"
 #include "codegen/x86/emit.h"
+#include "codegen/x86/encode.h"
 #include "codegen/x86/env/context.h"
 #include "codegen/x86/instruction/add.h"
 #include "codegen/x86/instruction/call.h"
@@ -32,6 +33,7 @@
 #include "codegen/x86/instruction/neg.h"
 #include "codegen/x86/instruction/ret.h"
 #include "codegen/x86/instruction/sub.h"
+#include "support/allocation.h"
 #include "support/unreachable.h"
 
 /*
@@ -157,17 +159,44 @@ void x86_codegen_symbol(Symbol *symbol, x86_Context *x86_context) {
     }
 }
 
-i32 x86_codegen(Context *context) {
-    x86_Context  x86_context = x86_context_create(context);
-    SymbolTable *table       = &context->global_symbol_table;
+static void x86_codegen_symbols(x86_Context *x86_context) {
+    SymbolTable *table   = &x86_context->context->global_symbol_table;
+    Symbol     **symbols = symbol_table_sorted(table);
 
-    for (u64 index = 0; index < table->capacity; ++index) {
-        Symbol *element = table->elements[index];
-        if (element == NULL) { continue; }
-        x86_codegen_symbol(element, &x86_context);
+    for (u64 index = 0; index < table->count; ++index) {
+        x86_codegen_symbol(symbols[index], x86_context);
     }
+    deallocate(symbols);
+}
 
+i32 x86_codegen(Context *context) {
+    x86_Context x86_context = x86_context_create(context);
+    x86_codegen_symbols(&x86_context);
     x86_emit(&x86_context);
     x86_context_destroy(&x86_context);
     return 0;
 }
+
+i32 x86_codegen_buffer(Context *context, String *restrict buffer) {
+    x86_Context x86_context = x86_context_create(context);
+    x86_codegen_symbols(&x86_context);
+    x86_emit_buffer(&x86_context, buffer);
+    x86_context_destroy(&x86_context);
+    return 0;
+}
+
+i32 x86_codegen_object(Context *context) {
+    x86_Context x86_context = x86_context_create(context);
+    x86_codegen_symbols(&x86_context);
+    x86_encode(&x86_context);
+    x86_context_destroy(&x86_context);
+    return 0;
+}
+
+i32 x86_codegen_object_buffer(Context *context, ELF_Object *restrict object) {
+    x86_Context x86_context = x86_context_create(context);
+    x86_codegen_symbols(&x86_context);
+    x86_encode_object(&x86_context, object);
+    x86_context_destroy(&x86_context);
+    return 0;
+}
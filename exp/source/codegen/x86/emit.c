@@ -48,18 +48,23 @@ static void x86_emit_file_epilouge(String *restrict buffer) {
     gas_directive_noexecstack(buffer);
 }
 
-void x86_emit(x86_Context *restrict x86_context) {
-    String buffer = string_create();
-
-    x86_emit_file_prolouge(x86_context->context, &buffer);
+void x86_emit_buffer(x86_Context *restrict x86_context,
+                     String *restrict buffer) {
+    x86_emit_file_prolouge(x86_context->context, buffer);
 
     x86_SymbolTable *symbols = &x86_context->symbols;
     for (u64 i = 0; i < symbols->count; ++i) {
         x86_Symbol *sym = symbols->buffer + i;
-        x86_emit_symbol(sym, &buffer, x86_context->context);
+        x86_emit_symbol(sym, buffer, x86_context->context);
     }
 
-    x86_emit_file_epilouge(&buffer);
+    x86_emit_file_epilouge(buffer);
+}
+
+void x86_emit(x86_Context *restrict x86_context) {
+    String buffer = string_create();
+
+    x86_emit_buffer(x86_context, &buffer);
 
     StringView path = context_assembly_path(x86_context->context);
 
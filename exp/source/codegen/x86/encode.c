@@ -0,0 +1,51 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "codegen/x86/encode.h"
+
+static void x86_encode_symbol(x86_Symbol *restrict sym,
+                              ELF_Object *restrict object,
+                              Context *restrict context) {
+    u64 offset = elf_object_text_offset(object);
+    x86_bytecode_encode(&sym->body.bc, object, context);
+    u64 size = elf_object_text_offset(object) - offset;
+    elf_object_define_symbol(object, sym->name, offset, size);
+}
+
+void x86_encode_object(x86_Context *restrict x86_context,
+                       ELF_Object *restrict object) {
+    x86_SymbolTable *symbols = &x86_context->symbols;
+    for (u64 i = 0; i < symbols->count; ++i) {
+        x86_Symbol *sym = symbols->buffer + i;
+        if (string_view_empty(sym->name)) { continue; }
+        x86_encode_symbol(sym, object, x86_context->context);
+    }
+}
+
+void x86_encode(x86_Context *restrict x86_context) {
+    ELF_Object object;
+    elf_object_create(&object);
+    x86_encode_object(x86_context, &object);
+
+    elf_object_write(&object,
+                     context_source_path(x86_context->context),
+                     context_object_path(x86_context->context));
+
+    elf_object_destroy(&object);
+}
@@ -27,13 +27,15 @@ x86_Context x86_context_create(Context *context) {
         .symbols  = x86_symbol_table_create(context->global_symbol_table.count),
         .context  = context,
         .body     = nullptr,
-        .x86_body = nullptr};
+        .x86_body = nullptr,
+        .arena    = arena_create()};
     return x64_context;
 }
 
 void x86_context_destroy(x86_Context *x64_context) {
     assert(x64_context != nullptr);
     x86_symbol_table_destroy(&x64_context->symbols);
+    arena_destroy(&x64_context->arena);
 }
 
 x86_Symbol *x86_context_symbol(x86_Context *x64_context, StringView name) {
@@ -46,17 +48,18 @@ Value *x86_context_value_at(x86_Context *context, u32 index) {
     return context_constants_at(context->context, index);
 }
 
-// StringView x86_context_global_labels_at(x86_Context *x64_context, u32 idx) {
-//     assert(x64_context != nullptr);
-//     return context_labels_at(x64_context->context, idx);
-// }
+ConstantString *x86_context_global_labels_at(x86_Context *context, u32 index) {
+    assert(context != nullptr);
+    return context_labels_at(context->context, index);
+}
 
 void x86_context_enter_function(x86_Context *x64_context, StringView name) {
     assert(x64_context != nullptr);
     x64_context->body     = context_enter_function(x64_context->context, name);
     x86_Symbol *symbol    = x86_symbol_table_at(&x64_context->symbols, name);
     x64_context->x86_body = &symbol->body;
-    x86_function_create(x64_context->x86_body, x64_context->body);
+    x86_function_create(
+        x64_context->x86_body, x64_context->body, &x64_context->arena);
 }
 
 void x86_context_leave_function(x86_Context *x64_context) {
@@ -20,17 +20,13 @@
 
 #include "codegen/x86/imr/allocation.h"
 #include "codegen/x86/imr/location.h"
-#include "support/allocation.h"
 
-x86_Allocation *x86_allocation_allocate() {
-    x86_Allocation *allocation = callocate(1, sizeof(x86_Allocation));
+x86_Allocation *x86_allocation_allocate(Arena *restrict arena) {
+    x86_Allocation *allocation = arena_callocate(
+        arena, sizeof(x86_Allocation), alignof(x86_Allocation));
     return allocation;
 }
 
-void x86_allocation_deallocate(x86_Allocation *restrict allocation) {
-    deallocate(allocation);
-}
-
 bool x86_allocation_location_eq(x86_Allocation *restrict allocation,
                                 x86_Location location) {
     return x86_location_eq(location, allocation->location);
@@ -28,8 +28,10 @@
 #include "support/unreachable.h"
 
 static x86_GPRP x86_gprp_create() {
-    x86_GPRP gprp = {.bitset = 0,
-                     .buffer = callocate(16, sizeof(x86_Allocation *))};
+    x86_GPRP gprp = {
+        .bitset = 0,
+        .buffer =
+            callocate_tagged("x86 allocator", 16, sizeof(x86_Allocation *))};
     return gprp;
 }
 
@@ -209,8 +211,8 @@ static void
 x86_stack_allocations_grow(x86_StackAllocations *restrict stack_allocations) {
     Growth_u64 g =
         array_growth_u64(stack_allocations->capacity, sizeof(x86_Allocation *));
-    stack_allocations->buffer =
-        reallocate(stack_allocations->buffer, g.alloc_size);
+    stack_allocations->buffer = reallocate_tagged(
+        "x86 allocator", stack_allocations->buffer, g.alloc_size);
     stack_allocations->capacity = g.new_capacity;
 }
 
@@ -289,10 +291,7 @@ static x86_AllocationBuffer x86_allocation_buffer_create() {
 static void x86_allocation_buffer_destroy(
     x86_AllocationBuffer *restrict allocation_buffer) {
     assert(allocation_buffer != NULL);
-    for (u64 i = 0; i < allocation_buffer->count; ++i) {
-        x86_allocation_deallocate(allocation_buffer->buffer[i]);
-    }
-
+    // the allocations themselves are freed with the arena.
     deallocate(allocation_buffer->buffer);
     allocation_buffer->buffer   = NULL;
     allocation_buffer->count    = 0;
@@ -308,13 +307,14 @@ static void
 x86_allocation_buffer_grow(x86_AllocationBuffer *restrict allocation_buffer) {
     Growth_u64 g =
         array_growth_u64(allocation_buffer->capacity, sizeof(x86_Allocation *));
-    allocation_buffer->buffer =
-        reallocate(allocation_buffer->buffer, g.alloc_size);
+    allocation_buffer->buffer = reallocate_tagged(
+        "x86 allocator", allocation_buffer->buffer, g.alloc_size);
     allocation_buffer->capacity = g.new_capacity;
 }
 
 static x86_Allocation *
 x86_allocation_buffer_append(x86_AllocationBuffer *restrict allocation_buffer,
+                             Arena *restrict arena,
                              Local *restrict local) {
     assert(allocation_buffer != NULL);
     assert(local != NULL);
@@ -326,18 +326,21 @@ x86_allocation_buffer_append(x86_AllocationBuffer *restrict allocation_buffer,
     x86_Allocation **allocation =
         allocation_buffer->buffer + allocation_buffer->count;
     allocation_buffer->count += 1;
-    *allocation             = x86_allocation_allocate();
+    *allocation             = x86_allocation_allocate(arena);
     (*allocation)->ssa      = local->ssa;
     (*allocation)->lifetime = local->lifetime;
     (*allocation)->type     = local->type;
     return *allocation;
 }
 
-void x86_allocator_create(x86_Allocator *restrict allocator) {
+void x86_allocator_create(x86_Allocator *restrict allocator,
+                          Arena *restrict arena) {
     exp_assert(allocator != NULL);
+    exp_assert(arena != NULL);
     allocator->gprp              = x86_gprp_create();
     allocator->stack_allocations = x86_stack_allocations_create();
     allocator->allocations       = x86_allocation_buffer_create();
+    allocator->arena             = arena;
     x86_gprp_aquire(&allocator->gprp, X86_GPR_RSP);
     x86_gprp_aquire(&allocator->gprp, X86_GPR_RBP);
 }
@@ -445,8 +448,8 @@ x86_Allocation *x86_allocator_allocate(x86_Allocator *restrict allocator,
                                        u64    Idx,
                                        Local *local,
                                        x86_Bytecode *restrict x64bc) {
-    x86_Allocation *allocation =
-        x86_allocation_buffer_append(&allocator->allocations, local);
+    x86_Allocation *allocation = x86_allocation_buffer_append(
+        &allocator->allocations, allocator->arena, local);
 
     if (string_view_empty(local->name) && type_is_scalar(local->type)) {
         x86_allocator_register_allocate(allocator, Idx, allocation, x64bc);
@@ -518,8 +521,8 @@ x86_Allocation *
 x86_allocator_allocate_to_any_gpr(x86_Allocator *restrict allocator,
                                   Local *local,
                                   x86_Bytecode *restrict x64bc) {
-    x86_Allocation *allocation =
-        x86_allocation_buffer_append(&allocator->allocations, local);
+    x86_Allocation *allocation = x86_allocation_buffer_append(
+        &allocator->allocations, allocator->arena, local);
 
     if (x86_gprp_allocate(&allocator->gprp, allocation)) { return allocation; }
 
@@ -533,8 +536,8 @@ x86_Allocation *x86_allocator_allocate_to_gpr(x86_Allocator *restrict allocator,
                                               x86_GPR gpr,
                                               u64     Idx,
                                               x86_Bytecode *restrict x64bc) {
-    x86_Allocation *allocation =
-        x86_allocation_buffer_append(&allocator->allocations, local);
+    x86_Allocation *allocation = x86_allocation_buffer_append(
+        &allocator->allocations, allocator->arena, local);
 
     x86_allocator_release_gpr(allocator, gpr, Idx, x64bc);
     x86_gprp_allocate_to_gpr(&allocator->gprp, gpr, allocation);
@@ -543,8 +546,8 @@ x86_Allocation *x86_allocator_allocate_to_gpr(x86_Allocator *restrict allocator,
 
 x86_Allocation *x86_allocator_allocate_to_stack(
     x86_Allocator *restrict allocator, i64 offset, Local *local) {
-    x86_Allocation *allocation =
-        x86_allocation_buffer_append(&allocator->allocations, local);
+    x86_Allocation *allocation = x86_allocation_buffer_append(
+        &allocator->allocations, allocator->arena, local);
 
     allocation->location = x86_location_address(X86_GPR_RBP, offset);
 
@@ -559,8 +562,8 @@ x86_Allocation *x86_allocator_allocate_result(x86_Allocator *restrict allocator,
         .ssa = u32_MAX, .lifetime = {0, u32_MAX},
              .type = type
     };
-    x86_Allocation *allocation =
-        x86_allocation_buffer_append(&allocator->allocations, &fake);
+    x86_Allocation *allocation = x86_allocation_buffer_append(
+        &allocator->allocations, allocator->arena, &fake);
 
     // The gpr allocator of this function does not actually want the
     // location marked as used, so that instructions within the function
@@ -95,3 +95,11 @@ void x86_bytecode_emit(x86_Bytecode *restrict bc,
         string_append(buffer, SV("\n"));
     }
 }
+
+void x86_bytecode_encode(x86_Bytecode *restrict bc,
+                         ELF_Object *restrict object,
+                         Context *restrict context) {
+    for (u64 i = 0; i < bc->length; ++i) {
+        x86_instruction_encode(bc->buffer[i], object, context);
+    }
+}
@@ -44,13 +44,14 @@ x86_formal_argument_list_at(x86_FormalArgumentList *restrict args, u8 idx) {
 }
 
 void x86_function_create(x86_Function *restrict x86_body,
-                         Function *restrict body) {
+                         Function *restrict body,
+                         Arena *restrict arena) {
     assert(x86_body != NULL);
     assert(body != NULL);
     x86_body->arguments = x86_formal_argument_list_create(body->arguments.size);
     x86_body->result    = NULL;
     x86_body->bc        = x86_bytecode_create();
-    x86_allocator_create(&x86_body->allocator);
+    x86_allocator_create(&x86_body->allocator, arena);
     x86_Allocator *allocator = &x86_body->allocator;
     x86_Bytecode  *bc        = &x86_body->bc;
 
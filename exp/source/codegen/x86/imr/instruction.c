@@ -17,10 +17,12 @@
  * along with exp.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <elf.h>
 #include <stddef.h>
 
 #include "codegen/x86/imr/instruction.h"
 #include "codegen/x86/imr/registers.h"
+#include "support/panic.h"
 #include "support/unreachable.h"
 
 static x86_Instruction x64_instruction(x86_Opcode opcode) {
@@ -246,3 +248,355 @@ void x86_instruction_emit(x86_Instruction I,
     default: EXP_UNREACHABLE();
     }
 }
+
+/*
+ * machine code encoding.
+ *
+ * this mirrors x86_instruction_emit, and it relies on the same
+ * simplification: every operand is a quad word. so every instruction
+ * which takes a size is encoded with REX.W, and every register is
+ * encoded as the 64 bit register of the same index.
+ */
+
+/*
+ * x86_GPR indices are laid out rAX, rBX, rCX, rDX, rSI, rDI, rBP, rSP,
+ * while the hardware numbers the registers rAX, rCX, rDX, rBX, rSP, rBP,
+ * rSI, rDI.
+ */
+static u8 const x86_gpr_encodings[16] = {
+    0, 3, 1, 2, 6, 7, 5, 4, 8, 9, 10, 11, 12, 13, 14, 15};
+
+#define X86_REX   0x40
+#define X86_REX_W 0x08
+#define X86_REX_R 0x04
+#define X86_REX_X 0x02
+#define X86_REX_B 0x01
+
+typedef struct x86_Encoding {
+    u8 length;
+    u8 bytes[15];
+} x86_Encoding;
+
+static void x86_encoding_byte(x86_Encoding *restrict encoding, u8 byte) {
+    assert(encoding->length < sizeof(encoding->bytes));
+    encoding->bytes[encoding->length++] = byte;
+}
+
+static void x86_encoding_i32(x86_Encoding *restrict encoding, i32 value) {
+    u32 bits = (u32)value;
+    for (u8 i = 0; i < 4; ++i) {
+        x86_encoding_byte(encoding, (u8)(bits >> (i * 8)));
+    }
+}
+
+static void x86_encoding_i64(x86_Encoding *restrict encoding, i64 value) {
+    u64 bits = (u64)value;
+    for (u8 i = 0; i < 8; ++i) {
+        x86_encoding_byte(encoding, (u8)(bits >> (i * 8)));
+    }
+}
+
+static u8 x86_gpr_encoding(x86_GPR gpr) {
+    return x86_gpr_encodings[x86_gpr_index(gpr)];
+}
+
+static i64 x86_operand_immediate_value(x86_Operand operand,
+                                       Context *restrict context) {
+    switch (operand.kind) {
+    case X86_OPERAND_KIND_IMMEDIATE: return operand.data.immediate;
+
+    case X86_OPERAND_KIND_CONSTANT: {
+        Value *constant = context_constants_at(context, operand.data.constant);
+        assert(constant->kind == VALUE_KIND_I64);
+        return constant->i64_;
+    }
+
+    default: EXP_UNREACHABLE();
+    }
+}
+
+static bool x86_operand_is_immediate(x86_Operand operand) {
+    return (operand.kind == X86_OPERAND_KIND_IMMEDIATE) ||
+           (operand.kind == X86_OPERAND_KIND_CONSTANT);
+}
+
+/**
+ * @brief encode the REX prefix for an instruction with a ModR/M byte.
+ *
+ * @note the prefix is omitted when it carries no information.
+ */
+static void x86_encode_rex(x86_Encoding *restrict encoding,
+                           u8          rex,
+                           u8          reg,
+                           x86_Operand rm) {
+    if (reg & 8) { rex |= X86_REX_R; }
+
+    switch (rm.kind) {
+    case X86_OPERAND_KIND_GPR: {
+        if (x86_gpr_encoding(rm.data.gpr) & 8) { rex |= X86_REX_B; }
+        break;
+    }
+
+    case X86_OPERAND_KIND_ADDRESS: {
+        x86_Address *address = &rm.data.address;
+        if (x86_gpr_encoding(address->base) & 8) { rex |= X86_REX_B; }
+        if (address->has_index && (x86_gpr_encoding(address->index) & 8)) {
+            rex |= X86_REX_X;
+        }
+        break;
+    }
+
+    default: EXP_UNREACHABLE();
+    }
+
+    if (rex != X86_REX) { x86_encoding_byte(encoding, rex); }
+}
+
+static u8 x86_scale_encoding(u8 scale) {
+    switch (scale) {
+    case 1:  return 0;
+    case 2:  return 1;
+    case 4:  return 2;
+    case 8:  return 3;
+    default: EXP_UNREACHABLE();
+    }
+}
+
+/**
+ * @brief encode the ModR/M byte, and any SIB byte and displacement,
+ * for the register (or opcode extension) <reg> and the operand <rm>
+ */
+static void
+x86_encode_modrm(x86_Encoding *restrict encoding, u8 reg, x86_Operand rm) {
+    reg = (u8)((reg & 7) << 3);
+
+    if (rm.kind == X86_OPERAND_KIND_GPR) {
+        u8 gpr = x86_gpr_encoding(rm.data.gpr) & 7;
+        x86_encoding_byte(encoding, (u8)(0xC0 | reg | gpr));
+        return;
+    }
+
+    assert(rm.kind == X86_OPERAND_KIND_ADDRESS);
+    x86_Address *address = &rm.data.address;
+    if (!i64_in_range_i32(address->offset)) {
+        PANIC("address offset does not fit in a 32 bit displacement");
+    }
+
+    u8 base = x86_gpr_encoding(address->base) & 7;
+    u8 mod  = 0x80;
+    // [rBP] and [r13] with mod 00 mean [rip + disp32], so they always
+    // need a displacement.
+    if ((address->offset == 0) && (base != 5)) {
+        mod = 0x00;
+    } else if (i64_in_range_i8(address->offset)) {
+        mod = 0x40;
+    }
+
+    // [rSP] and [r12] can only be encoded with a SIB byte.
+    if (address->has_index || (base == 4)) {
+        u8 index = 4; // no index
+        u8 scale = 0;
+        if (address->has_index) {
+            index = x86_gpr_encoding(address->index) & 7;
+            scale = x86_scale_encoding(address->scale);
+            assert(index != 4);
+        }
+        x86_encoding_byte(encoding, (u8)(mod | reg | 4));
+        x86_encoding_byte(encoding, (u8)((scale << 6) | (index << 3) | base));
+    } else {
+        x86_encoding_byte(encoding, (u8)(mod | reg | base));
+    }
+
+    if (mod == 0x40) {
+        x86_encoding_byte(encoding, (u8)(i8)address->offset);
+    } else if (mod == 0x80) {
+        x86_encoding_i32(encoding, (i32)address->offset);
+    }
+}
+
+/**
+ * @brief encode a quad word instruction of the form <opcode> /<reg> <rm>
+ */
+static void x86_encode_rm(x86_Encoding *restrict encoding,
+                          u8          opcode,
+                          u8          reg,
+                          x86_Operand rm) {
+    x86_encode_rex(encoding, X86_REX | X86_REX_W, reg, rm);
+    x86_encoding_byte(encoding, opcode);
+    x86_encode_modrm(encoding, reg, rm);
+}
+
+static void x86_encode_push_pop(x86_Encoding *restrict encoding,
+                                u8          opcode,
+                                u8          rm_opcode,
+                                u8          rm_extension,
+                                x86_Operand A) {
+    if (A.kind == X86_OPERAND_KIND_GPR) {
+        u8 gpr = x86_gpr_encoding(A.data.gpr);
+        if (gpr & 8) { x86_encoding_byte(encoding, X86_REX | X86_REX_B); }
+        x86_encoding_byte(encoding, (u8)(opcode + (gpr & 7)));
+        return;
+    }
+
+    // push and pop default to a quad word operand, so no REX.W
+    x86_encode_rex(encoding, X86_REX, rm_extension, A);
+    x86_encoding_byte(encoding, rm_opcode);
+    x86_encode_modrm(encoding, rm_extension, A);
+}
+
+/**
+ * @brief encode one of the two operand arithmetic instructions.
+ *
+ * @param rm_r the opcode of the r/m64, r64 form
+ * @param r_rm the opcode of the r64, r/m64 form
+ * @param extension the opcode extension of the r/m64, imm form
+ */
+static void x86_encode_arithmetic(x86_Encoding *restrict encoding,
+                                  u8              rm_r,
+                                  u8              r_rm,
+                                  u8              extension,
+                                  x86_Instruction I,
+                                  Context *restrict context) {
+    if (x86_operand_is_immediate(I.B)) {
+        i64 value = x86_operand_immediate_value(I.B, context);
+        if (i64_in_range_i8(value)) {
+            x86_encode_rm(encoding, 0x83, extension, I.A);
+            x86_encoding_byte(encoding, (u8)(i8)value);
+        } else if (i64_in_range_i32(value)) {
+            x86_encode_rm(encoding, 0x81, extension, I.A);
+            x86_encoding_i32(encoding, (i32)value);
+        } else {
+            PANIC("immediate does not fit in 32 bits");
+        }
+        return;
+    }
+
+    if (I.B.kind == X86_OPERAND_KIND_GPR) {
+        x86_encode_rm(encoding, rm_r, x86_gpr_encoding(I.B.data.gpr), I.A);
+        return;
+    }
+
+    assert(I.A.kind == X86_OPERAND_KIND_GPR);
+    x86_encode_rm(encoding, r_rm, x86_gpr_encoding(I.A.data.gpr), I.B);
+}
+
+static void x86_encode_mov(x86_Encoding *restrict encoding,
+                           x86_Instruction I,
+                           Context *restrict context) {
+    if (!x86_operand_is_immediate(I.B)) {
+        x86_encode_arithmetic(encoding, 0x89, 0x8B, 0, I, context);
+        return;
+    }
+
+    i64 value = x86_operand_immediate_value(I.B, context);
+    if (i64_in_range_i32(value)) {
+        x86_encode_rm(encoding, 0xC7, 0, I.A);
+        x86_encoding_i32(encoding, (i32)value);
+        return;
+    }
+
+    if (I.A.kind != X86_OPERAND_KIND_GPR) {
+        PANIC("cannot move a 64 bit immediate to memory");
+    }
+
+    u8 gpr = x86_gpr_encoding(I.A.data.gpr);
+    u8 rex = X86_REX | X86_REX_W;
+    if (gpr & 8) { rex |= X86_REX_B; }
+    x86_encoding_byte(encoding, rex);
+    x86_encoding_byte(encoding, (u8)(0xB8 + (gpr & 7)));
+    x86_encoding_i64(encoding, value);
+}
+
+void x86_instruction_encode(x86_Instruction I,
+                            ELF_Object *restrict object,
+                            Context *restrict context) {
+    x86_Encoding encoding = {.length = 0};
+
+    switch (I.opcode) {
+    case X64_OPCODE_RETURN: {
+        x86_encoding_byte(&encoding, 0xC3);
+        break;
+    }
+
+    case X64_OPCODE_CALL: {
+        assert(I.A.kind == X86_OPERAND_KIND_LABEL);
+        StringView name   = constant_string_to_view(I.A.data.label);
+        u32        symbol = elf_object_symbol(object, name);
+        // the displacement is relative to the end of the instruction,
+        // which is 4 bytes past the displacement itself.
+        elf_object_relocation(object,
+                              elf_object_text_offset(object) + 1,
+                              symbol,
+                              R_X86_64_PLT32,
+                              -4);
+        x86_encoding_byte(&encoding, 0xE8);
+        x86_encoding_i32(&encoding, 0);
+        break;
+    }
+
+    case X64_OPCODE_PUSH: {
+        if (x86_operand_is_immediate(I.A)) {
+            i64 value = x86_operand_immediate_value(I.A, context);
+            if (i64_in_range_i8(value)) {
+                x86_encoding_byte(&encoding, 0x6A);
+                x86_encoding_byte(&encoding, (u8)(i8)value);
+            } else if (i64_in_range_i32(value)) {
+                x86_encoding_byte(&encoding, 0x68);
+                x86_encoding_i32(&encoding, (i32)value);
+            } else {
+                PANIC("immediate does not fit in 32 bits");
+            }
+            break;
+        }
+
+        x86_encode_push_pop(&encoding, 0x50, 0xFF, 6, I.A);
+        break;
+    }
+
+    case X64_OPCODE_POP: {
+        x86_encode_push_pop(&encoding, 0x58, 0x8F, 0, I.A);
+        break;
+    }
+
+    case X64_OPCODE_MOV: {
+        x86_encode_mov(&encoding, I, context);
+        break;
+    }
+
+    case X64_OPCODE_LEA: {
+        assert(I.A.kind == X86_OPERAND_KIND_GPR);
+        assert(I.B.kind == X86_OPERAND_KIND_ADDRESS);
+        x86_encode_rm(&encoding, 0x8D, x86_gpr_encoding(I.A.data.gpr), I.B);
+        break;
+    }
+
+    case X64_OPCODE_NEG: {
+        x86_encode_rm(&encoding, 0xF7, 3, I.A);
+        break;
+    }
+
+    case X64_OPCODE_ADD: {
+        x86_encode_arithmetic(&encoding, 0x01, 0x03, 0, I, context);
+        break;
+    }
+
+    case X64_OPCODE_SUB: {
+        x86_encode_arithmetic(&encoding, 0x29, 0x2B, 5, I, context);
+        break;
+    }
+
+    case X64_OPCODE_IMUL: {
+        x86_encode_rm(&encoding, 0xF7, 5, I.A);
+        break;
+    }
+
+    case X64_OPCODE_IDIV: {
+        x86_encode_rm(&encoding, 0xF7, 7, I.A);
+        break;
+    }
+
+    default: EXP_UNREACHABLE();
+    }
+
+    elf_object_append_text(object, encoding.bytes, encoding.length);
+}
@@ -85,7 +85,7 @@ static void x86_codegen_add_ssa(Instruction  I,
 
         x86_context_append(context,
                            x86_add(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
@@ -116,7 +116,7 @@ static void x86_codegen_add_immediate(Instruction  I,
 
         x86_context_append(context,
                            x86_add(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         break;
     }
 
@@ -124,10 +124,10 @@ static void x86_codegen_add_immediate(Instruction  I,
         x86_Allocation *A = x86_context_allocate(context, local, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context,
                            x86_add(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
@@ -139,7 +139,7 @@ static void x86_codegen_add_immediate(Instruction  I,
 
         x86_context_append(context,
                            x86_add(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
@@ -172,7 +172,7 @@ static void x86_codegen_add_constant(Instruction  I,
 
         x86_context_append(context,
                            x86_add(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
@@ -142,9 +142,10 @@ void x86_codegen_call(Instruction I,
         }
     }
 
+    ConstantString *label =
+        x86_context_global_labels_at(context, I.B_data.label);
     if (stack_args.size == 0) {
-        x86_context_append(context,
-                           x86_call(x86_operand_label(I.B_data.label)));
+        x86_context_append(context, x86_call(x86_operand_label(label)));
         return;
     }
 
@@ -168,7 +169,7 @@ void x86_codegen_call(Instruction I,
     x86_codegen_allocate_stack_space_for_arguments(
         context, stack_space, call_start);
 
-    x86_context_append(context, x86_call(x86_operand_label(I.B_data.label)));
+    x86_context_append(context, x86_call(x86_operand_label(label)));
 
     x86_codegen_deallocate_stack_space_for_arguments(context, stack_space);
 
@@ -118,7 +118,7 @@ static void x86_codegen_divide_ssa(Instruction  I,
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
 
         x86_context_append(context, x86_idiv(x86_operand_gpr(gpr)));
 
@@ -174,7 +174,7 @@ static void x86_codegen_divide_immediate(Instruction  I,
 
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context, x86_idiv(x86_operand_alloc(C)));
 
         x86_context_release_gpr(context, X86_GPR_RDX, block_index);
@@ -191,12 +191,12 @@ static void x86_codegen_divide_immediate(Instruction  I,
             context, local, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
 
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
 
         x86_context_append(context, x86_idiv(x86_operand_gpr(gpr)));
 
@@ -214,7 +214,7 @@ static void x86_codegen_divide_immediate(Instruction  I,
             context, local, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
 
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
@@ -274,7 +274,7 @@ void x86_codegen_divide_constant(Instruction  I,
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
 
         x86_context_append(context, x86_idiv(x86_operand_gpr(gpr)));
 
@@ -32,8 +32,8 @@ void x86_codegen_dot(Instruction I,
     Local *local = x86_context_lookup_ssa(context, I.A_data.ssa);
 
     assert(I.C_kind == OPERAND_KIND_I64);
-    assert(I.C_data.i64_ >= 0);
-    u16 index = (u16)I.C_data.i64_;
+    assert(I.C_data.i32_ >= 0);
+    u16 index = (u16)I.C_data.i32_;
 
     switch (I.B_kind) {
     case OPERAND_KIND_SSA: {
@@ -46,7 +46,7 @@ void x86_codegen_let(Instruction I,
         x86_Allocation *A = x86_context_allocate(context, local, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         break;
     }
 
@@ -52,6 +52,9 @@ static void x86_codegen_modulus_ssa(Instruction  I,
             x86_context_append(
                 context,
                 x86_mov(x86_operand_gpr(X86_GPR_RAX), x86_operand_alloc(B)));
+            x86_context_append(context,
+                               x86_mov(x86_operand_gpr(X86_GPR_RDX),
+                                       x86_operand_immediate(0)));
 
             x86_context_append(context, x86_idiv(x86_operand_alloc(C)));
             break;
@@ -62,6 +65,9 @@ static void x86_codegen_modulus_ssa(Instruction  I,
         x86_context_append(
             context,
             x86_mov(x86_operand_gpr(X86_GPR_RAX), x86_operand_alloc(B)));
+        x86_context_append(
+            context,
+            x86_mov(x86_operand_gpr(X86_GPR_RDX), x86_operand_immediate(0)));
 
         x86_context_append(context, x86_idiv(x86_operand_alloc(C)));
         break;
@@ -77,8 +83,11 @@ static void x86_codegen_modulus_ssa(Instruction  I,
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
 
+        x86_context_append(
+            context,
+            x86_mov(x86_operand_gpr(X86_GPR_RDX), x86_operand_immediate(0)));
         x86_context_append(context, x86_idiv(x86_operand_gpr(gpr)));
         break;
     }
@@ -95,6 +104,9 @@ static void x86_codegen_modulus_ssa(Instruction  I,
                            x86_mov(x86_operand_gpr(gpr),
                                    x86_operand_constant(I.C_data.constant)));
 
+        x86_context_append(
+            context,
+            x86_mov(x86_operand_gpr(X86_GPR_RDX), x86_operand_immediate(0)));
         x86_context_append(context, x86_idiv(x86_operand_gpr(gpr)));
         break;
     }
@@ -122,7 +134,7 @@ static void x86_codegen_modulus_immediate(Instruction  I,
 
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context, x86_idiv(x86_operand_alloc(C)));
         break;
     }
@@ -136,12 +148,12 @@ static void x86_codegen_modulus_immediate(Instruction  I,
         x86_context_aquire_gpr(context, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
 
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
 
         x86_context_append(context, x86_idiv(x86_operand_gpr(gpr)));
         x86_context_release_gpr(context, gpr, block_index);
@@ -157,7 +169,7 @@ static void x86_codegen_modulus_immediate(Instruction  I,
         x86_context_aquire_gpr(context, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
 
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
@@ -206,7 +218,7 @@ void x86_codegen_modulus_constant(Instruction  I,
         x86_context_aquire_gpr(context, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
 
         x86_GPR gpr = x86_context_aquire_any_gpr(context, 8, block_index);
         x86_context_append(context,
@@ -81,7 +81,7 @@ static void x86_codegen_multiply_ssa(Instruction  I,
             x86_context_release_gpr(context, X86_GPR_RDX, block_index);
             x86_context_append(context,
                                x86_mov(x86_operand_gpr(X86_GPR_RDX),
-                                       x86_operand_immediate(I.C_data.i64_)));
+                                       x86_operand_immediate(I.C_data.i32_)));
             x86_context_append(context, x86_imul(x86_operand_gpr(X86_GPR_RDX)));
             break;
         }
@@ -89,7 +89,7 @@ static void x86_codegen_multiply_ssa(Instruction  I,
         x86_context_allocate_to_gpr(context, local, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         x86_context_append(context, x86_imul(x86_operand_alloc(B)));
         break;
     }
@@ -133,7 +133,7 @@ static void x86_codegen_multiply_immediate(Instruction  I,
             x86_context_release_gpr(context, X86_GPR_RDX, block_index);
             x86_context_append(context,
                                x86_mov(x86_operand_gpr(X86_GPR_RDX),
-                                       x86_operand_immediate(I.B_data.i64_)));
+                                       x86_operand_immediate(I.B_data.i32_)));
             x86_context_append(context, x86_imul(x86_operand_gpr(X86_GPR_RDX)));
             break;
         }
@@ -141,7 +141,7 @@ static void x86_codegen_multiply_immediate(Instruction  I,
         x86_context_allocate_to_gpr(context, local, X86_GPR_RAX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RAX),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context, x86_imul(x86_operand_alloc(C)));
         break;
     }
@@ -152,10 +152,10 @@ static void x86_codegen_multiply_immediate(Instruction  I,
         x86_context_release_gpr(context, X86_GPR_RDX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RDX),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         x86_context_append(context, x86_imul(x86_operand_gpr(X86_GPR_RDX)));
         break;
     }
@@ -166,7 +166,7 @@ static void x86_codegen_multiply_immediate(Instruction  I,
         x86_context_release_gpr(context, X86_GPR_RDX, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RDX),
                                    x86_operand_constant(I.C_data.constant)));
@@ -216,7 +216,7 @@ void x86_codegen_multiply_constant(Instruction  I,
                                    x86_operand_constant(I.B_data.constant)));
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(X86_GPR_RDX),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         x86_context_append(context, x86_imul(x86_operand_gpr(X86_GPR_RDX)));
         break;
     }
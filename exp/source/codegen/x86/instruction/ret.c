@@ -48,7 +48,7 @@ void x86_codegen_ret(Instruction I,
     case OPERAND_KIND_I64: {
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(body->result),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         break;
     }
 
@@ -59,7 +59,7 @@ static void x86_codegen_subtract_ssa(Instruction  I,
 
         x86_context_append(context,
                            x86_sub(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
@@ -97,7 +97,7 @@ static void x86_codegen_subtract_immediate(Instruction  I,
         x86_GPR gpr = A->location.gpr;
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
 
         x86_context_append(context,
                            x86_sub(x86_operand_alloc(A), x86_operand_alloc(C)));
@@ -108,10 +108,10 @@ static void x86_codegen_subtract_immediate(Instruction  I,
         x86_Allocation *A = x86_context_allocate(context, local, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context,
                            x86_sub(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
@@ -119,7 +119,7 @@ static void x86_codegen_subtract_immediate(Instruction  I,
         x86_Allocation *A = x86_context_allocate(context, local, block_index);
         x86_context_append(context,
                            x86_mov(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.B_data.i64_)));
+                                   x86_operand_immediate(I.B_data.i32_)));
         x86_context_append(context,
                            x86_sub(x86_operand_alloc(A),
                                    x86_operand_constant(I.C_data.constant)));
@@ -164,7 +164,7 @@ void x86_codegen_subtract_constant(Instruction  I,
                                    x86_operand_constant(I.B_data.constant)));
         x86_context_append(context,
                            x86_sub(x86_operand_alloc(A),
-                                   x86_operand_immediate(I.C_data.i64_)));
+                                   x86_operand_immediate(I.C_data.i32_)));
         break;
     }
 
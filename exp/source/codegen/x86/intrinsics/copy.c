@@ -21,6 +21,7 @@
 #include "codegen/x86/imr/location.h"
 #include "codegen/x86/imr/registers.h"
 #include "codegen/x86/intrinsics/copy.h"
+#include "codegen/x86/intrinsics/get_element_address.h"
 #include "imr/type.h"
 #include "intrinsics/size_of.h"
 #include "support/assert.h"
@@ -50,11 +51,11 @@ void x86_codegen_copy_composite_memory(x86_Address *restrict dst,
     assert(type->kind == TYPE_KIND_TUPLE);
     TupleType const *tuple_type = &type->tuple_type;
 
-    x86_Address dst_element_address = *dst;
-    x86_Address src_element_address = *src;
     for (u64 i = 0; i < tuple_type->size; ++i) {
-        Type const *element_type = tuple_type->types[i];
-        u64         element_size = size_of(element_type);
+        Type const *element_type        = tuple_type->types[i];
+        u64         element_size        = size_of(element_type);
+        x86_Address dst_element_address = x86_get_element_address(dst, type, i);
+        x86_Address src_element_address = x86_get_element_address(src, type, i);
 
         if (type_is_scalar(element_type)) {
             x86_codegen_copy_scalar_memory(&dst_element_address,
@@ -69,11 +70,6 @@ void x86_codegen_copy_composite_memory(x86_Address *restrict dst,
                                               Idx,
                                               context);
         }
-
-        assert(element_size <= i64_MAX);
-        i64 offset = (i64)element_size;
-        dst_element_address.offset += offset;
-        src_element_address.offset += offset;
     }
 }
 
@@ -29,18 +29,10 @@ x86_get_element_address(x86_Address *src, Type const *type, u64 index) {
 
     switch (type->kind) {
     case TYPE_KIND_TUPLE: {
-        TupleType const *tuple = &type->tuple_type;
-        assert(index < tuple->size);
-
-        for (u64 i = 0; i < index; ++i) {
-            Type const *element_type = tuple->types[i];
-            u64         element_size = size_of(element_type);
-            assert(element_size <= i64_MAX);
-            i64 offset = (i64)element_size;
-
-            result.offset += offset;
-        }
-
+        assert(index < type->tuple_type.size);
+        u64 offset = offset_of(type, index);
+        assert(offset <= i64_MAX);
+        result.offset += (i64)offset;
         break;
     }
 
@@ -20,6 +20,7 @@
 #include <stddef.h>
 
 #include "codegen/x86/intrinsics/copy.h"
+#include "codegen/x86/intrinsics/get_element_address.h"
 #include "codegen/x86/intrinsics/load.h"
 #include "intrinsics/size_of.h"
 #include "intrinsics/type_of.h"
@@ -104,7 +105,7 @@ x86_codegen_load_address_from_scalar_operand(x86_Address *restrict dst,
     case OPERAND_KIND_I64: {
         x86_context_append(context,
                            x86_mov(x86_operand_address(*dst),
-                                   x86_operand_immediate(src.data.i64_)));
+                                   x86_operand_immediate(src.data.i32_)));
         break;
     }
 
@@ -147,22 +148,17 @@ x86_codegen_load_address_from_composite_operand(x86_Address *restrict dst,
         Type const *type  = type_of_value(value, context->context);
         assert(value->kind == VALUE_KIND_TUPLE);
         assert(!type_is_scalar(type));
-        (void)type;
         Tuple *tuple = &value->tuple;
 
-        x86_Address dst_element_address = *dst;
         for (u64 i = 0; i < tuple->size; ++i) {
             Operand     element = tuple->elements[i];
             Type const *element_type =
                 type_of_operand(element, context->context);
-            u64 element_size = size_of(element_type);
+            x86_Address dst_element_address =
+                x86_get_element_address(dst, type, i);
 
             x86_codegen_load_address_from_operand(
                 &dst_element_address, element, element_type, Idx, context);
-
-            assert(element_size <= i64_MAX);
-            i64 offset = (i64)element_size;
-            dst_element_address.offset += offset;
         }
 
         break;
@@ -219,7 +215,7 @@ x86_codegen_load_argument_from_scalar_operand(x86_Address *restrict dst,
     case OPERAND_KIND_I64: {
         x86_context_append(context,
                            x86_mov(x86_operand_address(*dst),
-                                   x86_operand_immediate(src.data.i64_)));
+                                   x86_operand_immediate(src.data.i32_)));
         break;
     }
 
@@ -327,7 +323,7 @@ void x86_codegen_load_gpr_from_operand(x86_GPR              gpr,
     case OPERAND_KIND_I64: {
         x86_context_append(context,
                            x86_mov(x86_operand_gpr(gpr),
-                                   x86_operand_immediate(src.data.i64_)));
+                                   x86_operand_immediate(src.data.i32_)));
         break;
     }
 
@@ -377,18 +373,14 @@ static void x86_codegen_load_allocation_from_tuple(x86_Allocation *dst,
                                                    u64             Idx,
                                                    x86_Context    *context) {
     assert(dst->location.kind == X86_LOCATION_ADDRESS);
-    x86_Address dst_address = dst->location.address;
     for (u64 i = 0; i < tuple->size; ++i) {
         Operand     element      = tuple->elements[i];
         Type const *element_type = type_of_operand(element, context->context);
-        u64         element_size = size_of(element_type);
+        x86_Address dst_address =
+            x86_get_element_address(&dst->location.address, dst->type, i);
 
         x86_codegen_load_address_from_operand(
             &dst_address, element, element_type, Idx, context);
-
-        assert(element_size <= i64_MAX);
-        i64 offset = (i64)element_size;
-        dst_address.offset += offset;
     }
 }
 
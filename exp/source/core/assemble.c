@@ -23,6 +23,12 @@
 #include "support/process.h"
 
 i32 assemble(Context *restrict context) {
+    Process as;
+    assemble_spawn(context, &as);
+    return process_await(&as);
+}
+
+void assemble_spawn(Context *restrict context, Process *restrict as) {
     StringView asm_path = context_assembly_path(context);
     StringView obj_path = context_object_path(context);
 
@@ -34,5 +40,19 @@ i32 assemble(Context *restrict context) {
         NULL,
     };
 
-    return process("as", 4, args);
+    process_spawn(as, "as", 4, args);
+}
+
+i32 assemble_buffer(Context *restrict context, StringView assembly) {
+    StringView obj_path = context_object_path(context);
+
+    // as(1) reads its input from stdin when given no input file.
+    char const *args[] = {
+        "as",
+        "-o",
+        obj_path.ptr,
+        NULL,
+    };
+
+    return process_piped("as", 3, args, assembly, NULL);
 }
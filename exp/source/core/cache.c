@@ -0,0 +1,279 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "core/cache.h"
+#include "support/config.h"
+#include "support/hash.h"
+#include "support/io.h"
+#include "support/panic.h"
+
+#if defined(EXP_HOST_SYSTEM_LINUX)
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief an artifact which outlives compilation, and so is cached.
+ */
+typedef struct CacheArtifact {
+    StringView extension;
+    StringView path;
+    bool       executable;
+} CacheArtifact;
+
+#define CACHE_ARTIFACTS_MAX 4
+
+static u64 cache_artifacts(Context *restrict context,
+                           CacheArtifact artifacts[CACHE_ARTIFACTS_MAX]) {
+    u64 count = 0;
+    if (context_shall_create_ir_artifact(context) &&
+        !context_shall_cleanup_ir_artifact(context)) {
+        artifacts[count++] =
+            (CacheArtifact){SV("ir"), context_ir_path(context), false};
+    }
+
+    if (context_shall_create_assembly_artifact(context) &&
+        !context_shall_cleanup_assembly_artifact(context)) {
+        artifacts[count++] =
+            (CacheArtifact){SV("s"), context_assembly_path(context), false};
+    }
+
+    if (context_shall_create_object_artifact(context) &&
+        !context_shall_cleanup_object_artifact(context)) {
+        artifacts[count++] =
+            (CacheArtifact){SV("o"), context_object_path(context), false};
+    }
+
+    if (context_shall_create_executable_artifact(context)) {
+        artifacts[count++] = (CacheArtifact){
+            SV("exe"), context_executable_path(context), true};
+    }
+
+    return count;
+}
+
+static bool cache_file_exists(StringView path) {
+    return access(path.ptr, F_OK) == 0;
+}
+
+static String cache_read_file(StringView path) {
+    FILE  *file  = file_open(path.ptr, "r");
+    String bytes = string_from_file(file);
+    file_close(file);
+    return bytes;
+}
+
+static u64 cache_hash_file(u64 hash, StringView path) {
+    MappedFile mapped;
+    file_map(&mapped, path.ptr);
+    hash = hash_fnv1a(hash, mapped.contents, mapped.length);
+    file_unmap(&mapped);
+    return hash;
+}
+
+/**
+ * @brief copy <from> to <to>, by way of a temporary file, so that
+ * a reader never observes a partially written artifact.
+ */
+static void cache_copy_file(StringView from, StringView to, bool executable) {
+    String bytes = cache_read_file(from);
+
+    String temporary = string_create();
+    string_assign(&temporary, to);
+    string_append(&temporary, SV(".tmp"));
+    string_append_u64(&temporary, (u64)getpid());
+
+    FILE *file = file_open(string_to_cstring(&temporary), "w");
+    file_write(string_to_view(&bytes), file);
+    file_close(file);
+
+    if (executable && (chmod(string_to_cstring(&temporary), 0755) != 0)) {
+        PANIC_ERRNO("chmod failed");
+    }
+
+    if (rename(string_to_cstring(&temporary), to.ptr) != 0) {
+        PANIC_ERRNO("rename failed");
+    }
+
+    string_destroy(&temporary);
+    string_destroy(&bytes);
+}
+
+static void cache_entry_path(Cache const *restrict cache,
+                             StringView key,
+                             StringView extension,
+                             String *restrict path) {
+    string_assign(path, string_to_view(&cache->directory));
+    string_append(path, SV("/"));
+    string_append(path, key);
+    string_append(path, SV("."));
+    string_append(path, extension);
+}
+
+static void cache_make_directories(StringView path) {
+    String prefix = string_create();
+    for (u64 index = 1; index <= path.length; ++index) {
+        if ((index != path.length) && (path.ptr[index] != '/')) { continue; }
+
+        string_assign(&prefix, string_view(path.ptr, index));
+        if ((mkdir(string_to_cstring(&prefix), 0755) != 0) &&
+            (errno != EEXIST)) {
+            PANIC_ERRNO("mkdir failed");
+        }
+    }
+    string_destroy(&prefix);
+}
+
+static void cache_directory(String *restrict directory) {
+    char const *path = getenv("EXP_CACHE_DIR");
+    if (path != nullptr) {
+        string_assign(directory, string_view_from_cstring(path));
+        return;
+    }
+
+    path = getenv("XDG_CACHE_HOME");
+    if (path != nullptr) {
+        string_assign(directory, string_view_from_cstring(path));
+        string_append(directory, SV("/exp"));
+        return;
+    }
+
+    path = getenv("HOME");
+    if (path == nullptr) { path = "/tmp"; }
+    string_assign(directory, string_view_from_cstring(path));
+    string_append(directory, SV("/.cache/exp"));
+}
+
+void cache_create(Cache *restrict cache) {
+    assert(cache != nullptr);
+    cache->directory = string_create();
+    cache_directory(&cache->directory);
+    cache_make_directories(string_to_view(&cache->directory));
+
+    // the parts of the key shared by every context.
+    StringView version = SV(EXP_VERSION_STRING);
+    StringView start_path =
+        SV(EXP_LIBEXP_RUNTIME_BINARY_DIR "/libexp_runtime_start.a");
+    StringView runtime_path =
+        SV(EXP_LIBEXP_RUNTIME_BINARY_DIR "/libexp_runtime.a");
+    u64 seed = HASH_FNV1A_OFFSET_BASIS;
+    seed     = hash_fnv1a(seed, version.ptr, version.length);
+    seed     = cache_hash_file(seed, start_path);
+    seed     = cache_hash_file(seed, runtime_path);
+    cache->seed = seed;
+    function_cache_create(
+        &cache->functions, string_to_view(&cache->directory), seed);
+}
+
+void cache_destroy(Cache *restrict cache) {
+    assert(cache != nullptr);
+    function_cache_destroy(&cache->functions);
+    string_destroy(&cache->directory);
+}
+
+static u32 cache_options(ContextOptions const *restrict options) {
+    // only the options which change the artifacts, each in a fixed bit.
+    u32 bits = 0;
+    bits |= (u32)options->create_ir_artifact << 0;
+    bits |= (u32)options->create_assembly_artifact << 1;
+    bits |= (u32)options->create_object_artifact << 2;
+    bits |= (u32)options->create_executable_artifact << 3;
+    bits |= (u32)options->create_library_artifact << 4;
+    bits |= (u32)options->cleanup_ir_artifact << 5;
+    bits |= (u32)options->cleanup_assembly_artifact << 6;
+    bits |= (u32)options->cleanup_object_artifact << 7;
+    bits |= (u32)options->encode_object_artifact << 8;
+    bits |= (u32)options->builtin_link_artifact << 9;
+    return bits;
+}
+
+static void cache_key(Cache const *restrict cache,
+                      Context *restrict context,
+                      String *restrict key) {
+    u64        hash    = cache->seed;
+    u32        options = cache_options(&context->options);
+    StringView source  = context_source_path(context);
+    hash               = hash_fnv1a(hash, &options, sizeof(options));
+    // the source path is recorded within the artifacts
+    hash = hash_fnv1a(hash, &source.length, sizeof(source.length));
+    hash = hash_fnv1a(hash, source.ptr, source.length);
+    hash = cache_hash_file(hash, source);
+
+    static char const digits[] = "0123456789abcdef";
+    char              hex[16];
+    for (u64 index = 0; index < sizeof(hex); ++index) {
+        hex[index] = digits[(hash >> (60 - (index * 4))) & 0xF];
+    }
+    string_assign(key, string_view(hex, sizeof(hex)));
+}
+
+bool cache_retrieve(Cache const *restrict cache,
+                    Context *restrict context,
+                    String *restrict key) {
+    assert(cache != nullptr);
+    assert(context != nullptr);
+    assert(key != nullptr);
+    cache_key(cache, context, key);
+
+    CacheArtifact artifacts[CACHE_ARTIFACTS_MAX];
+    u64           count = cache_artifacts(context, artifacts);
+    String        entry = string_create();
+
+    bool hit = count > 0;
+    for (u64 index = 0; hit && (index < count); ++index) {
+        cache_entry_path(
+            cache, string_to_view(key), artifacts[index].extension, &entry);
+        hit = cache_file_exists(string_to_view(&entry));
+    }
+
+    for (u64 index = 0; hit && (index < count); ++index) {
+        CacheArtifact *artifact = artifacts + index;
+        cache_entry_path(
+            cache, string_to_view(key), artifact->extension, &entry);
+        cache_copy_file(
+            string_to_view(&entry), artifact->path, artifact->executable);
+    }
+
+    string_destroy(&entry);
+    return hit;
+}
+
+void cache_store(Cache const *restrict cache,
+                 Context *restrict context,
+                 StringView key) {
+    assert(cache != nullptr);
+    assert(context != nullptr);
+    CacheArtifact artifacts[CACHE_ARTIFACTS_MAX];
+    u64           count = cache_artifacts(context, artifacts);
+    String        entry = string_create();
+
+    for (u64 index = 0; index < count; ++index) {
+        CacheArtifact *artifact = artifacts + index;
+        cache_entry_path(cache, key, artifact->extension, &entry);
+        cache_copy_file(artifact->path, string_to_view(&entry), false);
+    }
+
+    string_destroy(&entry);
+}
+
+#else
+#error "unsupported host OS"
+#endif
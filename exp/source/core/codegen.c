@@ -23,3 +23,17 @@
 i32 codegen_ir(Context *restrict context) { return ir_codegen(context); }
 
 i32 codegen_assembly(Context *restrict context) { return x86_codegen(context); }
+
+i32 codegen_assembly_buffer(Context *restrict context,
+                            String *restrict buffer) {
+    return x86_codegen_buffer(context, buffer);
+}
+
+i32 codegen_object(Context *restrict context) {
+    return x86_codegen_object(context);
+}
+
+i32 codegen_object_buffer(Context *restrict context,
+                          ELF_Object *restrict object) {
+    return x86_codegen_object_buffer(context, object);
+}
@@ -20,14 +20,18 @@
 
 #include "core/analyze.h"
 #include "core/assemble.h"
+#include "core/cache.h"
 #include "core/codegen.h"
 #include "core/compile.h"
 #include "core/link.h"
+#include "core/phase_times.h"
 #include "env/cli_options.h"
 #include "env/context.h"
 #include "scanning/parser.h"
+#include "support/allocation.h"
 #include "support/io.h"
 #include "support/message.h"
+#include "support/thread_pool.h"
 
 static void print_compile_actions(Context *restrict context) {
     if (context_shall_create_ir_artifact(context)) {
@@ -35,16 +39,35 @@ static void print_compile_actions(Context *restrict context) {
         trace(context_ir_path(context), stdout);
     }
 
-    if (context_shall_create_assembly_artifact(context)) {
+    bool encode_object   = context_shall_encode_object_artifact(context);
+    bool stream_assembly = context_shall_stream_assembly_artifact(context);
+    bool stream_object   = context_shall_stream_object_artifact(context);
+    if (context_shall_create_assembly_artifact(context) && !encode_object &&
+        !stream_assembly) {
         trace(SV("create assembly artifact:"), stdout);
         trace(context_assembly_path(context), stdout);
     }
 
-    if (context_shall_create_object_artifact(context)) {
+    if (stream_assembly) {
+        trace(SV("stream assembly artifact to as"), stdout);
+    }
+
+    if (context_shall_create_object_artifact(context) && !stream_object) {
         trace(SV("create object artifact:"), stdout);
         trace(context_object_path(context), stdout);
     }
 
+    if (stream_object) {
+        trace(SV("create object artifact in memory"), stdout);
+    }
+
+    if (encode_object) { trace(SV("encode object artifact"), stdout); }
+
+    if (context_shall_create_executable_artifact(context) &&
+        context_shall_builtin_link_artifact(context)) {
+        trace(SV("link executable artifact with builtin linker"), stdout);
+    }
+
     if (context_shall_create_executable_artifact(context)) {
         trace(SV("create executable artifact:"), stdout);
         trace(context_executable_path(context), stdout);
@@ -54,72 +77,480 @@ static void print_compile_actions(Context *restrict context) {
         trace(SV("cleanup ir artifact"), stdout);
     }
 
-    if (context_shall_cleanup_assembly_artifact(context)) {
+    if (context_shall_cleanup_assembly_artifact(context) && !encode_object &&
+        !stream_assembly) {
         trace(SV("cleanup assembly artifact"), stdout);
     }
 
-    if (context_shall_cleanup_object_artifact(context)) {
+    if (context_shall_cleanup_object_artifact(context) && !stream_object) {
         trace(SV("cleanup object artifact"), stdout);
     }
+
+    if (context_shall_cache_artifacts(context)) {
+        trace(SV("reuse artifacts from the build cache"), stdout);
+    }
+}
+
+/**
+ * @brief redirect the object artifact into a memory file, which
+ * as(1) and ld(1) can still open by path.
+ *
+ * @return the file descriptor of the memory file
+ */
+static i32 compile_object_memory_file(Context *restrict c) {
+    i32    fd   = memory_file_create("object");
+    String path = string_create();
+    string_append(&path, SV("/proc/self/fd/"));
+    string_append_u64(&path, (u64)fd);
+    context_assign_object_path(c, string_to_view(&path));
+    string_destroy(&path);
+    return fd;
+}
+
+/**
+ * @brief a single translation unit, as it moves through the
+ * stages of compilation.
+ *
+ * @note when the object is encoded directly there is no assembly
+ * artifact to create, assemble, or cleanup. when streaming, temporary
+ * artifacts never touch the filesystem, the assembly is piped to as(1)
+ * and the object lives in memory. a unit whose artifacts were found
+ * in the cache skips every stage.
+ */
+typedef struct CompileUnit {
+    Context      context;
+    i32          result;
+    bool         encode_object;
+    bool         stream_assembly;
+    bool         stream_object;
+    i32          object_fd;
+    bool         spawned;
+    Process      process;
+    Cache const *cache;
+    bool         cached;
+    String       cache_key;
+    bool         timed;
+    PhaseTimes   times;
+    Phase        spawned_phase;
+    TimerSample  spawned_at;
+} CompileUnit;
+
+static void compile_unit_create(CompileUnit *restrict unit,
+                                ContextOptions *restrict options,
+                                StringView   source,
+                                ContextPool *pool,
+                                Cache const *cache) {
+    Context *c = &unit->context;
+    context_create(c, options, source);
+    if (pool != nullptr) { context_pool_acquire(pool, c); }
+    unit->result          = EXIT_SUCCESS;
+    unit->encode_object   = context_shall_encode_object_artifact(c);
+    unit->stream_assembly = context_shall_stream_assembly_artifact(c);
+    unit->stream_object   = context_shall_stream_object_artifact(c);
+    unit->object_fd       = -1;
+    unit->spawned         = false;
+    unit->cache           = cache;
+    unit->cached          = false;
+    if (cache != nullptr) { c->function_cache = &cache->functions; }
+    unit->cache_key       = string_create();
+    unit->timed           = context_shall_report_phase_times(c);
+    phase_times_create(&unit->times);
+    if (unit->stream_object) {
+        unit->object_fd = compile_object_memory_file(c);
+    }
+}
+
+static void compile_unit_destroy(CompileUnit *restrict unit,
+                                 ContextPool *pool) {
+    Context *c = &unit->context;
+    if (context_shall_cleanup_assembly_artifact(c) && !unit->encode_object &&
+        !unit->stream_assembly && !unit->cached &&
+        (unit->result != EXIT_FAILURE)) {
+        StringView asm_path = context_assembly_path(c);
+        file_remove(asm_path.ptr);
+    }
+
+    if (unit->stream_object) {
+        memory_file_close(unit->object_fd);
+    } else if (context_shall_cleanup_object_artifact(c) && !unit->cached &&
+               (unit->result != EXIT_FAILURE)) {
+        StringView obj_path = context_object_path(c);
+        file_remove(obj_path.ptr);
+    }
+
+    if (pool != nullptr) { context_pool_release(pool, c); }
+    string_destroy(&unit->cache_key);
+    context_destroy(c);
+}
+
+/**
+ * @brief the point at which a phase of the unit starts, only sampled
+ * when the unit is timed.
+ */
+static TimerSample compile_unit_start(CompileUnit const *restrict unit) {
+    if (!unit->timed) { return (TimerSample){}; }
+    return timer_sample();
+}
+
+static void compile_unit_stop(CompileUnit *restrict unit,
+                              Phase       phase,
+                              TimerSample start) {
+    if (!unit->timed) { return; }
+    phase_times_record(&unit->times, phase, start);
+}
+
+static i32 compile_unit_front_end(CompileUnit *restrict unit) {
+    Context    *c      = &unit->context;
+    TimerSample start  = compile_unit_start(unit);
+    i32         result = parse_source(c);
+    compile_unit_stop(unit, PHASE_PARSE, start);
+    if (result == EXIT_FAILURE) { return EXIT_FAILURE; }
+
+    start  = compile_unit_start(unit);
+    result = analyze(c);
+    compile_unit_stop(unit, PHASE_ANALYZE, start);
+    if ((result != EXIT_FAILURE) && (c->function_cache != nullptr)) {
+        function_cache_store(c->function_cache, c);
+    }
+    return result;
+}
+
+static i32 compile_unit_stream_assembly(CompileUnit *restrict unit) {
+    Context    *c        = &unit->context;
+    String      assembly = string_create();
+    TimerSample start    = compile_unit_start(unit);
+    i32         result   = codegen_assembly_buffer(c, &assembly);
+    compile_unit_stop(unit, PHASE_CODEGEN, start);
+    if (result != EXIT_FAILURE) {
+        start = compile_unit_start(unit);
+        result |= assemble_buffer(c, string_to_view(&assembly));
+        compile_unit_stop(unit, PHASE_ASSEMBLE, start);
+    }
+    string_destroy(&assembly);
+    return result;
+}
+
+/**
+ * @brief parse, analyze and generate code for the unit, this runs on
+ * the thread pool, and touches nothing but the unit itself.
+ */
+static void compile_unit_generate(void *argument) {
+    CompileUnit *unit = argument;
+    Context     *c    = &unit->context;
+    if (unit->cache != nullptr) {
+        unit->cached = cache_retrieve(unit->cache, c, &unit->cache_key);
+        if (unit->cached) { return; }
+    }
+
+    i32 result = compile_unit_front_end(unit);
+
+    if ((result != EXIT_FAILURE) && context_shall_create_ir_artifact(c)) {
+        TimerSample start = compile_unit_start(unit);
+        result |= codegen_ir(c);
+        compile_unit_stop(unit, PHASE_IR, start);
+    }
+
+    if ((result != EXIT_FAILURE) && context_shall_create_assembly_artifact(c) &&
+        !unit->encode_object && !unit->stream_assembly) {
+        TimerSample start = compile_unit_start(unit);
+        result |= codegen_assembly(c);
+        compile_unit_stop(unit, PHASE_CODEGEN, start);
+    }
+
+    if ((result != EXIT_FAILURE) && unit->encode_object) {
+        TimerSample start = compile_unit_start(unit);
+        result |= codegen_object(c);
+        compile_unit_stop(unit, PHASE_CODEGEN, start);
+    } else if ((result != EXIT_FAILURE) && unit->stream_assembly) {
+        result |= compile_unit_stream_assembly(unit);
+    }
+
+    unit->result = result;
+}
+
+static void compile_unit_link(void *argument) {
+    CompileUnit *unit  = argument;
+    TimerSample  start = compile_unit_start(unit);
+    unit->result |= link(&unit->context);
+    compile_unit_stop(unit, PHASE_LINK, start);
+}
+
+static bool compile_unit_shall_assemble(CompileUnit const *restrict unit) {
+    return (unit->result != EXIT_FAILURE) && !unit->cached &&
+           context_shall_create_object_artifact(&unit->context) &&
+           !unit->encode_object && !unit->stream_assembly;
+}
+
+static bool compile_unit_shall_link(CompileUnit const *restrict unit) {
+    return (unit->result != EXIT_FAILURE) && !unit->cached &&
+           context_shall_create_executable_artifact(&unit->context);
+}
+
+static void compile_unit_cache(CompileUnit *restrict unit) {
+    if ((unit->cache == nullptr) || unit->cached ||
+        (unit->result != EXIT_SUCCESS)) {
+        return;
+    }
+
+    cache_store(unit->cache, &unit->context, string_to_view(&unit->cache_key));
+}
+
+static void print_cache_statistics(CompileUnit const *restrict units,
+                                   u64 count) {
+    u64 hits = 0;
+    for (u64 index = 0; index < count; ++index) {
+        if (units[index].cached) { ++hits; }
+    }
+
+    message(MESSAGE_STATUS, NULL, 0, SV("build cache"), stdout);
+    trace(SV("hits:"), stdout);
+    trace_u64(hits, stdout);
+    trace(SV("misses:"), stdout);
+    trace_u64(count - hits, stdout);
+}
+
+static void print_constants_statistics(CompileUnit const *restrict units,
+                                       u64 count) {
+    for (u64 index = 0; index < count; ++index) {
+        Constants const *constants = &units[index].context.constants;
+        String           heading   = string_create();
+        string_append(&heading, SV("constants: "));
+        string_append(&heading, context_source_path(&units[index].context));
+        message(MESSAGE_STATUS, NULL, 0, string_to_view(&heading), stdout);
+        string_destroy(&heading);
+        trace(SV("count:"), stdout);
+        trace_u64(constants->count, stdout);
+        trace(SV("hits:"), stdout);
+        trace_u64(constants->hits, stdout);
+        trace(SV("misses:"), stdout);
+        trace_u64(constants->misses, stdout);
+    }
 }
 
-static i32 compile_context(Context *restrict c) {
-    if (parse_source(c) == EXIT_FAILURE) { return EXIT_FAILURE; }
+static void print_time_report(CompileUnit const *restrict units,
+                              u64         count,
+                              TimerSample start) {
+    for (u64 index = 0; index < count; ++index) {
+        CompileUnit const *unit    = units + index;
+        String             heading = string_create();
+        string_append(&heading, SV("time report: "));
+        string_append(&heading, context_source_path(&unit->context));
+        if (unit->cached) { string_append(&heading, SV(" (cached)")); }
+        message(MESSAGE_STATUS, NULL, 0, string_to_view(&heading), stdout);
+        string_destroy(&heading);
+        phase_times_print(&unit->times, stdout);
+    }
+
+    trace(SV("wall time (us):"), stdout);
+    trace_u64(timer_elapsed(start, timer_sample()) / 1000, stdout);
+}
 
-    if (analyze(c) == EXIT_FAILURE) { return EXIT_FAILURE; }
+static void append_json_string(String *restrict json, StringView string) {
+    string_append(json, SV("\""));
+    for (u64 index = 0; index < string.length; ++index) {
+        char c = string.ptr[index];
+        if ((c == '"') || (c == '\\')) { string_append(json, SV("\\")); }
+        string_append(json, string_view(&c, 1));
+    }
+    string_append(json, SV("\""));
+}
 
-    return EXIT_SUCCESS;
+/**
+ * @brief print the time report as a single line of JSON, so that it
+ * can be collected by scripts.
+ */
+static void print_time_report_json(CompileUnit const *restrict units,
+                                   u64         count,
+                                   TimerSample start) {
+    TimerSample stop = timer_sample();
+    String      json = string_create();
+    string_append(&json, SV("{\"wall\":{\"nanoseconds\":"));
+    string_append_u64(&json, timer_elapsed(start, stop));
+    string_append(&json, SV(",\"resident_bytes\":"));
+    string_append_i64(&json, timer_resident_delta(start, stop));
+    string_append(&json, SV("},\"units\":["));
+    for (u64 index = 0; index < count; ++index) {
+        CompileUnit const *unit = units + index;
+        if (index != 0) { string_append(&json, SV(",")); }
+        string_append(&json, SV("{\"source\":"));
+        append_json_string(&json, context_source_path(&unit->context));
+        string_append(&json, SV(",\"cached\":"));
+        string_append(&json, unit->cached ? SV("true") : SV("false"));
+        string_append(&json, SV(",\"phases\":"));
+        phase_times_append_json(&unit->times, &json);
+        string_append(&json, SV("}"));
+    }
+    string_append(&json, SV("]}\n"));
+    file_write(string_to_view(&json), stdout);
+    string_destroy(&json);
+}
+
+static void compile_unit_spawned(CompileUnit *restrict unit,
+                                 Phase       phase,
+                                 TimerSample start) {
+    unit->spawned       = true;
+    unit->spawned_phase = phase;
+    unit->spawned_at    = start;
+}
+
+static void compile_unit_await(CompileUnit *restrict unit) {
+    if (!unit->spawned) { return; }
+    unit->result |= process_await(&unit->process);
+    unit->spawned = false;
+    compile_unit_stop(unit, unit->spawned_phase, unit->spawned_at);
 }
 
 i32 compile(i32 argc, char const *argv[]) {
-    CLIOptions cli_options;
+    return compile_with_pool(argc, argv, nullptr, nullptr);
+}
+
+static void append_artifact(String *restrict artifacts, StringView path) {
+    string_append(artifacts, path);
+    string_append(artifacts, SV("\n"));
+}
+
+static void compile_unit_artifacts(CompileUnit const *restrict unit,
+                                   String *restrict artifacts) {
+    Context const *c = &unit->context;
+    if (unit->result != EXIT_SUCCESS) { return; }
+
+    if (context_shall_create_ir_artifact(c) &&
+        !context_shall_cleanup_ir_artifact(c)) {
+        append_artifact(artifacts, context_ir_path(c));
+    }
+
+    if (context_shall_create_assembly_artifact(c) && !unit->encode_object &&
+        !unit->stream_assembly && !context_shall_cleanup_assembly_artifact(c)) {
+        append_artifact(artifacts, context_assembly_path(c));
+    }
+
+    if (context_shall_create_object_artifact(c) && !unit->stream_object &&
+        !context_shall_cleanup_object_artifact(c)) {
+        append_artifact(artifacts, context_object_path(c));
+    }
+
+    if (context_shall_create_executable_artifact(c)) {
+        append_artifact(artifacts, context_executable_path(c));
+    }
+}
+
+i32 compile_with_pool(i32 argc,
+                      char const *argv[],
+                      ContextPool *pool,
+                      String      *artifacts) {
+    TimerSample start = timer_sample();
+    CLIOptions  cli_options;
     cli_options_init(&cli_options);
-    Context context;
     parse_cli_options(argc, argv, &cli_options);
-    context_create(&context,
-                   &cli_options.context_options,
-                   string_to_view(&cli_options.source));
 
-    if (context_shall_prolix(&context)) {
+    Cache  cache;
+    Cache *cache_pointer = nullptr;
+    if (cli_options.context_options.cache_artifacts) {
+        cache_create(&cache);
+        cache_pointer = &cache;
+    }
+
+    CLISources  *sources = &cli_options.sources;
+    u64          count   = sources->count;
+    CompileUnit *units   = callocate(count, sizeof(CompileUnit));
+    for (u64 index = 0; index < count; ++index) {
+        compile_unit_create(units + index,
+                            &cli_options.context_options,
+                            string_to_view(sources->buffer + index),
+                            pool,
+                            cache_pointer);
+    }
+
+    if (cli_options.context_options.prolix) {
         message(MESSAGE_STATUS, NULL, 0, SV("prolix mode enabled"), stdout);
-        print_compile_actions(&context);
+        for (u64 index = 0; index < count; ++index) {
+            print_compile_actions(&units[index].context);
+        }
     }
 
-    i32 result = compile_context(&context);
+    // each unit is independent up to the point where it is written
+    // out, so the front end and code generation of every unit runs
+    // in parallel, one unit per worker.
+    u64 thread_count = thread_pool_hardware_concurrency();
+    if (thread_count > count) { thread_count = count; }
+    ThreadPool workers;
+    thread_pool_create(&workers, thread_count);
 
-    if ((result != EXIT_FAILURE) &&
-        context_shall_create_ir_artifact(&context)) {
-        result |= codegen_ir(&context);
+    for (u64 index = 0; index < count; ++index) {
+        thread_pool_submit(&workers, compile_unit_generate, units + index);
     }
+    thread_pool_wait(&workers);
 
-    if ((result != EXIT_FAILURE) &&
-        context_shall_create_assembly_artifact(&context)) {
-        result |= codegen_assembly(&context);
+    // every as(1) is started before any is awaited, so that they
+    // run alongside each other.
+    for (u64 index = 0; index < count; ++index) {
+        CompileUnit *unit = units + index;
+        if (!compile_unit_shall_assemble(unit)) { continue; }
+        TimerSample spawned_at = compile_unit_start(unit);
+        assemble_spawn(&unit->context, &unit->process);
+        compile_unit_spawned(unit, PHASE_ASSEMBLE, spawned_at);
     }
 
-    if ((result != EXIT_FAILURE) &&
-        context_shall_create_object_artifact(&context)) {
-        result |= assemble(&context);
+    for (u64 index = 0; index < count; ++index) {
+        compile_unit_await(units + index);
     }
 
-    if ((result != EXIT_FAILURE) &&
-        context_shall_create_executable_artifact(&context)) {
-        result |= link(&context);
+    // likewise for ld(1), while the builtin linker runs on the pool.
+    for (u64 index = 0; index < count; ++index) {
+        CompileUnit *unit = units + index;
+        if (!compile_unit_shall_link(unit)) { continue; }
+
+        if (context_shall_builtin_link_artifact(&unit->context)) {
+            thread_pool_submit(&workers, compile_unit_link, unit);
+        } else {
+            TimerSample spawned_at = compile_unit_start(unit);
+            link_spawn(&unit->context, &unit->process);
+            compile_unit_spawned(unit, PHASE_LINK, spawned_at);
+        }
     }
+    thread_pool_wait(&workers);
 
-    if (context_shall_cleanup_assembly_artifact(&context) &&
-        (result != EXIT_FAILURE)) {
-        StringView asm_path = context_assembly_path(&context);
-        file_remove(asm_path.ptr);
+    for (u64 index = 0; index < count; ++index) {
+        compile_unit_await(units + index);
     }
 
-    if (context_shall_cleanup_object_artifact(&context) &&
-        (result != EXIT_FAILURE)) {
-        StringView obj_path = context_object_path(&context);
-        file_remove(obj_path.ptr);
+    thread_pool_destroy(&workers);
+
+    if (cli_options.context_options.prolix) {
+        print_constants_statistics(units, count);
+    }
+
+    if (cache_pointer != nullptr) {
+        for (u64 index = 0; index < count; ++index) {
+            compile_unit_cache(units + index);
+        }
+
+        if (cli_options.context_options.prolix) {
+            print_cache_statistics(units, count);
+        }
     }
 
-    context_destroy(&context);
+    ContextOptions *options = &cli_options.context_options;
+    if (options->prolix || options->report_phase_times) {
+        print_time_report(units, count, start);
+    }
+
+    if (options->report_phase_times_json) {
+        print_time_report_json(units, count, start);
+    }
+
+    i32 result = EXIT_SUCCESS;
+    for (u64 index = 0; index < count; ++index) {
+        result |= units[index].result;
+        if (artifacts != nullptr) {
+            compile_unit_artifacts(units + index, artifacts);
+        }
+        compile_unit_destroy(units + index, pool);
+    }
+
+    if (cache_pointer != nullptr) { cache_destroy(cache_pointer); }
+
+    deallocate(units);
     cli_options_destroy(&cli_options);
     return result;
 }
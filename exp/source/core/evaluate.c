@@ -16,8 +16,526 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "core/evaluate.h"
+#include "support/allocation.h"
+#include "support/message.h"
+#include "support/unreachable.h"
 
-// #TODO:
-i32 evaluate() { return 0; }
+// the registers, and the frames, available to a program.
+#define EVALUATE_STACK_REGISTERS (1 << 20)
+#define EVALUATE_STACK_FRAMES    (1 << 16)
+
+/*
+ * the layout of the register file of a function, and the function
+ * called by each of its call instructions, computed once up front.
+ * local ssa occupies registers [offsets[ssa], offsets[ssa + 1]),
+ * and arithmetic writing to it wraps to the width of kinds[ssa].
+ */
+typedef struct EvaluateFunction {
+    Function const *body;
+    u32            *offsets;
+    TypeKind       *kinds;
+    u32            *callees;
+    u32             registers;
+} EvaluateFunction;
+
+typedef struct EvaluateFrame {
+    EvaluateFunction const *function;
+    Instruction const      *ip;
+    i64                    *registers;
+    i64                    *result;
+} EvaluateFrame;
+
+typedef struct Evaluator {
+    Context          *context;
+    u64               function_count;
+    EvaluateFunction *functions;
+    Symbol          **symbols;
+    i64              *stack;
+    u64               frame_count;
+    EvaluateFrame    *frames;
+} Evaluator;
+
+static i32 evaluate_error(StringView problem, StringView detail) {
+    String buffer = string_create();
+    string_append(&buffer, SV("evaluate: "));
+    string_append(&buffer, problem);
+    string_append(&buffer, detail);
+    message(MESSAGE_ERROR, NULL, 0, string_to_view(&buffer), stderr);
+    string_destroy(&buffer);
+    return EXIT_FAILURE;
+}
+
+static u32 evaluate_type_registers(Type const *type) {
+    if ((type == nullptr) || (type->kind != TYPE_KIND_TUPLE)) { return 1; }
+
+    u32 registers = 0;
+    for (u32 index = 0; index < type->tuple_type.size; ++index) {
+        registers += evaluate_type_registers(type->tuple_type.types[index]);
+    }
+    return registers;
+}
+
+static void evaluate_function_create(EvaluateFunction *restrict function,
+                                     Function const *restrict body) {
+    Locals const *locals = &body->locals;
+    function->body       = body;
+    function->offsets    = allocate((locals->count + 1) * sizeof(u32));
+    function->kinds      = allocate((locals->count + 1) * sizeof(TypeKind));
+    function->callees    = callocate(body->bc.length + 1, sizeof(u32));
+
+    u32 registers = 0;
+    for (u32 ssa = 0; ssa < locals->count; ++ssa) {
+        Type const *type       = locals->buffer[ssa]->type;
+        function->offsets[ssa] = registers;
+        function->kinds[ssa]   = (type == nullptr) ? TYPE_KIND_I64 : type->kind;
+        registers += evaluate_type_registers(type);
+    }
+    function->offsets[locals->count] = registers;
+    function->registers              = registers;
+}
+
+static void evaluate_function_destroy(EvaluateFunction *restrict function) {
+    deallocate(function->offsets);
+    deallocate(function->kinds);
+    deallocate(function->callees);
+}
+
+static bool evaluator_lookup(Evaluator const *restrict evaluator,
+                             StringView name,
+                             u32 *restrict index) {
+    for (u64 i = 0; i < evaluator->function_count; ++i) {
+        if ((evaluator->functions[i].body != nullptr) &&
+            string_view_equal(evaluator->symbols[i]->name, name)) {
+            *index = (u32)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * every call is bound to its callee before evaluation starts, and every
+ * function must end in a return, so the loop need not check for either.
+ */
+static i32 evaluator_link(Evaluator *restrict evaluator) {
+    for (u64 i = 0; i < evaluator->function_count; ++i) {
+        EvaluateFunction *function = evaluator->functions + i;
+        if (function->body == nullptr) { continue; }
+
+        Bytecode const *bc = &function->body->bc;
+        if ((bc->length == 0) ||
+            (bc->buffer[bc->length - 1].opcode != OPCODE_RET)) {
+            return evaluate_error(SV("function does not return: "),
+                                  evaluator->symbols[i]->name);
+        }
+
+        for (u32 ip = 0; ip < bc->length; ++ip) {
+            Instruction const *I = bc->buffer + ip;
+            if (I->opcode != OPCODE_CALL) { continue; }
+
+            StringView name = constant_string_to_view(
+                context_labels_at(evaluator->context, I->B_data.label));
+            if (!evaluator_lookup(evaluator, name, function->callees + ip)) {
+                return evaluate_error(SV("call to undefined function: "),
+                                      name);
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+static void evaluator_create(Evaluator *restrict evaluator,
+                             Context *restrict context) {
+    SymbolTable const *table   = &context->global_symbol_table;
+    evaluator->context         = context;
+    evaluator->function_count  = table->count;
+    evaluator->symbols         = symbol_table_sorted(table);
+    evaluator->functions       = callocate(table->count + 1,
+                                     sizeof(EvaluateFunction));
+    evaluator->stack           = allocate(EVALUATE_STACK_REGISTERS *
+                                          sizeof(i64));
+    evaluator->frame_count     = 0;
+    evaluator->frames          = allocate(EVALUATE_STACK_FRAMES *
+                                          sizeof(EvaluateFrame));
+
+    for (u64 i = 0; i < evaluator->function_count; ++i) {
+        Symbol *symbol = evaluator->symbols[i];
+        if (symbol->kind != SYMBOL_KIND_FUNCTION) { continue; }
+        evaluate_function_create(evaluator->functions + i,
+                                 &symbol->function_body);
+    }
+}
+
+static void evaluator_destroy(Evaluator *restrict evaluator) {
+    for (u64 i = 0; i < evaluator->function_count; ++i) {
+        evaluate_function_destroy(evaluator->functions + i);
+    }
+    deallocate(evaluator->functions);
+    deallocate(evaluator->symbols);
+    deallocate(evaluator->stack);
+    deallocate(evaluator->frames);
+}
+
+static i64 *evaluate_register(EvaluateFrame const *restrict frame, u32 ssa) {
+    return frame->registers + frame->function->offsets[ssa];
+}
+
+static i64 evaluate_value_scalar(Value const *restrict value) {
+    switch (value->kind) {
+    case VALUE_KIND_NIL:     return 0;
+    case VALUE_KIND_BOOLEAN: return value->boolean;
+    case VALUE_KIND_U8:      return value->u8_;
+    case VALUE_KIND_U16:     return value->u16_;
+    case VALUE_KIND_U32:     return value->u32_;
+    case VALUE_KIND_U64:     return (i64)value->u64_;
+    case VALUE_KIND_I8:      return value->i8_;
+    case VALUE_KIND_I16:     return value->i16_;
+    case VALUE_KIND_I32:     return value->i32_;
+    case VALUE_KIND_I64:     return value->i64_;
+    default:                 EXP_UNREACHABLE();
+    }
+}
+
+static i64 evaluate_scalar(Evaluator *restrict evaluator,
+                           EvaluateFrame const *restrict frame,
+                           OperandKind kind,
+                           OperandData data) {
+    switch (kind) {
+    case OPERAND_KIND_SSA: return *evaluate_register(frame, data.ssa);
+    case OPERAND_KIND_CONSTANT:
+        return evaluate_value_scalar(
+            context_constants_at(evaluator->context, data.constant));
+    case OPERAND_KIND_U8:  return data.u8_;
+    case OPERAND_KIND_U16: return data.u16_;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64: return (i64)data.u32_;
+    case OPERAND_KIND_I8:  return data.i8_;
+    case OPERAND_KIND_I16: return data.i16_;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64: return data.i32_;
+    default:               EXP_UNREACHABLE();
+    }
+}
+
+static u32 evaluate_operand_registers(Evaluator *restrict evaluator,
+                                      EvaluateFrame const *restrict frame,
+                                      Operand operand) {
+    switch (operand.kind) {
+    case OPERAND_KIND_SSA: {
+        u32 const *offsets = frame->function->offsets;
+        return offsets[operand.data.ssa + 1] - offsets[operand.data.ssa];
+    }
+
+    case OPERAND_KIND_CONSTANT: {
+        Value *value =
+            context_constants_at(evaluator->context, operand.data.constant);
+        if (value->kind != VALUE_KIND_TUPLE) { return 1; }
+
+        u32 registers = 0;
+        for (u32 index = 0; index < value->tuple.size; ++index) {
+            registers += evaluate_operand_registers(
+                evaluator, frame, value->tuple.elements[index]);
+        }
+        return registers;
+    }
+
+    default: return 1;
+    }
+}
+
+/*
+ * copy the registers of <operand>, read within <frame>, to <target>.
+ * the elements of a tuple constant may themselves be locals, so
+ * they are read one at a time.
+ */
+static void evaluate_store(Evaluator *restrict evaluator,
+                           EvaluateFrame const *restrict frame,
+                           i64 *target,
+                           Operand operand) {
+    switch (operand.kind) {
+    case OPERAND_KIND_SSA: {
+        u32 registers = evaluate_operand_registers(evaluator, frame, operand);
+        memmove(target,
+                evaluate_register(frame, operand.data.ssa),
+                registers * sizeof(i64));
+        break;
+    }
+
+    case OPERAND_KIND_CONSTANT: {
+        Value *value =
+            context_constants_at(evaluator->context, operand.data.constant);
+        if (value->kind != VALUE_KIND_TUPLE) {
+            *target = evaluate_value_scalar(value);
+            break;
+        }
+
+        for (u32 index = 0; index < value->tuple.size; ++index) {
+            Operand element = value->tuple.elements[index];
+            evaluate_store(evaluator, frame, target, element);
+            target += evaluate_operand_registers(evaluator, frame, element);
+        }
+        break;
+    }
+
+    default:
+        *target =
+            evaluate_scalar(evaluator, frame, operand.kind, operand.data);
+        break;
+    }
+}
+
+static void evaluate_dot(Evaluator *restrict evaluator,
+                         EvaluateFrame const *restrict frame,
+                         Instruction const *restrict I) {
+    i64 *target = evaluate_register(frame, I->A_data.ssa);
+    u64  index  = operand_as_index(operand(I->C_kind, I->C_data));
+
+    if (I->B_kind == OPERAND_KIND_CONSTANT) {
+        Value *value =
+            context_constants_at(evaluator->context, I->B_data.constant);
+        evaluate_store(
+            evaluator, frame, target, value->tuple.elements[index]);
+        return;
+    }
+
+    Locals const    *locals = &frame->function->body->locals;
+    TupleType const *tuple  = &locals->buffer[I->B_data.ssa]->type->tuple_type;
+    u32              offset = 0;
+    for (u64 i = 0; i < index; ++i) {
+        offset += evaluate_type_registers(tuple->types[i]);
+    }
+    memmove(target,
+            evaluate_register(frame, I->B_data.ssa) + offset,
+            evaluate_type_registers(tuple->types[index]) * sizeof(i64));
+}
+
+/*
+ * returns false if there is no room on the stack for the callee.
+ */
+static bool evaluate_call(Evaluator *restrict evaluator,
+                          EvaluateFrame *restrict frame,
+                          Instruction const *restrict I) {
+    EvaluateFunction const *caller = frame->function;
+    u64                     ip     = (u64)(I - caller->body->bc.buffer);
+    EvaluateFunction const *callee = evaluator->functions + caller->callees[ip];
+
+    i64 *registers = frame->registers + caller->registers;
+    i64 *limit     = evaluator->stack + EVALUATE_STACK_REGISTERS;
+    if ((evaluator->frame_count == EVALUATE_STACK_FRAMES) ||
+        (callee->registers > (u64)(limit - registers))) {
+        return false;
+    }
+
+    EvaluateFrame *next = evaluator->frames + evaluator->frame_count++;
+    next->function      = callee;
+    next->ip            = callee->body->bc.buffer;
+    next->registers     = registers;
+    next->result        = evaluate_register(frame, I->A_data.ssa);
+
+    Value *value = context_constants_at(evaluator->context, I->C_data.constant);
+    FormalArgumentList const *arguments = &callee->body->arguments;
+    for (u8 index = 0; index < arguments->size; ++index) {
+        u32 ssa = arguments->list[index]->ssa;
+        evaluate_store(evaluator,
+                       frame,
+                       evaluate_register(next, ssa),
+                       value->tuple.elements[index]);
+    }
+    return true;
+}
+
+/*
+ * scalars are computed as i64, with wrapping arithmetic, as they
+ * would be within a 64 bit register, then truncated to the width of
+ * their local, and zero or sign extended back to i64 by its kind.
+ */
+static i64 evaluate_wrap(TypeKind kind, u64 value) {
+    switch (kind) {
+    case TYPE_KIND_U8:  return (u8)value;
+    case TYPE_KIND_U16: return (u16)value;
+    case TYPE_KIND_U32: return (u32)value;
+    case TYPE_KIND_I8:  return (i8)value;
+    case TYPE_KIND_I16: return (i16)value;
+    case TYPE_KIND_I32: return (i32)value;
+    default:            return (i64)value;
+    }
+}
+
+static bool evaluate_unsigned(TypeKind kind) {
+    return (kind >= TYPE_KIND_U8) && (kind <= TYPE_KIND_U64);
+}
+
+static i32 evaluate_loop(Evaluator *restrict evaluator,
+                         i64 *restrict result) {
+    EvaluateFrame     *frame = evaluator->frames + evaluator->frame_count - 1;
+    Instruction const *I     = nullptr;
+    i64                B     = 0;
+    i64                C     = 0;
+
+#if defined(__GNUC__)
+    // each handler ends with its own indirect jump, which predicts
+    // far better than the single jump shared by a switch.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+    static void *const dispatch[] = {
+        [OPCODE_RET] = &&op_ret,
+        [OPCODE_CALL] = &&op_call,
+        [OPCODE_LET] = &&op_let,
+        [OPCODE_NEG] = &&op_neg,
+        [OPCODE_DOT] = &&op_dot,
+        [OPCODE_ADD] = &&op_add,
+        [OPCODE_SUB] = &&op_sub,
+        [OPCODE_MUL] = &&op_mul,
+        [OPCODE_DIV] = &&op_div,
+        [OPCODE_MOD] = &&op_mod,
+    };
+#define EVALUATE_DISPATCH()                                                    \
+    I = frame->ip++;                                                           \
+    goto *dispatch[I->opcode]
+#else
+#define EVALUATE_DISPATCH()                                                    \
+    I = frame->ip++;                                                           \
+    goto dispatch
+#endif
+
+#define EVALUATE_OPERANDS()                                                    \
+    B = evaluate_scalar(evaluator, frame, I->B_kind, I->B_data);               \
+    C = evaluate_scalar(evaluator, frame, I->C_kind, I->C_data)
+
+#define EVALUATE_TARGET() (*evaluate_register(frame, I->A_data.ssa))
+#define EVALUATE_KIND()   (frame->function->kinds[I->A_data.ssa])
+
+    EVALUATE_DISPATCH();
+
+#if !defined(__GNUC__)
+dispatch:
+    switch (I->opcode) {
+    case OPCODE_RET:  goto op_ret;
+    case OPCODE_CALL: goto op_call;
+    case OPCODE_LET:  goto op_let;
+    case OPCODE_NEG:  goto op_neg;
+    case OPCODE_DOT:  goto op_dot;
+    case OPCODE_ADD:  goto op_add;
+    case OPCODE_SUB:  goto op_sub;
+    case OPCODE_MUL:  goto op_mul;
+    case OPCODE_DIV:  goto op_div;
+    case OPCODE_MOD:  goto op_mod;
+    default:          EXP_UNREACHABLE();
+    }
+#endif
+
+op_ret:
+    evaluate_store(
+        evaluator, frame, frame->result, operand(I->B_kind, I->B_data));
+    if (--evaluator->frame_count == 0) {
+        *result = *frame->result;
+        return EXIT_SUCCESS;
+    }
+    frame = evaluator->frames + evaluator->frame_count - 1;
+    EVALUATE_DISPATCH();
+
+op_call:
+    if (!evaluate_call(evaluator, frame, I)) {
+        return evaluate_error(SV("stack overflow"), SV(""));
+    }
+    frame = evaluator->frames + evaluator->frame_count - 1;
+    EVALUATE_DISPATCH();
+
+op_let:
+    evaluate_store(evaluator,
+                   frame,
+                   evaluate_register(frame, I->A_data.ssa),
+                   operand(I->B_kind, I->B_data));
+    EVALUATE_DISPATCH();
+
+op_neg:
+    B = evaluate_scalar(evaluator, frame, I->B_kind, I->B_data);
+    EVALUATE_TARGET() = evaluate_wrap(EVALUATE_KIND(), -(u64)B);
+    EVALUATE_DISPATCH();
+
+op_dot:
+    evaluate_dot(evaluator, frame, I);
+    EVALUATE_DISPATCH();
+
+op_add:
+    EVALUATE_OPERANDS();
+    EVALUATE_TARGET() = evaluate_wrap(EVALUATE_KIND(), (u64)B + (u64)C);
+    EVALUATE_DISPATCH();
+
+op_sub:
+    EVALUATE_OPERANDS();
+    EVALUATE_TARGET() = evaluate_wrap(EVALUATE_KIND(), (u64)B - (u64)C);
+    EVALUATE_DISPATCH();
+
+op_mul:
+    EVALUATE_OPERANDS();
+    EVALUATE_TARGET() = evaluate_wrap(EVALUATE_KIND(), (u64)B * (u64)C);
+    EVALUATE_DISPATCH();
+
+op_div:
+    EVALUATE_OPERANDS();
+    if (C == 0) { return evaluate_error(SV("division by zero"), SV("")); }
+    if (evaluate_unsigned(EVALUATE_KIND())) {
+        EVALUATE_TARGET() = evaluate_wrap(EVALUATE_KIND(), (u64)B / (u64)C);
+    } else {
+        EVALUATE_TARGET() = evaluate_wrap(
+            EVALUATE_KIND(),
+            ((B == INT64_MIN) && (C == -1)) ? (u64)B : (u64)(B / C));
+    }
+    EVALUATE_DISPATCH();
+
+op_mod:
+    EVALUATE_OPERANDS();
+    if (C == 0) { return evaluate_error(SV("division by zero"), SV("")); }
+    if (evaluate_unsigned(EVALUATE_KIND())) {
+        EVALUATE_TARGET() = evaluate_wrap(EVALUATE_KIND(), (u64)B % (u64)C);
+    } else {
+        EVALUATE_TARGET() = evaluate_wrap(
+            EVALUATE_KIND(),
+            ((B == INT64_MIN) && (C == -1)) ? 0 : (u64)(B % C));
+    }
+    EVALUATE_DISPATCH();
+
+#undef EVALUATE_KIND
+#undef EVALUATE_TARGET
+#undef EVALUATE_OPERANDS
+#undef EVALUATE_DISPATCH
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+i32 evaluate(Context *restrict context, i64 *restrict result) {
+    Evaluator evaluator;
+    evaluator_create(&evaluator, context);
+
+    i32 status = evaluator_link(&evaluator);
+
+    u32 entry = 0;
+    if ((status != EXIT_FAILURE) &&
+        !evaluator_lookup(&evaluator, SV("main"), &entry)) {
+        status = evaluate_error(SV("main is not defined"), SV(""));
+    }
+
+    if (status != EXIT_FAILURE) {
+        // the value returned by main is written to the bottom of
+        // the stack, below the frame of main itself.
+        Symbol const *symbol = evaluator.symbols[entry];
+        u32           returned =
+            evaluate_type_registers(symbol->function_body.return_type);
+        EvaluateFrame *frame  = evaluator.frames + evaluator.frame_count++;
+        frame->function       = evaluator.functions + entry;
+        frame->ip             = frame->function->body->bc.buffer;
+        frame->registers      = evaluator.stack + returned;
+        frame->result         = evaluator.stack;
+        status                = evaluate_loop(&evaluator, result);
+    }
+
+    evaluator_destroy(&evaluator);
+    return status;
+}
@@ -16,14 +16,83 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <assert.h>
 #include <stdlib.h>
 
+#include "codegen/ELF/linker.h"
 #include "core/link.h"
 #include "support/config.h"
+#include "support/io.h"
 #include "support/message.h"
+#include "support/panic.h"
 #include "support/process.h"
 
+#if defined(EXP_HOST_SYSTEM_LINUX)
+#include <sys/stat.h>
+
+static String link_read_file(StringView path) {
+    FILE  *file  = file_open(path.ptr, "r");
+    String bytes = string_from_file(file);
+    file_close(file);
+    return bytes;
+}
+
+static i32 link_builtin(Context *restrict context) {
+    StringView obj_path = context_object_path(context);
+    StringView out_path = context_executable_path(context);
+    StringView start_path =
+        SV(EXP_LIBEXP_RUNTIME_BINARY_DIR "/libexp_runtime_start.a");
+    StringView runtime_path =
+        SV(EXP_LIBEXP_RUNTIME_BINARY_DIR "/libexp_runtime.a");
+
+    String object  = link_read_file(obj_path);
+    String start   = link_read_file(start_path);
+    String runtime = link_read_file(runtime_path);
+
+    ELF_Linker linker;
+    elf_linker_create(&linker);
+    elf_linker_add_object(&linker, obj_path, string_to_view(&object));
+
+    i32 result = elf_linker_add_archive(
+        &linker, start_path, string_to_view(&start));
+    result |= elf_linker_add_archive(
+        &linker, runtime_path, string_to_view(&runtime));
+
+    String executable = string_create();
+    if (result == EXIT_SUCCESS) {
+        result = elf_linker_link(&linker, SV("_start"), &executable);
+    }
+
+    if (result == EXIT_SUCCESS) {
+        FILE *file = file_open(out_path.ptr, "w");
+        file_write(string_to_view(&executable), file);
+        file_close(file);
+        if (chmod(out_path.ptr, 0755) != 0) { PANIC_ERRNO("chmod failed"); }
+    }
+
+    string_destroy(&executable);
+    elf_linker_destroy(&linker);
+    string_destroy(&runtime);
+    string_destroy(&start);
+    string_destroy(&object);
+    return result;
+}
+#else
+#error "unsupported host OS"
+#endif
+
 i32 link(Context *restrict context) {
+    if (context_shall_builtin_link_artifact(context)) {
+        return link_builtin(context);
+    }
+
+    Process ld;
+    link_spawn(context, &ld);
+    return process_await(&ld);
+}
+
+void link_spawn(Context *restrict context, Process *restrict ld) {
+    assert(!context_shall_builtin_link_artifact(context));
     StringView obj_path = context_object_path(context);
     StringView out_path = context_executable_path(context);
 
@@ -42,5 +111,5 @@ i32 link(Context *restrict context) {
         NULL,
     };
 
-    return process("ld", 7, args);
+    process_spawn(ld, "ld", 7, args);
 }
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/phase_times.h"
+#include "support/io.h"
+#include "support/unreachable.h"
+
+void phase_times_create(PhaseTimes *restrict times) {
+    for (u64 index = 0; index < PHASE_COUNT; ++index) {
+        times->phases[index].nanoseconds    = 0;
+        times->phases[index].resident_bytes = 0;
+    }
+}
+
+StringView phase_name(Phase phase) {
+    switch (phase) {
+    case PHASE_PARSE:    return SV("parse");
+    case PHASE_ANALYZE:  return SV("analyze");
+    case PHASE_IR:       return SV("ir");
+    case PHASE_CODEGEN:  return SV("codegen");
+    case PHASE_ASSEMBLE: return SV("assemble");
+    case PHASE_LINK:     return SV("link");
+    default:             EXP_UNREACHABLE();
+    }
+}
+
+void phase_times_record(PhaseTimes *restrict times,
+                        Phase       phase,
+                        TimerSample start) {
+    TimerSample stop = timer_sample();
+    PhaseTime  *time = times->phases + phase;
+    time->nanoseconds    += timer_elapsed(start, stop);
+    time->resident_bytes += timer_resident_delta(start, stop);
+}
+
+PhaseTime phase_times_total(PhaseTimes const *restrict times) {
+    PhaseTime total = {.nanoseconds = 0, .resident_bytes = 0};
+    for (u64 index = 0; index < PHASE_COUNT; ++index) {
+        total.nanoseconds    += times->phases[index].nanoseconds;
+        total.resident_bytes += times->phases[index].resident_bytes;
+    }
+    return total;
+}
+
+static void append_padding(String *restrict row, u64 length, u64 width) {
+    while (length++ < width) {
+        string_append(row, SV(" "));
+    }
+}
+
+static void append_left(String *restrict row, StringView text, u64 width) {
+    string_append(row, text);
+    append_padding(row, text.length, width);
+}
+
+static void append_right(String *restrict row, StringView text, u64 width) {
+    append_padding(row, text.length, width);
+    string_append(row, text);
+}
+
+static void print_row(StringView name, PhaseTime time, FILE *restrict file) {
+    String row    = string_create();
+    String number = string_create();
+    append_left(&row, name, 12);
+
+    string_append_u64(&number, time.nanoseconds / 1000);
+    append_right(&row, string_to_view(&number), 14);
+
+    string_assign(&number, SV(""));
+    if (time.resident_bytes >= 0) { string_append(&number, SV("+")); }
+    string_append_i64(&number, time.resident_bytes / 1024);
+    append_right(&row, string_to_view(&number), 18);
+
+    string_append(&row, SV("\n"));
+    file_write(string_to_view(&row), file);
+    string_destroy(&number);
+    string_destroy(&row);
+}
+
+void phase_times_print(PhaseTimes const *restrict times, FILE *restrict file) {
+    String header = string_create();
+    append_left(&header, SV("phase"), 12);
+    append_right(&header, SV("time (us)"), 14);
+    append_right(&header, SV("rss delta (KiB)"), 18);
+    string_append(&header, SV("\n"));
+    file_write(string_to_view(&header), file);
+    string_destroy(&header);
+
+    for (u8 index = 0; index < PHASE_COUNT; ++index) {
+        print_row(phase_name((Phase)index), times->phases[index], file);
+    }
+    print_row(SV("total"), phase_times_total(times), file);
+}
+
+static void append_json_time(String *restrict json, PhaseTime time) {
+    string_append(json, SV("{\"nanoseconds\":"));
+    string_append_u64(json, time.nanoseconds);
+    string_append(json, SV(",\"resident_bytes\":"));
+    string_append_i64(json, time.resident_bytes);
+    string_append(json, SV("}"));
+}
+
+void phase_times_append_json(PhaseTimes const *restrict times,
+                             String *restrict json) {
+    string_append(json, SV("{"));
+    for (u8 index = 0; index < PHASE_COUNT; ++index) {
+        if (index != 0) { string_append(json, SV(",")); }
+        string_append(json, SV("\""));
+        string_append(json, phase_name((Phase)index));
+        string_append(json, SV("\":"));
+        append_json_time(json, times->phases[index]);
+    }
+    string_append(json, SV(",\"total\":"));
+    append_json_time(json, phase_times_total(times));
+    string_append(json, SV("}"));
+}
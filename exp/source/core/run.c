@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "codegen/ELF/jit.h"
+#include "core/analyze.h"
+#include "core/codegen.h"
+#include "core/evaluate.h"
+#include "core/run.h"
+#include "env/cli_options.h"
+#include "env/context.h"
+#include "scanning/parser.h"
+#include "support/message.h"
+
+typedef i64 (*RunMain)();
+
+/*
+ * calls <main> from core/run_enter.s. the generated code does not
+ * preserve the callee saved registers (rbx, rbp, r12-r15), so it
+ * cannot be called directly from C.
+ */
+i64 run_enter(RunMain main);
+
+/*
+ * _exp_sysexit must not exit the compiler, which may be serving
+ * other requests, so it unwinds back to run instead.
+ */
+static jmp_buf run_exit;
+static i64     run_exit_status = 0;
+
+[[noreturn]] static void run_sysexit(i64 status) {
+    run_exit_status = status;
+    longjmp(run_exit, 1);
+}
+
+static void run_byte_copy(u8 *restrict dst, u8 const *restrict src, u64 count) {
+    for (u64 index = 0; index < count; ++index) {
+        dst[index] = src[index];
+    }
+}
+
+static i32 run_object(ELF_Object const *restrict object) {
+    ELF_JitBinding const bindings[] = {
+        {.name    = SV("_exp_byte_copy"),
+         .address = (u64)(uintptr_t)run_byte_copy},
+        {.name    = SV("_exp_byte_copy_word"),
+         .address = (u64)(uintptr_t)run_byte_copy},
+        {.name    = SV("_exp_sysexit"),
+         .address = (u64)(uintptr_t)run_sysexit},
+    };
+
+    ELF_Jit jit;
+    u64     binding_count = sizeof(bindings) / sizeof(*bindings);
+    if (elf_jit_load(&jit, object, binding_count, bindings) == EXIT_FAILURE) {
+        elf_jit_unload(&jit);
+        return EXIT_FAILURE;
+    }
+
+    u64 address = 0;
+    if (!elf_jit_symbol(&jit, object, SV("main"), &address)) {
+        message(MESSAGE_ERROR, NULL, 0, SV("main is not defined"), stderr);
+        elf_jit_unload(&jit);
+        return EXIT_FAILURE;
+    }
+
+    RunMain entry  = (RunMain)(uintptr_t)address;
+    i64     status = 0;
+    if (setjmp(run_exit) == 0) {
+        status = run_enter(entry);
+    } else {
+        status = run_exit_status;
+    }
+
+    elf_jit_unload(&jit);
+    return (i32)status;
+}
+
+/*
+ * parse and analyze the single source file named on the command line
+ * of <flag>. on success the caller must destroy <cli_options> and
+ * <context>, on failure they are already destroyed.
+ */
+static i32 run_front_end(i32 argc,
+                         char const *argv[],
+                         StringView flag,
+                         CLIOptions *restrict cli_options,
+                         Context *restrict context) {
+    cli_options_init(cli_options);
+    parse_cli_options(argc, argv, cli_options);
+
+    if (cli_options->sources.count != 1) {
+        String buffer = string_create();
+        string_append(&buffer, flag);
+        string_append(&buffer, SV(" takes a single source file."));
+        message(MESSAGE_ERROR, NULL, 0, string_to_view(&buffer), stderr);
+        string_destroy(&buffer);
+        cli_options_destroy(cli_options);
+        return EXIT_FAILURE;
+    }
+
+    context_create(context,
+                   &cli_options->context_options,
+                   string_to_view(cli_options->sources.buffer));
+
+    i32 result = parse_source(context);
+    if (result != EXIT_FAILURE) { result = analyze(context); }
+    if (result == EXIT_FAILURE) {
+        context_destroy(context);
+        cli_options_destroy(cli_options);
+    }
+    return result;
+}
+
+i32 run(i32 argc, char const *argv[]) {
+    CLIOptions cli_options;
+    Context    context;
+    if (run_front_end(argc, argv, SV("--run"), &cli_options, &context) ==
+        EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    ELF_Object object;
+    elf_object_create(&object);
+
+    i32 result = codegen_object_buffer(&context, &object);
+    if (result != EXIT_FAILURE) { result = run_object(&object); }
+
+    elf_object_destroy(&object);
+    context_destroy(&context);
+    cli_options_destroy(&cli_options);
+    return result;
+}
+
+i32 interpret(i32 argc, char const *argv[]) {
+    CLIOptions cli_options;
+    Context    context;
+    if (run_front_end(argc, argv, SV("--evaluate"), &cli_options, &context) ==
+        EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    i64 status = 0;
+    i32 result = evaluate(&context, &status);
+    if (result != EXIT_FAILURE) { result = (i32)status; }
+
+    context_destroy(&context);
+    cli_options_destroy(&cli_options);
+    return result;
+}
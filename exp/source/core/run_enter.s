@@ -0,0 +1,28 @@
+.file "run_enter.s"
+
+// i64 run_enter(i64 (*main)());
+// %rdi holds main
+// the generated code does not preserve the callee saved registers,
+// so they are saved here around the call, on behalf of run.
+.globl run_enter
+.type run_enter, @function
+run_enter:
+  push %rbx
+  push %rbp
+  push %r12
+  push %r13
+  push %r14
+  push %r15
+  sub $8, %rsp
+  call *%rdi
+  add $8, %rsp
+  pop %r15
+  pop %r14
+  pop %r13
+  pop %r12
+  pop %rbp
+  pop %rbx
+  ret
+.size run_enter, .-run_enter
+
+.section .note.GNU-stack,"",@progbits
@@ -0,0 +1,549 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// accept4(2) is a GNU extension
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/compile.h"
+#include "core/server.h"
+#include "env/cli_options.h"
+#include "support/allocation.h"
+#include "support/config.h"
+#include "support/message.h"
+#include "support/io.h"
+#include "support/panic.h"
+#include "support/thread_pool.h"
+
+/*
+ * a request is a single message on the socket:
+ *   u64 the length of the remainder of the request
+ *   u32 argc
+ *   argc times:
+ *     u32 the length of the argument
+ *     the bytes of the argument
+ * the first byte carries three descriptors as ancillary data,
+ * the client's stdout, stderr and working directory.
+ *
+ * the response is:
+ *   i32 the result of compiling the request
+ *   u64 the length of the remainder of the response
+ *   the path of each artifact created, one per line
+ * a request longer than SERVER_REQUEST_LIMIT is rejected.
+ */
+
+#if defined(EXP_HOST_SYSTEM_LINUX)
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/prctl.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define SERVER_DESCRIPTOR_COUNT 3
+#define SERVER_REQUEST_LIMIT    (1 << 20)
+
+void server_socket_path(String *restrict path) {
+    assert(path != nullptr);
+    char const *override = getenv("EXP_SERVER_SOCKET");
+    if (override != nullptr) {
+        string_assign(path, string_view_from_cstring(override));
+        return;
+    }
+
+    string_assign(path, SV("/tmp/exp-server-"));
+    string_append_u64(path, (u64)getuid());
+    string_append(path, SV(".socket"));
+}
+
+static bool server_address(struct sockaddr_un *restrict address,
+                           StringView path) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (path.length >= sizeof(address->sun_path)) {
+        message(MESSAGE_ERROR, NULL, 0, SV("socket path too long"), stderr);
+        return false;
+    }
+
+    memcpy(address->sun_path, path.ptr, path.length);
+    return true;
+}
+
+static bool server_read(i32 fd, void *buffer, u64 length) {
+    u8 *cursor = buffer;
+    while (length > 0) {
+        ssize_t count = read(fd, cursor, length);
+        if (count < 0) {
+            if (errno == EINTR) { continue; }
+            return false;
+        } else if (count == 0) {
+            return false;
+        }
+
+        cursor += count;
+        length -= (u64)count;
+    }
+
+    return true;
+}
+
+static bool server_write(i32 fd, void const *buffer, u64 length) {
+    u8 const *cursor = buffer;
+    while (length > 0) {
+        // the peer may hang up at any time, which must not kill us.
+        ssize_t count = send(fd, cursor, length, MSG_NOSIGNAL);
+        if (count < 0) {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+
+        cursor += count;
+        length -= (u64)count;
+    }
+
+    return true;
+}
+
+static void server_close(i32 fd) {
+    if (fd < 0) { return; }
+    if (close(fd) != 0) { PANIC_ERRNO("close failed"); }
+}
+
+static void server_append(String *restrict request, void const *bytes, u64 n) {
+    string_append(request, string_view(bytes, n));
+}
+
+/**
+ * @brief read a request, and the descriptors sent along with it
+ */
+static bool server_receive(i32 connection,
+                           i32 fds[SERVER_DESCRIPTOR_COUNT],
+                           StringView *restrict request) {
+    u64          length = 0;
+    struct iovec iov    = {.iov_base = &length, .iov_len = sizeof(length)};
+    union {
+        char buffer[CMSG_SPACE(sizeof(i32) * SERVER_DESCRIPTOR_COUNT)];
+        struct cmsghdr align;
+    } control;
+    struct msghdr header = {
+        .msg_iov        = &iov,
+        .msg_iovlen     = 1,
+        .msg_control    = control.buffer,
+        .msg_controllen = sizeof(control.buffer),
+    };
+
+    ssize_t count = recvmsg(connection, &header, MSG_CMSG_CLOEXEC);
+    if (count <= 0) { return false; }
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header);
+    if ((cmsg == nullptr) || (cmsg->cmsg_level != SOL_SOCKET) ||
+        (cmsg->cmsg_type != SCM_RIGHTS) ||
+        (cmsg->cmsg_len != CMSG_LEN(sizeof(i32) * SERVER_DESCRIPTOR_COUNT))) {
+        return false;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(i32) * SERVER_DESCRIPTOR_COUNT);
+
+    u8 *rest = (u8 *)&length + count;
+    if (!server_read(connection, rest, sizeof(length) - (u64)count) ||
+        (length > SERVER_REQUEST_LIMIT)) {
+        return false;
+    }
+
+    char *bytes = allocate(length);
+    if (!server_read(connection, bytes, length)) {
+        deallocate(bytes);
+        return false;
+    }
+
+    *request = string_view(bytes, length);
+    return true;
+}
+
+static u32 server_take_u32(StringView *restrict view) {
+    u32 value = 0;
+    if (view->length < sizeof(value)) { return 0; }
+    memcpy(&value, view->ptr, sizeof(value));
+    view->ptr += sizeof(value);
+    view->length -= sizeof(value);
+    return value;
+}
+
+/**
+ * @brief compile a request as if it were our own command line,
+ * adopting the client's stdout, stderr and working directory.
+ */
+static i32 server_compile(i32 fds[SERVER_DESCRIPTOR_COUNT],
+                          i32         argc,
+                          char const *argv[],
+                          ContextPool *pool,
+                          String *restrict artifacts) {
+    fflush(stdout);
+    fflush(stderr);
+    i32 saved_stdout = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+    i32 saved_stderr = fcntl(STDERR_FILENO, F_DUPFD_CLOEXEC, 0);
+    i32 saved_cwd    = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if ((saved_stdout < 0) || (saved_stderr < 0) || (saved_cwd < 0)) {
+        PANIC_ERRNO("saving server descriptors failed");
+    }
+
+    i32 result = EXIT_FAILURE;
+    if ((dup2(fds[0], STDOUT_FILENO) >= 0) &&
+        (dup2(fds[1], STDERR_FILENO) >= 0) && (fchdir(fds[2]) == 0)) {
+        result = compile_with_pool(argc, argv, pool, artifacts);
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    if ((dup2(saved_stdout, STDOUT_FILENO) < 0) ||
+        (dup2(saved_stderr, STDERR_FILENO) < 0) || (fchdir(saved_cwd) != 0)) {
+        PANIC_ERRNO("restoring server descriptors failed");
+    }
+
+    server_close(saved_cwd);
+    server_close(saved_stderr);
+    server_close(saved_stdout);
+    return result;
+}
+
+static void server_respond(i32 connection,
+                           i32 result,
+                           String const *restrict artifacts) {
+    StringView paths  = string_to_view(artifacts);
+    u64        length = paths.length;
+    if (server_write(connection, &result, sizeof(result)) &&
+        server_write(connection, &length, sizeof(length))) {
+        server_write(connection, paths.ptr, paths.length);
+    }
+}
+
+static void server_handle(i32 connection, ContextPool *pool) {
+    i32        fds[SERVER_DESCRIPTOR_COUNT] = {-1, -1, -1};
+    StringView request                      = string_view(nullptr, 0);
+    if (!server_receive(connection, fds, &request)) {
+        message(MESSAGE_WARNING, NULL, 0, SV("malformed request"), stderr);
+        for (u64 i = 0; i < SERVER_DESCRIPTOR_COUNT; ++i) {
+            server_close(fds[i]);
+        }
+        return;
+    }
+
+    // each argument takes at least its length, so a count the request
+    // is too short to hold is rejected before allocating for it.
+    StringView view  = request;
+    u32        argc  = server_take_u32(&view);
+    bool       valid = (argc > 0) && (argc <= view.length / sizeof(u32));
+    if (!valid) { argc = 0; }
+
+    String      *args = callocate(argc, sizeof(String));
+    char const **argv = callocate((u64)argc + 1, sizeof(char const *));
+    for (u32 index = 0; valid && (index < argc); ++index) {
+        u32 length = server_take_u32(&view);
+        if (length > view.length) {
+            valid = false;
+            break;
+        }
+
+        args[index] = string_from_view(string_view(view.ptr, length));
+        argv[index] = string_to_cstring(args + index);
+        view.ptr += length;
+        view.length -= length;
+    }
+
+    i32    result    = EXIT_FAILURE;
+    String artifacts = string_create();
+    if (valid) {
+        result = server_compile(fds, (i32)argc, argv, pool, &artifacts);
+    } else {
+        message(MESSAGE_WARNING, NULL, 0, SV("malformed request"), stderr);
+    }
+
+    server_respond(connection, result, &artifacts);
+
+    string_destroy(&artifacts);
+    for (u32 index = 0; index < argc; ++index) {
+        string_destroy(args + index);
+    }
+    deallocate(argv);
+    deallocate(args);
+    deallocate((char *)request.ptr);
+    for (u64 i = 0; i < SERVER_DESCRIPTOR_COUNT; ++i) {
+        server_close(fds[i]);
+    }
+}
+
+static volatile sig_atomic_t server_stopping = 0;
+
+static void server_stop([[maybe_unused]] i32 signal) { server_stopping = 1; }
+
+static void server_install_handlers() {
+    // without SA_RESTART, so that accept(2) is interrupted.
+    struct sigaction action = {.sa_handler = server_stop, .sa_flags = 0};
+    sigemptyset(&action.sa_mask);
+    if ((sigaction(SIGINT, &action, NULL) != 0) ||
+        (sigaction(SIGTERM, &action, NULL) != 0)) {
+        PANIC_ERRNO("sigaction failed");
+    }
+}
+
+/**
+ * @brief accept and compile requests on <listener>, keeping the
+ * interners of each request warm for the next, until stopped.
+ */
+[[noreturn]] static void server_worker(i32 listener, pid_t server) {
+    // a worker must not outlive the server which started it.
+    if ((prctl(PR_SET_PDEATHSIG, SIGTERM) != 0) || (getppid() != server)) {
+        _exit(EXIT_FAILURE);
+    }
+
+    ContextPool pool;
+    context_pool_create(&pool);
+
+    while (!server_stopping) {
+        i32 connection = accept4(listener, NULL, NULL, SOCK_CLOEXEC);
+        if (connection < 0) {
+            if (errno == EINTR) { continue; }
+            PANIC_ERRNO("accept4 failed");
+        }
+
+        server_handle(connection, &pool);
+        server_close(connection);
+    }
+
+    context_pool_destroy(&pool);
+    exit(EXIT_SUCCESS);
+}
+
+static pid_t server_spawn_worker(i32 listener) {
+    pid_t server = getpid();
+    fflush(stdout);
+    fflush(stderr);
+    pid_t worker = fork();
+    if (worker < 0) { PANIC_ERRNO("fork failed"); }
+    if (worker == 0) { server_worker(listener, server); }
+    return worker;
+}
+
+/**
+ * @brief keep every worker running until the server is stopped.
+ *
+ * @note the compiler may PANIC or exit on a bad request. that stops
+ * only the worker serving it, whose client sees a lost connection,
+ * and the worker is replaced.
+ */
+static void server_supervise(i32 listener, u64 count, pid_t *workers) {
+    for (u64 index = 0; index < count; ++index) {
+        workers[index] = server_spawn_worker(listener);
+    }
+
+    while (!server_stopping) {
+        i32   status = 0;
+        pid_t pid    = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) { continue; }
+            PANIC_ERRNO("waitpid failed");
+        }
+
+        for (u64 index = 0; index < count; ++index) {
+            if (workers[index] != pid) { continue; }
+            message(MESSAGE_WARNING, NULL, 0, SV("restarting worker"), stderr);
+            workers[index] = server_spawn_worker(listener);
+        }
+    }
+
+    for (u64 index = 0; index < count; ++index) {
+        kill(workers[index], SIGTERM);
+    }
+
+    for (u64 index = 0; index < count; ++index) {
+        while ((waitpid(workers[index], NULL, 0) < 0) && (errno == EINTR)) {}
+    }
+}
+
+i32 server() {
+    String path = string_create();
+    server_socket_path(&path);
+
+    struct sockaddr_un address;
+    if (!server_address(&address, string_to_view(&path))) {
+        string_destroy(&path);
+        return EXIT_FAILURE;
+    }
+
+    i32 listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0) { PANIC_ERRNO("socket failed"); }
+
+    // a previous server may have been killed before removing its socket.
+    if ((unlink(address.sun_path) != 0) && (errno != ENOENT)) {
+        PANIC_ERRNO("unlink failed");
+    }
+
+    if ((bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0) ||
+        (listen(listener, SOMAXCONN) != 0)) {
+        message(MESSAGE_ERROR, NULL, 0, SV("unable to listen on:"), stderr);
+        trace(string_to_view(&path), stderr);
+        server_close(listener);
+        string_destroy(&path);
+        return EXIT_FAILURE;
+    }
+
+    server_install_handlers();
+    message(MESSAGE_STATUS, NULL, 0, SV("listening on:"), stdout);
+    trace(string_to_view(&path), stdout);
+    fflush(stdout);
+
+    // each worker adopts the descriptors and working directory of one
+    // client at a time, so requests are served concurrently by
+    // separate processes, all accepting on the one listener.
+    u64    count   = thread_pool_hardware_concurrency();
+    pid_t *workers = callocate(count, sizeof(pid_t));
+    server_supervise(listener, count, workers);
+    deallocate(workers);
+
+    server_close(listener);
+    unlink(address.sun_path);
+    string_destroy(&path);
+    return EXIT_SUCCESS;
+}
+
+static void client_request(String *restrict request,
+                           i32         argc,
+                           char const *argv[]) {
+    u32 count  = (u32)argc;
+    u64 length = sizeof(count);
+    for (i32 index = 0; index < argc; ++index) {
+        length += sizeof(u32) + strlen(argv[index]);
+    }
+
+    server_append(request, &length, sizeof(length));
+    server_append(request, &count, sizeof(count));
+    for (i32 index = 0; index < argc; ++index) {
+        u32 arg_length = (u32)strlen(argv[index]);
+        server_append(request, &arg_length, sizeof(arg_length));
+        server_append(request, argv[index], arg_length);
+    }
+}
+
+static bool client_send(i32 connection, String const *restrict request) {
+    i32 cwd = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (cwd < 0) { PANIC_ERRNO("open failed"); }
+    i32 fds[SERVER_DESCRIPTOR_COUNT] = {STDOUT_FILENO, STDERR_FILENO, cwd};
+
+    union {
+        char           buffer[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    StringView    bytes  = string_to_view(request);
+    struct iovec  iov    = {.iov_base = (char *)bytes.ptr,
+                            .iov_len  = bytes.length};
+    struct msghdr header = {
+        .msg_iov        = &iov,
+        .msg_iovlen     = 1,
+        .msg_control    = control.buffer,
+        .msg_controllen = sizeof(control.buffer),
+    };
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header);
+    cmsg->cmsg_level     = SOL_SOCKET;
+    cmsg->cmsg_type      = SCM_RIGHTS;
+    cmsg->cmsg_len       = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ssize_t count = sendmsg(connection, &header, MSG_NOSIGNAL);
+    server_close(cwd);
+    if (count <= 0) { return false; }
+
+    return server_write(
+        connection, bytes.ptr + count, bytes.length - (u64)count);
+}
+
+/**
+ * @brief read the response to our request, and write the artifact
+ * paths it carries to stdout.
+ */
+static bool client_receive(i32 connection, i32 *restrict result) {
+    u64 length = 0;
+    if (!server_read(connection, result, sizeof(*result)) ||
+        !server_read(connection, &length, sizeof(length)) ||
+        (length > SERVER_REQUEST_LIMIT)) {
+        return false;
+    }
+    if (length == 0) { return true; }
+
+    char *paths = allocate(length);
+    bool  read  = server_read(connection, paths, length);
+    if (read) { file_write(string_view(paths, length), stdout); }
+    deallocate(paths);
+    return read;
+}
+
+i32 client(i32 argc, char const *argv[]) {
+    // validate the command line before bothering the server, this
+    // also handles -h and -v locally.
+    CLIOptions cli_options;
+    cli_options_init(&cli_options);
+    parse_cli_options(argc, argv, &cli_options);
+    cli_options_destroy(&cli_options);
+
+    String path = string_create();
+    server_socket_path(&path);
+
+    struct sockaddr_un address;
+    if (!server_address(&address, string_to_view(&path))) {
+        string_destroy(&path);
+        return EXIT_FAILURE;
+    }
+
+    i32 connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connection < 0) { PANIC_ERRNO("socket failed"); }
+
+    if (connect(connection, (struct sockaddr *)&address, sizeof(address)) !=
+        0) {
+        message(MESSAGE_ERROR, NULL, 0, SV("no server listening on:"), stderr);
+        trace(string_to_view(&path), stderr);
+        server_close(connection);
+        string_destroy(&path);
+        return EXIT_FAILURE;
+    }
+
+    String request = string_create();
+    client_request(&request, argc, argv);
+
+    i32 result = EXIT_FAILURE;
+    if (!client_send(connection, &request) ||
+        !client_receive(connection, &result)) {
+        message(
+            MESSAGE_ERROR, NULL, 0, SV("lost connection to server"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    string_destroy(&request);
+    server_close(connection);
+    string_destroy(&path);
+    return result;
+}
+
+#else
+#error "unsupported host OS"
+#endif
@@ -21,6 +21,8 @@
 #include <string.h>
 
 #include "env/cli_options.h"
+#include "support/allocation.h"
+#include "support/array_growth.h"
 #include "support/config.h"
 #include "support/io.h"
 #include "support/message.h"
@@ -35,11 +37,44 @@ void cli_options_init(CLIOptions *restrict cli_options) {
     cli_options->context_options.cleanup_ir_artifact        = false;
     cli_options->context_options.cleanup_assembly_artifact  = true;
     cli_options->context_options.cleanup_object_artifact    = true;
-    string_initialize(&cli_options->source);
+    cli_options->context_options.encode_object_artifact     = false;
+    cli_options->context_options.builtin_link_artifact      = false;
+    cli_options->context_options.stream_artifacts           = false;
+    cli_options->context_options.cache_artifacts            = false;
+    cli_options->context_options.report_phase_times         = false;
+    cli_options->context_options.report_phase_times_json    = false;
+    cli_options->sources.count                              = 0;
+    cli_options->sources.capacity                           = 0;
+    cli_options->sources.buffer                             = NULL;
 }
 
 void cli_options_destroy(CLIOptions *restrict cli_options) {
-    string_destroy(&cli_options->source);
+    CLISources *sources = &cli_options->sources;
+    for (u64 index = 0; index < sources->count; ++index) {
+        string_destroy(sources->buffer + index);
+    }
+    deallocate(sources->buffer);
+    sources->count    = 0;
+    sources->capacity = 0;
+    sources->buffer   = NULL;
+}
+
+static bool cli_sources_full(CLISources *restrict sources) {
+    return (sources->count + 1) >= sources->capacity;
+}
+
+static void cli_sources_grow(CLISources *restrict sources) {
+    Growth_u64 g      = array_growth_u64(sources->capacity, sizeof(String));
+    sources->buffer   = reallocate(sources->buffer, g.alloc_size);
+    sources->capacity = g.new_capacity;
+}
+
+static void cli_sources_append(CLISources *restrict sources, StringView sv) {
+    if (cli_sources_full(sources)) { cli_sources_grow(sources); }
+
+    String *source = sources->buffer + sources->count++;
+    string_initialize(source);
+    string_assign(source, sv);
 }
 
 #if defined(EXP_HOST_SYSTEM_LINUX)
@@ -51,19 +86,28 @@ static void print_version(FILE *file) {
 }
 
 static void print_help(FILE *file) {
-    file_write(SV("exp [options] <source-file>\n\n"), file);
+    file_write(SV("exp [options] <source-file>...\n\n"), file);
     file_write(SV("\t-h print help.\n"), file);
     file_write(SV("\t-v print version.\n"), file);
     file_write(SV("\t-o <filename> set output filename.\n"), file);
     file_write(SV("\t-c emit an object file.\n"), file);
     file_write(SV("\t-s emit an assembly file.\n"), file);
+    file_write(SV("\t-d encode the object file directly, without as.\n"), file);
+    file_write(SV("\t-b link the executable directly, without ld.\n"), file);
+    file_write(SV("\t-m keep temporary artifacts in memory.\n"), file);
+    file_write(SV("\t-k reuse artifacts from the build cache.\n"), file);
+    file_write(SV("\t-t print the time taken by each phase.\n"), file);
+    file_write(SV("\t-j print the time taken by each phase as JSON.\n"), file);
     file_write(SV("\n"), file);
 }
 
 void parse_cli_options(i32         argc,
                        char const *argv[],
                        CLIOptions *restrict cli_options) {
-    static char const *short_options = "hvpcs";
+    static char const *short_options = "hvpcsdbmktj";
+
+    // a long running process may parse more than one command line.
+    optind = 1;
 
     i32 option = 0;
     while ((option = getopt(argc, (char *const *)argv, short_options)) != -1) {
@@ -99,6 +143,36 @@ void parse_cli_options(i32         argc,
             break;
         }
 
+        case 'd': {
+            cli_options->context_options.encode_object_artifact = true;
+            break;
+        }
+
+        case 'b': {
+            cli_options->context_options.builtin_link_artifact = true;
+            break;
+        }
+
+        case 'm': {
+            cli_options->context_options.stream_artifacts = true;
+            break;
+        }
+
+        case 'k': {
+            cli_options->context_options.cache_artifacts = true;
+            break;
+        }
+
+        case 't': {
+            cli_options->context_options.report_phase_times = true;
+            break;
+        }
+
+        case 'j': {
+            cli_options->context_options.report_phase_times_json = true;
+            break;
+        }
+
         default: {
             char       buf[2]      = {(char)option, '\0'};
             StringView option_view = string_view(buf, 1);
@@ -114,8 +188,10 @@ void parse_cli_options(i32         argc,
     }
 
     if (optind < argc) {
-        string_assign(&(cli_options->source),
-                      string_view_from_cstring(argv[optind]));
+        for (i32 index = optind; index < argc; ++index) {
+            cli_sources_append(&cli_options->sources,
+                               string_view_from_cstring(argv[index]));
+        }
     } else { // no input file given
         message(MESSAGE_ERROR,
                 NULL,
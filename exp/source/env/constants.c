@@ -26,9 +26,13 @@
 
 Constants constants_create() {
     Constants constants;
-    constants.count    = 0;
-    constants.capacity = 0;
-    constants.buffer   = NULL;
+    constants.count          = 0;
+    constants.capacity       = 0;
+    constants.buffer         = NULL;
+    constants.table_capacity = 0;
+    constants.table          = NULL;
+    constants.hits           = 0;
+    constants.misses         = 0;
     return constants;
 }
 
@@ -42,7 +46,12 @@ void constants_destroy(Constants *restrict constants) {
     constants->count    = 0;
     constants->capacity = 0;
     deallocate(constants->buffer);
-    constants->buffer = NULL;
+    constants->buffer         = NULL;
+    constants->table_capacity = 0;
+    deallocate(constants->table);
+    constants->table  = NULL;
+    constants->hits   = 0;
+    constants->misses = 0;
 }
 
 static bool constants_full(Constants *restrict constants) {
@@ -52,28 +61,75 @@ static bool constants_full(Constants *restrict constants) {
 
 static void constants_grow(Constants *restrict constants) {
     assert(constants != NULL);
-    Growth_u32 g        = array_growth_u32(constants->capacity, sizeof(Value));
-    constants->buffer   = reallocate(constants->buffer, g.alloc_size);
+    Growth_u32 g = array_growth_u32(constants->capacity, sizeof(Value));
+    constants->buffer =
+        reallocate_tagged("constants", constants->buffer, g.alloc_size);
     constants->capacity = g.new_capacity;
 }
 
+static bool constants_table_full(Constants *restrict constants) {
+    // the load factor is kept below 3/4
+    return (((u64)constants->count + 1) * 4) >=
+           (constants->table_capacity * 3);
+}
+
+static ConstantsSlot *
+constants_table_find_empty(ConstantsSlot *table, u64 capacity, u64 hash) {
+    u64 mask  = capacity - 1;
+    u64 index = hash & mask;
+    while (table[index].entry != 0) {
+        index = (index + 1) & mask;
+    }
+    return table + index;
+}
+
+static void constants_table_grow(Constants *restrict constants) {
+    Growth_u64 g =
+        array_growth_u64(constants->table_capacity, sizeof(ConstantsSlot));
+    assert((g.new_capacity & (g.new_capacity - 1)) == 0);
+    ConstantsSlot *table =
+        callocate_tagged("constants", g.new_capacity, sizeof(ConstantsSlot));
+
+    for (u64 i = 0; i < constants->table_capacity; ++i) {
+        ConstantsSlot *slot = constants->table + i;
+        if (slot->entry == 0) { continue; }
+        *constants_table_find_empty(table, g.new_capacity, slot->hash) = *slot;
+    }
+
+    deallocate(constants->table);
+    constants->table_capacity = g.new_capacity;
+    constants->table          = table;
+}
+
 Operand constants_append(Constants *restrict constants, Value value) {
     assert(constants != NULL);
-    for (u32 i = 0; i < constants->count; ++i) {
-        Value *v = constants->buffer + i;
-        if (value_equality(v, &value)) {
+    if (constants_table_full(constants)) { constants_table_grow(constants); }
+
+    u64 hash  = value_hash(&value);
+    u64 mask  = constants->table_capacity - 1;
+    u64 probe = hash & mask;
+    while (constants->table[probe].entry != 0) {
+        ConstantsSlot *slot = constants->table + probe;
+        u32            i    = slot->entry - 1;
+        if ((slot->hash == hash) &&
+            value_equality(constants->buffer + i, &value)) {
             value_destroy(&value);
+            constants->hits += 1;
             return operand_constant(i);
         }
+
+        probe = (probe + 1) & mask;
     }
 
     if (constants_full(constants)) { constants_grow(constants); }
 
     u32 index = constants->count;
-    assert(constants != NULL);
     constants->buffer[constants->count] = value;
     constants->count += 1;
+    constants->misses += 1;
 
+    constants->table[probe].hash  = hash;
+    constants->table[probe].entry = index + 1;
     return operand_constant(index);
 }
 
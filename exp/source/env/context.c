@@ -24,6 +24,7 @@
 #include "codegen/x86/env/context.h"
 #include "env/context.h"
 #include "env/context_options.h"
+#include "support/allocation.h"
 #include "support/config.h"
 #include "support/io.h"
 #include "support/string_view.h"
@@ -55,6 +56,7 @@ void context_create(Context *restrict context,
     string_initialize(&(context->executable_path));
     string_initialize(&(context->library_path));
     string_assign(&(context->source_path), source_path);
+    context->source = (MappedFile){};
     generate_path_from_source(
         &(context->ir_path), source_path, SV(EXP_IR_EXTENSION));
     generate_path_from_source(
@@ -66,17 +68,20 @@ void context_create(Context *restrict context,
     generate_path_from_source(
         &(context->library_path), source_path, SV(EXP_LIB_EXTENSION));
     context->current_function    = nullptr;
+    context->function_cache      = nullptr;
     context->current_error       = error_create();
     context->global_symbol_table = symbol_table_create();
-    // context->global_labels       = labels_create();
+    context->global_labels       = labels_create();
     context->constants       = constants_create();
     context->string_interner = string_interner_create();
     context->type_interner   = type_interner_create();
+    context->arena           = arena_create();
 }
 
 void context_destroy(Context *context) {
     assert(context != nullptr);
     string_destroy(&(context->source_path));
+    file_unmap(&(context->source));
     string_destroy(&(context->ir_path));
     string_destroy(&(context->assembly_path));
     string_destroy(&(context->object_path));
@@ -85,10 +90,12 @@ void context_destroy(Context *context) {
     string_interner_destroy(&(context->string_interner));
     type_interner_destroy(&(context->type_interner));
     symbol_table_destroy(&(context->global_symbol_table));
-    // labels_destroy(&(context->global_labels));
+    labels_destroy(&(context->global_labels));
     constants_destroy(&(context->constants));
     error_destroy(&context->current_error);
     context->current_function = nullptr;
+    // after the symbol table, as every Local lives in the arena.
+    arena_destroy(&context->arena);
 }
 
 bool context_shall_prolix(Context const *context) {
@@ -124,6 +131,39 @@ bool context_shall_cleanup_object_artifact(Context const *context) {
     assert(context != nullptr);
     return context->options.cleanup_object_artifact;
 }
+bool context_shall_encode_object_artifact(Context const *context) {
+    assert(context != nullptr);
+    return context->options.create_object_artifact &&
+           context->options.encode_object_artifact;
+}
+bool context_shall_builtin_link_artifact(Context const *context) {
+    assert(context != nullptr);
+    return context->options.builtin_link_artifact;
+}
+bool context_shall_stream_assembly_artifact(Context const *context) {
+    assert(context != nullptr);
+    // a temporary assembly artifact is piped directly to as(1)
+    return context->options.stream_artifacts &&
+           context->options.create_object_artifact &&
+           !context->options.encode_object_artifact &&
+           context->options.cleanup_assembly_artifact;
+}
+bool context_shall_stream_object_artifact(Context const *context) {
+    assert(context != nullptr);
+    // a temporary object artifact is kept in a memory file
+    return context->options.stream_artifacts &&
+           context->options.create_executable_artifact &&
+           context->options.cleanup_object_artifact;
+}
+bool context_shall_cache_artifacts(Context const *context) {
+    assert(context != nullptr);
+    return context->options.cache_artifacts;
+}
+bool context_shall_report_phase_times(Context const *context) {
+    assert(context != nullptr);
+    return context->options.prolix || context->options.report_phase_times ||
+           context->options.report_phase_times_json;
+}
 
 void context_create_ir_artifact(Context *restrict context) {
     assert(context != NULL);
@@ -139,9 +179,9 @@ void context_create_ir_artifact(Context *restrict context) {
     ir_directive_file(string_to_view(&context->source_path), &contents);
 
     SymbolTable *symbol_table = &context->global_symbol_table;
-    for (u64 index = 0; index < symbol_table->capacity; ++index) {
-        Symbol *symbol = symbol_table->elements[index];
-        if (symbol == NULL) { continue; }
+    Symbol     **symbols      = symbol_table_sorted(symbol_table);
+    for (u64 index = 0; index < symbol_table->count; ++index) {
+        Symbol *symbol = symbols[index];
 
         if (symbol->kind == SYMBOL_KIND_FUNCTION) {
             ir_directive_function(symbol->name, &contents);
@@ -149,6 +189,7 @@ void context_create_ir_artifact(Context *restrict context) {
             string_append(&contents, SV("\n"));
         }
     }
+    deallocate(symbols);
 
     FILE *ir_file = file_open(string_to_cstring(&ir_path), "w");
     file_write(string_to_view(&contents), ir_file);
@@ -160,12 +201,12 @@ void context_create_ir_artifact(Context *restrict context) {
 void context_create_assembly_artifact(Context *restrict context) {
     x86_Context  x86_context = x86_context_create(context);
     SymbolTable *table       = &context->global_symbol_table;
+    Symbol     **symbols     = symbol_table_sorted(table);
 
-    for (u64 index = 0; index < table->capacity; ++index) {
-        Symbol *element = table->elements[index];
-        if (element == NULL) { continue; }
-        x86_codegen_symbol(element, &x86_context);
+    for (u64 index = 0; index < table->count; ++index) {
+        x86_codegen_symbol(symbols[index], &x86_context);
     }
+    deallocate(symbols);
 
     x86_emit(&x86_context);
     x86_context_destroy(&x86_context);
@@ -182,6 +223,15 @@ StringView context_source_path(Context const *restrict context) {
     return string_to_view(&(context->source_path));
 }
 
+StringView context_source(Context *restrict context) {
+    assert(context != nullptr);
+    MappedFile *source = &(context->source);
+    if (source->contents == nullptr) {
+        file_map(source, string_to_cstring(&(context->source_path)));
+    }
+    return string_view(source->contents, source->length);
+}
+
 StringView context_ir_path(Context const *context) {
     assert(context != nullptr);
     return string_to_view(&(context->ir_path));
@@ -197,6 +247,11 @@ StringView context_object_path(Context const *context) {
     return string_to_view(&context->object_path);
 }
 
+void context_assign_object_path(Context *restrict context, StringView path) {
+    assert(context != nullptr);
+    string_assign(&context->object_path, path);
+}
+
 StringView context_executable_path(Context const *context) {
     assert(context != nullptr);
     return string_to_view(&(context->executable_path));
@@ -280,15 +335,15 @@ Type const *context_function_type(Context    *context,
         &context->type_interner, return_type, argument_types);
 }
 
-// u32 context_labels_insert(Context *context, StringView symbol) {
-//     assert(context != nullptr);
-//     return labels_insert(&context->global_labels, symbol);
-// }
+u32 context_labels_insert(Context *context, ConstantString *label) {
+    assert(context != nullptr);
+    return labels_insert(&context->global_labels, label);
+}
 
-// StringView context_labels_at(Context *context, u32 index) {
-//     assert(context != nullptr);
-//     return labels_at(&context->global_labels, index);
-// }
+ConstantString *context_labels_at(Context *context, u32 index) {
+    assert(context != nullptr);
+    return labels_at(&context->global_labels, index);
+}
 
 Symbol *context_global_symbol_table_at(Context *context, StringView name) {
     assert(context != nullptr);
@@ -319,13 +374,13 @@ Bytecode *context_active_bytecode(Context *c) {
 Local *context_declare_argument(Context *c) {
     assert(c != nullptr);
     assert(c->current_function != nullptr);
-    return function_declare_argument(c->current_function);
+    return function_declare_argument(c->current_function, &c->arena);
 }
 
 Local *context_declare_local(Context *c) {
     assert(c != nullptr);
     assert(c->current_function != nullptr);
-    return function_declare_local(c->current_function);
+    return function_declare_local(c->current_function, &c->arena);
 }
 
 Local *context_lookup_argument(Context *c, u8 index) {
@@ -340,12 +395,30 @@ Local *context_lookup_local(Context *c, u32 ssa) {
     return function_lookup_local(c->current_function, ssa);
 }
 
-Local *context_lookup_local_name(Context *c, StringView name) {
+Local *context_lookup_local_name(Context *c, ConstantString const *name) {
     assert(c != nullptr);
     assert(c->current_function != nullptr);
     return function_lookup_local_name(c->current_function, name);
 }
 
+void context_enter_scope(Context *c) {
+    assert(c != nullptr);
+    assert(c->current_function != nullptr);
+    function_enter_scope(c->current_function);
+}
+
+void context_leave_scope(Context *c) {
+    assert(c != nullptr);
+    assert(c->current_function != nullptr);
+    function_leave_scope(c->current_function);
+}
+
+void context_bind_local(Context *c, Local *local, ConstantString const *name) {
+    assert(c != nullptr);
+    assert(c->current_function != nullptr);
+    function_bind_local(c->current_function, local, name);
+}
+
 void context_leave_function(Context *c) {
     assert(c != nullptr);
     c->current_function = nullptr;
@@ -361,6 +434,18 @@ Value *context_constants_at(Context *context, u32 index) {
     return constants_at(&(context->constants), index);
 }
 
+Operand context_immediate_i64(Context *context, i64 value) {
+    assert(context != nullptr);
+    if (i64_in_range_i32(value)) { return operand_i64(value); }
+    return context_constants_append(context, value_create_i64(value));
+}
+
+Operand context_immediate_u64(Context *context, u64 value) {
+    assert(context != nullptr);
+    if (u64_in_range_u32(value)) { return operand_u64(value); }
+    return context_constants_append(context, value_create_u64(value));
+}
+
 void context_emit_return(Context *c, Operand B) {
     assert(c != nullptr);
     bytecode_append(context_active_bytecode(c), instruction_return(B));
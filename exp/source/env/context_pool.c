@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+
+#include "env/context_pool.h"
+#include "support/allocation.h"
+#include "support/array_growth.h"
+
+void context_pool_create(ContextPool *restrict pool) {
+    assert(pool != nullptr);
+    pool->count    = 0;
+    pool->capacity = 0;
+    pool->buffer   = nullptr;
+}
+
+void context_pool_destroy(ContextPool *restrict pool) {
+    assert(pool != nullptr);
+    for (u64 index = 0; index < pool->count; ++index) {
+        ContextPoolEntry *entry = pool->buffer + index;
+        string_interner_destroy(&entry->string_interner);
+        type_interner_destroy(&entry->type_interner);
+    }
+
+    deallocate(pool->buffer);
+    context_pool_create(pool);
+}
+
+static bool context_pool_full(ContextPool const *restrict pool) {
+    return (pool->count + 1) >= pool->capacity;
+}
+
+static void context_pool_grow(ContextPool *restrict pool) {
+    Growth_u64 g   = array_growth_u64(pool->capacity, sizeof(ContextPoolEntry));
+    pool->buffer   = reallocate(pool->buffer, g.alloc_size);
+    pool->capacity = g.new_capacity;
+}
+
+void context_pool_acquire(ContextPool *restrict pool,
+                          Context *restrict context) {
+    assert(pool != nullptr);
+    assert(context != nullptr);
+    if (pool->count == 0) { return; }
+
+    ContextPoolEntry *entry = pool->buffer + --pool->count;
+    // a freshly created context owns no interned strings or types.
+    string_interner_destroy(&context->string_interner);
+    type_interner_destroy(&context->type_interner);
+    context->string_interner = entry->string_interner;
+    context->type_interner   = entry->type_interner;
+}
+
+void context_pool_release(ContextPool *restrict pool,
+                          Context *restrict context) {
+    assert(pool != nullptr);
+    assert(context != nullptr);
+    if (context_pool_full(pool)) { context_pool_grow(pool); }
+
+    ContextPoolEntry *entry = pool->buffer + pool->count++;
+    entry->string_interner  = context->string_interner;
+    entry->type_interner    = context->type_interner;
+    string_interner_clear(&entry->string_interner);
+    type_interner_clear(&entry->type_interner);
+
+    context->string_interner = string_interner_create();
+    context->type_interner   = type_interner_create();
+}
@@ -0,0 +1,582 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "env/function_cache.h"
+#include "support/hash.h"
+#include "support/io.h"
+#include "support/panic.h"
+
+/*
+ * an entry holds, in order: the key, the type of the symbol, the
+ * return type, the number of arguments, the locals, and the
+ * instructions of the function. the entries are only read by the
+ * compiler which wrote them, so scalars are written in host order.
+ * constants and labels are written inline, as their indices and
+ * addresses are meaningless to another context.
+ */
+#define FUNCTION_CACHE_NO_TYPE 0xFF
+
+/*
+ * folded into the seed, such that entries written in an earlier
+ * layout are never read. bump this whenever the layout changes.
+ */
+#define FUNCTION_CACHE_FORMAT 1
+
+void function_cache_create(FunctionCache *restrict cache,
+                           StringView directory,
+                           u64        seed) {
+    assert(cache != nullptr);
+    cache->directory = string_from_view(directory);
+    u32 format       = FUNCTION_CACHE_FORMAT;
+    cache->seed      = hash_fnv1a(seed, &format, sizeof(format));
+}
+
+void function_cache_destroy(FunctionCache *restrict cache) {
+    assert(cache != nullptr);
+    string_destroy(&cache->directory);
+}
+
+static void function_cache_entry_path(FunctionCache const *restrict cache,
+                                      u64 key,
+                                      String *restrict path) {
+    u64 hash = hash_fnv1a(cache->seed, &key, sizeof(key));
+
+    static char const digits[] = "0123456789abcdef";
+    char              hex[16];
+    for (u64 index = 0; index < sizeof(hex); ++index) {
+        hex[index] = digits[(hash >> (60 - (index * 4))) & 0xF];
+    }
+
+    string_assign(path, string_to_view(&cache->directory));
+    string_append(path, SV("/"));
+    string_append(path, string_view(hex, sizeof(hex)));
+    string_append(path, SV(".fn"));
+}
+
+static void write_bytes(String *restrict buffer, void const *bytes, u64 size) {
+    string_append(buffer, string_view((char const *)bytes, size));
+}
+
+static void write_u8(String *restrict buffer, u8 value) {
+    write_bytes(buffer, &value, sizeof(value));
+}
+
+static void write_u32(String *restrict buffer, u32 value) {
+    write_bytes(buffer, &value, sizeof(value));
+}
+
+static void write_text(String *restrict buffer, StringView text) {
+    assert(text.length <= u32_MAX);
+    write_u32(buffer, (u32)text.length);
+    write_bytes(buffer, text.ptr, text.length);
+}
+
+static void write_type(String *restrict buffer, Type const *type);
+
+static void write_tuple_type(String *restrict buffer,
+                             TupleType const *restrict tuple) {
+    write_u32(buffer, tuple->size);
+    for (u32 index = 0; index < tuple->size; ++index) {
+        write_type(buffer, tuple->types[index]);
+    }
+}
+
+static void write_type(String *restrict buffer, Type const *type) {
+    if (type == nullptr) {
+        write_u8(buffer, FUNCTION_CACHE_NO_TYPE);
+        return;
+    }
+
+    write_u8(buffer, (u8)type->kind);
+    switch (type->kind) {
+    case TYPE_KIND_TUPLE: write_tuple_type(buffer, &type->tuple_type); break;
+
+    case TYPE_KIND_FUNCTION:
+        write_type(buffer, type->function_type.return_type);
+        write_tuple_type(buffer, &type->function_type.argument_types);
+        break;
+
+    default: break;
+    }
+}
+
+static void write_value(String *restrict buffer,
+                        Value const *restrict value,
+                        Context *restrict context);
+
+static void write_operand(String *restrict buffer,
+                          OperandKind kind,
+                          OperandData data,
+                          Context *restrict context) {
+    write_u8(buffer, kind);
+    switch (kind) {
+    case OPERAND_KIND_SSA: write_u32(buffer, data.ssa); break;
+    case OPERAND_KIND_CONSTANT: {
+        Value const *value = context_constants_at(context, data.constant);
+        write_value(buffer, value, context);
+        break;
+    }
+    case OPERAND_KIND_LABEL:
+        write_text(buffer,
+                   constant_string_to_view(
+                       context_labels_at(context, data.label)));
+        break;
+    case OPERAND_KIND_U8:  write_u8(buffer, data.u8_); break;
+    case OPERAND_KIND_U16: write_bytes(buffer, &data.u16_, sizeof(u16)); break;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64: write_bytes(buffer, &data.u32_, sizeof(u32)); break;
+    case OPERAND_KIND_I8:  write_bytes(buffer, &data.i8_, sizeof(i8)); break;
+    case OPERAND_KIND_I16: write_bytes(buffer, &data.i16_, sizeof(i16)); break;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64: write_bytes(buffer, &data.i32_, sizeof(i32)); break;
+    default:               PANIC("unknown operand kind");
+    }
+}
+
+static void write_value(String *restrict buffer,
+                        Value const *restrict value,
+                        Context *restrict context) {
+    write_u8(buffer, (u8)value->kind);
+    switch (value->kind) {
+    case VALUE_KIND_UNINITIALIZED:
+    case VALUE_KIND_NIL:           break;
+    case VALUE_KIND_BOOLEAN:       write_u8(buffer, value->boolean); break;
+    case VALUE_KIND_U8:            write_u8(buffer, value->u8_); break;
+    case VALUE_KIND_U16: write_bytes(buffer, &value->u16_, sizeof(u16)); break;
+    case VALUE_KIND_U32: write_bytes(buffer, &value->u32_, sizeof(u32)); break;
+    case VALUE_KIND_U64: write_bytes(buffer, &value->u64_, sizeof(u64)); break;
+    case VALUE_KIND_I8:  write_bytes(buffer, &value->i8_, sizeof(i8)); break;
+    case VALUE_KIND_I16: write_bytes(buffer, &value->i16_, sizeof(i16)); break;
+    case VALUE_KIND_I32: write_bytes(buffer, &value->i32_, sizeof(i32)); break;
+    case VALUE_KIND_I64: write_bytes(buffer, &value->i64_, sizeof(i64)); break;
+
+    case VALUE_KIND_TUPLE: {
+        Tuple const *tuple = &value->tuple;
+        write_u32(buffer, tuple->size);
+        for (u32 index = 0; index < tuple->size; ++index) {
+            Operand element = tuple->elements[index];
+            write_operand(buffer, element.kind, element.data, context);
+        }
+        break;
+    }
+
+    default: PANIC("unknown value kind");
+    }
+}
+
+static void write_function(String *restrict buffer,
+                           Symbol *restrict symbol,
+                           Context *restrict context) {
+    Function *body = &symbol->function_body;
+    write_bytes(buffer, &symbol->cache_key, sizeof(symbol->cache_key));
+    write_type(buffer, symbol->type);
+    write_type(buffer, body->return_type);
+
+    // the arguments are always the first locals declared.
+    write_u8(buffer, body->arguments.size);
+    write_u32(buffer, body->locals.count);
+    for (u32 index = 0; index < body->locals.count; ++index) {
+        Local const *local = body->locals.buffer[index];
+        assert(local->ssa == index);
+        write_text(buffer, local->name);
+        write_type(buffer, local->type);
+        write_u32(buffer, local->lifetime.start);
+        write_u32(buffer, local->lifetime.end);
+    }
+
+    write_u32(buffer, body->bc.length);
+    for (u32 index = 0; index < body->bc.length; ++index) {
+        Instruction const *I = body->bc.buffer + index;
+        write_u8(buffer, I->opcode);
+        write_operand(buffer, I->A_kind, I->A_data, context);
+        write_operand(buffer, I->B_kind, I->B_data, context);
+        write_operand(buffer, I->C_kind, I->C_data, context);
+    }
+}
+
+/**
+ * @brief the bytes of an entry, a read past the end marks the
+ * whole entry invalid, and reads as zero.
+ */
+typedef struct FunctionCacheReader {
+    u8 const *cursor;
+    u8 const *end;
+    bool      valid;
+} FunctionCacheReader;
+
+static u64 reader_remaining(FunctionCacheReader const *restrict reader) {
+    return (u64)(reader->end - reader->cursor);
+}
+
+static void
+read_bytes(FunctionCacheReader *restrict reader, void *bytes, u64 size) {
+    if (!reader->valid || (reader_remaining(reader) < size)) {
+        reader->valid = false;
+        memset(bytes, 0, size);
+        return;
+    }
+
+    memcpy(bytes, reader->cursor, size);
+    reader->cursor += size;
+}
+
+static u8 read_u8(FunctionCacheReader *restrict reader) {
+    u8 value;
+    read_bytes(reader, &value, sizeof(value));
+    return value;
+}
+
+static u32 read_u32(FunctionCacheReader *restrict reader) {
+    u32 value;
+    read_bytes(reader, &value, sizeof(value));
+    return value;
+}
+
+static StringView read_text(FunctionCacheReader *restrict reader) {
+    u32 length = read_u32(reader);
+    if (!reader->valid || (reader_remaining(reader) < length)) {
+        reader->valid = false;
+        return SV("");
+    }
+
+    StringView text = string_view((char const *)reader->cursor, length);
+    reader->cursor += length;
+    return text;
+}
+
+/**
+ * @brief a count of elements which are each at least one byte long
+ */
+static u32 read_count(FunctionCacheReader *restrict reader) {
+    u32 count = read_u32(reader);
+    if (reader_remaining(reader) < count) {
+        reader->valid = false;
+        return 0;
+    }
+    return count;
+}
+
+static Type const *read_type(FunctionCacheReader *restrict reader,
+                             Context *restrict context);
+
+static TupleType read_tuple_type(FunctionCacheReader *restrict reader,
+                                 Context *restrict context) {
+    TupleType tuple = tuple_type_create();
+    u32       size  = read_count(reader);
+    for (u32 index = 0; reader->valid && (index < size); ++index) {
+        Type const *type = read_type(reader, context);
+        if (type == nullptr) {
+            reader->valid = false;
+            break;
+        }
+        tuple_type_append(&tuple, type);
+    }
+    return tuple;
+}
+
+static Type const *read_type(FunctionCacheReader *restrict reader,
+                             Context *restrict context) {
+    u8 kind = read_u8(reader);
+    if (!reader->valid) { return nullptr; }
+
+    switch (kind) {
+    case FUNCTION_CACHE_NO_TYPE: return nullptr;
+    case TYPE_KIND_NIL:          return context_nil_type(context);
+    case TYPE_KIND_BOOLEAN:      return context_boolean_type(context);
+    case TYPE_KIND_U8:           return context_u8_type(context);
+    case TYPE_KIND_U16:          return context_u16_type(context);
+    case TYPE_KIND_U32:          return context_u32_type(context);
+    case TYPE_KIND_U64:          return context_u64_type(context);
+    case TYPE_KIND_I8:           return context_i8_type(context);
+    case TYPE_KIND_I16:          return context_i16_type(context);
+    case TYPE_KIND_I32:          return context_i32_type(context);
+    case TYPE_KIND_I64:          return context_i64_type(context);
+
+    case TYPE_KIND_TUPLE: {
+        TupleType tuple = read_tuple_type(reader, context);
+        if (!reader->valid) {
+            tuple_type_destroy(&tuple);
+            return nullptr;
+        }
+        return context_tuple_type(context, tuple);
+    }
+
+    case TYPE_KIND_FUNCTION: {
+        Type const *return_type    = read_type(reader, context);
+        TupleType   argument_types = read_tuple_type(reader, context);
+        if (!reader->valid || (return_type == nullptr)) {
+            reader->valid = false;
+            tuple_type_destroy(&argument_types);
+            return nullptr;
+        }
+        return context_function_type(context, return_type, argument_types);
+    }
+
+    default: reader->valid = false; return nullptr;
+    }
+}
+
+static Value read_value(FunctionCacheReader *restrict reader,
+                        Context *restrict context);
+
+static Operand read_operand(FunctionCacheReader *restrict reader,
+                            Context *restrict context) {
+    Operand operand = {.kind = read_u8(reader)};
+    switch (operand.kind) {
+    case OPERAND_KIND_SSA: operand.data.ssa = read_u32(reader); break;
+
+    case OPERAND_KIND_CONSTANT: {
+        Value value = read_value(reader, context);
+        if (!reader->valid) {
+            value_destroy(&value);
+            break;
+        }
+        operand = context_constants_append(context, value);
+        break;
+    }
+
+    case OPERAND_KIND_LABEL: {
+        StringView label = read_text(reader);
+        if (!reader->valid) { break; }
+        operand.data.label =
+            context_labels_insert(context, context_intern(context, label));
+        break;
+    }
+
+    case OPERAND_KIND_U8: operand.data.u8_ = read_u8(reader); break;
+    case OPERAND_KIND_U16:
+        read_bytes(reader, &operand.data.u16_, sizeof(u16));
+        break;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64:
+        read_bytes(reader, &operand.data.u32_, sizeof(u32));
+        break;
+    case OPERAND_KIND_I8:
+        read_bytes(reader, &operand.data.i8_, sizeof(i8));
+        break;
+    case OPERAND_KIND_I16:
+        read_bytes(reader, &operand.data.i16_, sizeof(i16));
+        break;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64:
+        read_bytes(reader, &operand.data.i32_, sizeof(i32));
+        break;
+
+    default: reader->valid = false; break;
+    }
+    return operand;
+}
+
+static Value read_value(FunctionCacheReader *restrict reader,
+                        Context *restrict context) {
+    Value value = value_create();
+    u8    kind  = read_u8(reader);
+    switch (kind) {
+    case VALUE_KIND_UNINITIALIZED: break;
+    case VALUE_KIND_NIL:           value = value_create_nil(); break;
+    case VALUE_KIND_BOOLEAN:
+        value = value_create_boolean(read_u8(reader) != 0);
+        break;
+    case VALUE_KIND_U8: value = value_create_u8(read_u8(reader)); break;
+
+    case VALUE_KIND_U16:
+    case VALUE_KIND_U32:
+    case VALUE_KIND_U64:
+    case VALUE_KIND_I8:
+    case VALUE_KIND_I16:
+    case VALUE_KIND_I32:
+    case VALUE_KIND_I64: {
+        static u8 const sizes[] = {
+            [VALUE_KIND_U16] = sizeof(u16),
+            [VALUE_KIND_U32] = sizeof(u32),
+            [VALUE_KIND_U64] = sizeof(u64),
+            [VALUE_KIND_I8]  = sizeof(i8),
+            [VALUE_KIND_I16] = sizeof(i16),
+            [VALUE_KIND_I32] = sizeof(i32),
+            [VALUE_KIND_I64] = sizeof(i64),
+        };
+        value.kind = (ValueKind)kind;
+        // each scalar member begins at the start of the union.
+        read_bytes(reader, &value.u64_, sizes[kind]);
+        break;
+    }
+
+    case VALUE_KIND_TUPLE: {
+        Tuple tuple;
+        tuple_create(&tuple);
+        u32 size = read_count(reader);
+        for (u32 index = 0; reader->valid && (index < size); ++index) {
+            tuple_append(&tuple, read_operand(reader, context));
+        }
+        value = value_create_tuple(tuple);
+        break;
+    }
+
+    default: reader->valid = false; break;
+    }
+    return value;
+}
+
+static void read_function(FunctionCacheReader *restrict reader,
+                          Context *restrict context,
+                          Symbol *restrict symbol,
+                          Function *restrict body,
+                          Type const **restrict type) {
+    u64 key = 0;
+    read_bytes(reader, &key, sizeof(key));
+    if (key != symbol->cache_key) { reader->valid = false; }
+
+    *type             = read_type(reader, context);
+    body->return_type = read_type(reader, context);
+    if ((*type == nullptr) || (body->return_type == nullptr)) {
+        reader->valid = false;
+    }
+
+    u8  arguments = read_u8(reader);
+    u32 locals    = read_count(reader);
+    if (arguments > locals) { reader->valid = false; }
+
+    for (u32 index = 0; reader->valid && (index < locals); ++index) {
+        Local *local = (index < arguments)
+                         ? function_declare_argument(body, &context->arena)
+                         : function_declare_local(body, &context->arena);
+        StringView name = read_text(reader);
+        if (!reader->valid) { break; }
+        local->name =
+            constant_string_to_view(context_intern(context, name));
+        local->type           = read_type(reader, context);
+        local->lifetime.start = read_u32(reader);
+        local->lifetime.end   = read_u32(reader);
+    }
+
+    u32 length = read_count(reader);
+    for (u32 index = 0; reader->valid && (index < length); ++index) {
+        Instruction I = {.opcode = read_u8(reader)};
+        Operand     A = read_operand(reader, context);
+        Operand     B = read_operand(reader, context);
+        Operand     C = read_operand(reader, context);
+        I.A_kind      = A.kind;
+        I.A_data      = A.data;
+        I.B_kind      = B.kind;
+        I.B_data      = B.data;
+        I.C_kind      = C.kind;
+        I.C_data      = C.data;
+        bytecode_append(&body->bc, I);
+    }
+
+    if (reader->cursor != reader->end) { reader->valid = false; }
+}
+
+bool function_cache_retrieve(FunctionCache const *restrict cache,
+                             Context *restrict context,
+                             Symbol *restrict symbol) {
+    assert(cache != nullptr);
+    assert(context != nullptr);
+    assert(symbol != nullptr);
+    if ((symbol->cache_key == 0) || (symbol->kind != SYMBOL_KIND_UNDEFINED)) {
+        return false;
+    }
+
+    String path = string_create();
+    function_cache_entry_path(cache, symbol->cache_key, &path);
+    if (access(string_to_cstring(&path), F_OK) != 0) {
+        string_destroy(&path);
+        return false;
+    }
+
+    FILE  *file  = file_open(string_to_cstring(&path), "r");
+    String bytes = string_from_file(file);
+    file_close(file);
+    string_destroy(&path);
+
+    u8 const           *begin  = (u8 const *)string_to_cstring(&bytes);
+    FunctionCacheReader reader = {
+        .cursor = begin, .end = begin + bytes.length, .valid = true};
+    Function    body;
+    Type const *type = nullptr;
+    function_create(&body);
+    read_function(&reader, context, symbol, &body, &type);
+    string_destroy(&bytes);
+
+    // anything interned while reading an invalid entry is left unused.
+    if (!reader.valid) {
+        function_destroy(&body);
+        return false;
+    }
+
+    function_destroy(&symbol->function_body);
+    symbol->function_body = body;
+    symbol->kind          = SYMBOL_KIND_FUNCTION;
+    symbol->type          = type;
+    symbol->cached        = true;
+    return true;
+}
+
+static void function_cache_write_entry(FunctionCache const *restrict cache,
+                                       Context *restrict context,
+                                       Symbol *restrict symbol) {
+    String bytes = string_create();
+    write_function(&bytes, symbol, context);
+
+    String path = string_create();
+    function_cache_entry_path(cache, symbol->cache_key, &path);
+
+    // the same function may be stored by another context at the same
+    // time, so the temporary file is unique to this context.
+    String temporary = string_create();
+    string_assign(&temporary, string_to_view(&path));
+    string_append(&temporary, SV(".tmp"));
+    string_append_u64(&temporary, (u64)getpid());
+    string_append(&temporary, SV("."));
+    string_append_u64(&temporary, (u64)(uintptr_t)context);
+
+    FILE *file = file_open(string_to_cstring(&temporary), "w");
+    file_write(string_to_view(&bytes), file);
+    file_close(file);
+
+    if (rename(string_to_cstring(&temporary), string_to_cstring(&path)) != 0) {
+        PANIC_ERRNO("rename failed");
+    }
+
+    string_destroy(&temporary);
+    string_destroy(&path);
+    string_destroy(&bytes);
+}
+
+void function_cache_store(FunctionCache const *restrict cache,
+                          Context *restrict context) {
+    assert(cache != nullptr);
+    assert(context != nullptr);
+    SymbolTable *table = &context->global_symbol_table;
+    for (u64 index = 0; index < table->capacity; ++index) {
+        Symbol *symbol = table->elements[index];
+        if ((symbol == nullptr) || (symbol->kind != SYMBOL_KIND_FUNCTION) ||
+            (symbol->cache_key == 0) || symbol->cached ||
+            (symbol->type == nullptr)) {
+            continue;
+        }
+
+        function_cache_write_entry(cache, context, symbol);
+    }
+}
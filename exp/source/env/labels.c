@@ -15,53 +15,53 @@
 // You should have received a copy of the GNU General Public License
 // along with exp.  If not, see <https://www.gnu.org/licenses/>.
 #include <assert.h>
-#include <stddef.h>
 
 #include "env/labels.h"
 #include "support/allocation.h"
 #include "support/array_growth.h"
 
 Labels labels_create() {
-    Labels symbols = {.count = 0, .capacity = 0, .buffer = NULL};
-    return symbols;
+    Labels labels = {.count = 0, .capacity = 0, .buffer = nullptr};
+    return labels;
 }
 
-void labels_destroy(Labels *restrict symbols) {
-    assert(symbols != NULL);
-    deallocate(symbols->buffer);
-    symbols->buffer   = NULL;
-    symbols->count    = 0;
-    symbols->capacity = 0;
+void labels_destroy(Labels *restrict labels) {
+    assert(labels != nullptr);
+    deallocate(labels->buffer);
+    labels->buffer   = nullptr;
+    labels->count    = 0;
+    labels->capacity = 0;
 }
 
-static bool global_labels_full(Labels *restrict symbols) {
-    return (symbols->count + 1) >= symbols->capacity;
+static bool labels_full(Labels *restrict labels) {
+    return (labels->count + 1) >= labels->capacity;
 }
 
-static void global_labels_grow(Labels *restrict symbols) {
-    Growth_u32 g      = array_growth_u32(symbols->capacity, sizeof(StringView));
-    symbols->buffer   = reallocate(symbols->buffer, g.alloc_size);
-    symbols->capacity = g.new_capacity;
+static void labels_grow(Labels *restrict labels) {
+    Growth_u32 g =
+        array_growth_u32(labels->capacity, sizeof(ConstantString *));
+    labels->buffer   = reallocate(labels->buffer, g.alloc_size);
+    labels->capacity = g.new_capacity;
 }
 
-u32 labels_insert(Labels *restrict symbols, StringView symbol) {
-    assert(symbols != NULL);
+u32 labels_insert(Labels *restrict labels, ConstantString *label) {
+    assert(labels != nullptr);
+    assert(label != nullptr);
 
-    if (global_labels_full(symbols)) { global_labels_grow(symbols); }
-
-    for (u32 i = 0; i < symbols->count; ++i) {
-        StringView s = symbols->buffer[i];
-        if (string_view_equal(s, symbol)) { return i; }
+    for (u32 index = 0; index < labels->count; ++index) {
+        if (labels->buffer[index] == label) { return index; }
     }
 
-    u32 index              = symbols->count;
-    symbols->buffer[index] = symbol;
-    symbols->count += 1;
+    if (labels_full(labels)) { labels_grow(labels); }
+
+    u32 index             = labels->count;
+    labels->buffer[index] = label;
+    labels->count += 1;
     return index;
 }
 
-StringView labels_at(Labels *restrict symbols, u32 index) {
-    assert(symbols != NULL);
-    assert(index < symbols->count);
-    return symbols->buffer[index];
+ConstantString *labels_at(Labels const *restrict labels, u32 index) {
+    assert(labels != nullptr);
+    assert(index < labels->count);
+    return labels->buffer[index];
 }
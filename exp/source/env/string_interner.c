@@ -17,7 +17,6 @@
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -26,80 +25,101 @@
 #include "support/array_growth.h"
 #include "support/hash.h"
 
-#define STRING_INTERNER_MAX_LOAD 0.75
-
 StringInterner string_interner_create() {
     StringInterner string_interner;
     string_interner.count    = 0;
     string_interner.capacity = 0;
     string_interner.buffer   = NULL;
+    string_interner.arena    = arena_create();
     return string_interner;
 }
 
 void string_interner_destroy(StringInterner *restrict string_interner) {
     assert(string_interner != NULL);
-
-    if (string_interner->buffer == NULL) {
-        string_interner->capacity = 0;
-        string_interner->count    = 0;
-        return;
-    }
-
-    for (u64 i = 0; i < string_interner->capacity; ++i) {
-        if (string_interner->buffer[i] == NULL) { continue; }
-        deallocate(string_interner->buffer[i]);
-    }
-
+    arena_destroy(&string_interner->arena);
     string_interner->capacity = 0;
     string_interner->count    = 0;
     deallocate(string_interner->buffer);
     string_interner->buffer = NULL;
 }
 
-static ConstantString **string_interner_find(ConstantString **restrict strings,
-                                             u64        capacity,
-                                             StringView sv) {
-    u64 index = hash_cstring(sv.ptr, sv.length) % capacity;
-    while (1) {
-        ConstantString **element = &(strings[index]);
-        if ((*element == NULL) || (constant_string_equal(*element, sv))) {
-            return element;
-        }
+void string_interner_clear(StringInterner *restrict string_interner) {
+    assert(string_interner != NULL);
+    arena_clear(&string_interner->arena);
 
-        index = (index + 1) % capacity;
+    if (string_interner->buffer != NULL) {
+        memset(string_interner->buffer,
+               0,
+               string_interner->capacity * sizeof(StringInternerSlot));
     }
+    string_interner->count = 0;
 }
 
-static void string_interner_grow(StringInterner *restrict string_interner) {
-    Growth_u64       g = array_growth_u64(string_interner->capacity,
-                                    sizeof(*string_interner->buffer));
-    ConstantString **elements =
-        callocate(g.new_capacity, sizeof(*string_interner->buffer));
+static ConstantString *
+string_interner_allocate(StringInterner *restrict string_interner,
+                         StringView sv) {
+    ConstantString *string =
+        arena_allocate(&string_interner->arena,
+                       sizeof(ConstantString) + sv.length + 1,
+                       alignof(ConstantString));
+    string->length = sv.length;
+    char *data     = (char *)string->data;
+    memcpy(data, sv.ptr, sv.length);
+    data[sv.length] = '\0';
+    return string;
+}
 
-    // if the buffer isn't empty, we need to reinsert
-    // all existing elements into the new buffer.
-    if (string_interner->buffer != NULL) {
-        for (u64 i = 0; i < string_interner->capacity; ++i) {
-            ConstantString **element = &(string_interner->buffer[i]);
-            if (*element == NULL) { continue; }
+static StringInternerSlot *string_interner_find(StringInternerSlot *slots,
+                                                u64        capacity,
+                                                u64        hash,
+                                                StringView sv) {
+    u64 mask  = capacity - 1;
+    u64 index = hash & mask;
+    while (1) {
+        StringInternerSlot *slot = slots + index;
+        if (slot->string == NULL) { return slot; }
+        if ((slot->hash == hash) && constant_string_equal(slot->string, sv)) {
+            return slot;
+        }
 
-            ConstantString **dest = string_interner_find(
-                elements, g.new_capacity, constant_string_to_view(*element));
+        index = (index + 1) & mask;
+    }
+}
 
-            *dest = *element;
-        }
+static StringInternerSlot *
+string_interner_find_empty(StringInternerSlot *slots, u64 capacity, u64 hash) {
+    u64 mask  = capacity - 1;
+    u64 index = hash & mask;
+    while (slots[index].string != NULL) {
+        index = (index + 1) & mask;
+    }
+    return slots + index;
+}
 
-        deallocate(string_interner->buffer);
+static void string_interner_grow(StringInterner *restrict string_interner) {
+    Growth_u64 g = array_growth_u64(string_interner->capacity,
+                                    sizeof(StringInternerSlot));
+    assert((g.new_capacity & (g.new_capacity - 1)) == 0);
+    StringInternerSlot *slots = callocate_tagged(
+        "string interner", g.new_capacity, sizeof(StringInternerSlot));
+
+    // the strings are already distinct, so each is placed in the first
+    // empty slot of its probe sequence, using the stored hash.
+    for (u64 i = 0; i < string_interner->capacity; ++i) {
+        StringInternerSlot *slot = string_interner->buffer + i;
+        if (slot->string == NULL) { continue; }
+        *string_interner_find_empty(slots, g.new_capacity, slot->hash) = *slot;
     }
 
+    deallocate(string_interner->buffer);
     string_interner->capacity = g.new_capacity;
-    string_interner->buffer   = elements;
+    string_interner->buffer   = slots;
 }
 
 static bool string_interner_full(StringInterner *restrict string_interner) {
-    u64 load_limit = (u64)floor((double)string_interner->capacity *
-                                STRING_INTERNER_MAX_LOAD);
-    return (string_interner->count + 1) >= load_limit;
+    // the load factor is kept below 3/4
+    return ((string_interner->count + 1) * 4) >=
+           (string_interner->capacity * 3);
 }
 
 ConstantString *string_interner_insert(StringInterner *restrict string_interner,
@@ -109,11 +129,13 @@ ConstantString *string_interner_insert(StringInterner *restrict string_interner,
         string_interner_grow(string_interner);
     }
 
-    ConstantString **element = string_interner_find(
-        string_interner->buffer, string_interner->capacity, sv);
-    if (*element != NULL) { return *element; }
+    u64                 hash = hash_cstring(sv.ptr, sv.length);
+    StringInternerSlot *slot = string_interner_find(
+        string_interner->buffer, string_interner->capacity, hash, sv);
+    if (slot->string != NULL) { return slot->string; }
 
     string_interner->count++;
-    *element = constant_string_create(sv);
-    return *element;
+    slot->hash   = hash;
+    slot->string = string_interner_allocate(string_interner, sv);
+    return slot->string;
 }
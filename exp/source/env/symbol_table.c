@@ -15,19 +15,18 @@
 // You should have received a copy of the GNU General Public License
 // along with exp.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
-#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "env/symbol_table.h"
 #include "support/allocation.h"
 #include "support/array_growth.h"
 #include "support/hash.h"
 
-#define SYMBOL_TABLE_MAX_LOAD 0.75
-
 SymbolTable symbol_table_create() {
     SymbolTable symbol_table;
     symbol_table.capacity = symbol_table.count = 0;
+    symbol_table.tags                          = NULL;
     symbol_table.elements                      = NULL;
     return symbol_table;
 }
@@ -44,65 +43,158 @@ void symbol_table_destroy(SymbolTable *restrict symbol_table) {
 
     symbol_table->count    = 0;
     symbol_table->capacity = 0;
+    deallocate(symbol_table->tags);
+    symbol_table->tags = NULL;
     deallocate(symbol_table->elements);
     symbol_table->elements = NULL;
 }
 
-static Symbol **
-symbol_table_find(Symbol **restrict elements, u64 capacity, StringView name) {
-    u64 index = hash_cstring(name.ptr, name.length) % capacity;
-    while (1) {
-        Symbol **element = elements + index;
-        if (((*element) == nullptr) ||
-            string_view_equal(name, (*element)->name)) {
-            return element;
+static u32 symbol_table_tag(StringView name) {
+    u64 hash = hash_cstring(name.ptr, name.length);
+    u32 tag  = (u32)(hash ^ (hash >> 32));
+    // zero marks an empty slot
+    return (tag == 0) ? 1 : tag;
+}
+
+static u64 symbol_table_distance(u32 tag, u64 index, u64 mask) {
+    return (index - (tag & mask)) & mask;
+}
+
+/*
+ * place the element with the given tag, which is known not to be
+ * present, taking the slot of any element nearer to its home slot
+ * and carrying that element on.
+ */
+static void symbol_table_place(u32 *restrict tags,
+                               Symbol **restrict elements,
+                               u64     capacity,
+                               u32     tag,
+                               Symbol *element) {
+    u64 mask     = capacity - 1;
+    u64 index    = tag & mask;
+    u64 distance = 0;
+    while (tags[index] != 0) {
+        u64 resident = symbol_table_distance(tags[index], index, mask);
+        if (resident < distance) {
+            u32     displaced_tag     = tags[index];
+            Symbol *displaced_element = elements[index];
+            tags[index]               = tag;
+            elements[index]           = element;
+            tag                       = displaced_tag;
+            element                   = displaced_element;
+            distance                  = resident;
         }
 
-        index = (index + 1) % capacity;
+        index = (index + 1) & mask;
+        distance += 1;
     }
+
+    tags[index]     = tag;
+    elements[index] = element;
 }
 
 static void symbol_table_grow(SymbolTable *restrict symbol_table) {
     Growth_u64 g = array_growth_u64(symbol_table->capacity, sizeof(Symbol *));
-    Symbol   **elements = callocate(g.new_capacity, sizeof(Symbol *));
-
-    if (symbol_table->elements != NULL) {
-        for (u64 i = 0; i < symbol_table->capacity; ++i) {
-            Symbol *element = symbol_table->elements[i];
-            if (element == nullptr) { continue; }
+    assert((g.new_capacity & (g.new_capacity - 1)) == 0);
+    u32 *tags = callocate_tagged("symbol table", g.new_capacity, sizeof(u32));
+    Symbol **elements =
+        callocate_tagged("symbol table", g.new_capacity, sizeof(Symbol *));
 
-            Symbol **dest =
-                symbol_table_find(elements, g.new_capacity, element->name);
-            *dest = element;
-        }
-
-        // we can avoid freeing each element because we
-        // move the data to the new allocation.
-        deallocate(symbol_table->elements);
+    // the tags determine each home slot, so no name is rehashed.
+    for (u64 i = 0; i < symbol_table->capacity; ++i) {
+        if (symbol_table->tags[i] == 0) { continue; }
+        symbol_table_place(tags,
+                           elements,
+                           g.new_capacity,
+                           symbol_table->tags[i],
+                           symbol_table->elements[i]);
     }
 
+    // we can avoid freeing each element because we
+    // move the data to the new allocation.
+    deallocate(symbol_table->tags);
+    deallocate(symbol_table->elements);
     symbol_table->capacity = g.new_capacity;
+    symbol_table->tags     = tags;
     symbol_table->elements = elements;
 }
 
 static bool symbol_table_full(SymbolTable *restrict symbol_table) {
-    u64 load_limit =
-        (u64)floor((double)symbol_table->capacity * SYMBOL_TABLE_MAX_LOAD);
-    return (symbol_table->count + 1) >= load_limit;
+    // the load factor is kept below 3/4
+    return ((symbol_table->count + 1) * 4) >= (symbol_table->capacity * 3);
+}
+
+/*
+ * a probe ends at an empty slot, or at an element nearer to its home
+ * than the name would be, as insertion would have displaced it.
+ */
+static Symbol *symbol_table_find(SymbolTable const *restrict symbol_table,
+                                 u32        tag,
+                                 StringView name) {
+    u64 mask     = symbol_table->capacity - 1;
+    u64 index    = tag & mask;
+    u64 distance = 0;
+    while (1) {
+        u32 resident = symbol_table->tags[index];
+        if (resident == 0) { return nullptr; }
+        if (symbol_table_distance(resident, index, mask) < distance) {
+            return nullptr;
+        }
+
+        Symbol *element = symbol_table->elements[index];
+        if ((resident == tag) && string_view_equal(name, element->name)) {
+            return element;
+        }
+
+        index = (index + 1) & mask;
+        distance += 1;
+    }
 }
 
 Symbol *symbol_table_at(SymbolTable *restrict symbol_table, StringView name) {
     assert(symbol_table != NULL);
 
+    u32 tag = symbol_table_tag(name);
+    if (symbol_table->count != 0) {
+        Symbol *element = symbol_table_find(symbol_table, tag, name);
+        if (element != nullptr) { return element; }
+    }
+
     if (symbol_table_full(symbol_table)) { symbol_table_grow(symbol_table); }
 
-    Symbol **element =
-        symbol_table_find(symbol_table->elements, symbol_table->capacity, name);
-    if ((*element) == nullptr) {
-        (*element)       = callocate(1, sizeof(Symbol));
-        (*element)->name = name;
-        symbol_table->count += 1;
+    Symbol *element = callocate_tagged("symbol table", 1, sizeof(Symbol));
+    element->name   = name;
+    symbol_table_place(symbol_table->tags,
+                       symbol_table->elements,
+                       symbol_table->capacity,
+                       tag,
+                       element);
+    symbol_table->count += 1;
+    return element;
+}
+
+static i32 symbol_table_compare(void const *left, void const *right) {
+    StringView a = (*(Symbol *const *)left)->name;
+    StringView b = (*(Symbol *const *)right)->name;
+    u64 length   = (a.length < b.length) ? a.length : b.length;
+    i32 result   = memcmp(a.ptr, b.ptr, length);
+    if (result != 0) { return result; }
+    if (a.length == b.length) { return 0; }
+    return (a.length < b.length) ? -1 : 1;
+}
+
+Symbol **symbol_table_sorted(SymbolTable const *restrict symbol_table) {
+    assert(symbol_table != NULL);
+    Symbol **symbols = callocate_tagged(
+        "symbol table", symbol_table->count, sizeof(Symbol *));
+
+    u64 count = 0;
+    for (u64 i = 0; i < symbol_table->capacity; ++i) {
+        Symbol *element = symbol_table->elements[i];
+        if (element == nullptr) { continue; }
+        symbols[count++] = element;
     }
 
-    return *element;
+    qsort(symbols, count, sizeof(Symbol *), symbol_table_compare);
+    return symbols;
 }
@@ -18,10 +18,12 @@
  */
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "env/type_interner.h"
 #include "support/allocation.h"
 #include "support/array_growth.h"
+#include "support/hash.h"
 
 static void type_list_create(TypeList *restrict type_list) {
     assert(type_list != NULL);
@@ -33,13 +35,26 @@ static void type_list_create(TypeList *restrict type_list) {
 static void type_list_destroy(TypeList *restrict type_list) {
     assert(type_list != NULL);
 
+    // the types themselves are freed with the arena.
     for (u32 index = 0; index < type_list->size; ++index) {
-        deallocate(type_list->buffer[index]);
+        type_destroy(type_list->buffer[index]);
     }
 
+    deallocate(type_list->buffer);
     type_list_create(type_list);
 }
 
+static void type_list_clear(TypeList *restrict type_list) {
+    assert(type_list != NULL);
+
+    // the types themselves are freed with the arena.
+    for (u32 index = 0; index < type_list->size; ++index) {
+        type_destroy(type_list->buffer[index]);
+    }
+
+    type_list->size = 0;
+}
+
 static bool type_list_full(TypeList const *restrict type_list) {
     assert(type_list != NULL);
     return (type_list->size + 1) >= type_list->capacity;
@@ -49,7 +64,8 @@ static void type_list_grow(TypeList *restrict type_list) {
     assert(type_list != NULL);
     Growth_u32 g =
         array_growth_u32(type_list->capacity, sizeof(*type_list->buffer));
-    type_list->buffer   = reallocate(type_list->buffer, g.alloc_size);
+    type_list->buffer =
+        reallocate_tagged("type interner", type_list->buffer, g.alloc_size);
     type_list->capacity = g.new_capacity;
 }
 
@@ -61,6 +77,148 @@ static void type_list_append(TypeList *restrict type_list,
     type_list->buffer[type_list->size++] = type;
 }
 
+static void type_table_create(TypeTable *restrict table) {
+    assert(table != NULL);
+    table->capacity = 0;
+    table->count    = 0;
+    table->buffer   = NULL;
+}
+
+static void type_table_destroy(TypeTable *restrict table) {
+    assert(table != NULL);
+    deallocate(table->buffer);
+    type_table_create(table);
+}
+
+static void type_table_clear(TypeTable *restrict table) {
+    assert(table != NULL);
+    if (table->buffer != NULL) {
+        memset(table->buffer, 0, table->capacity * sizeof(TypeInternerSlot));
+    }
+    table->count = 0;
+}
+
+static bool type_table_full(TypeTable const *restrict table) {
+    // the load factor is kept below 3/4
+    return ((table->count + 1) * 4) >= (table->capacity * 3);
+}
+
+static TypeInternerSlot *
+type_table_find_empty(TypeInternerSlot *slots, u64 capacity, u64 hash) {
+    u64 mask  = capacity - 1;
+    u64 index = hash & mask;
+    while (slots[index].type != NULL) {
+        index = (index + 1) & mask;
+    }
+    return slots + index;
+}
+
+static void type_table_grow(TypeTable *restrict table) {
+    Growth_u64 g =
+        array_growth_u64(table->capacity, sizeof(TypeInternerSlot));
+    assert((g.new_capacity & (g.new_capacity - 1)) == 0);
+    TypeInternerSlot *slots = callocate_tagged(
+        "type interner", g.new_capacity, sizeof(TypeInternerSlot));
+
+    for (u64 i = 0; i < table->capacity; ++i) {
+        TypeInternerSlot *slot = table->buffer + i;
+        if (slot->type == NULL) { continue; }
+        *type_table_find_empty(slots, g.new_capacity, slot->hash) = *slot;
+    }
+
+    deallocate(table->buffer);
+    table->capacity = g.new_capacity;
+    table->buffer   = slots;
+}
+
+/*
+ * the element types of a tuple or function type are already
+ * canonical, so a composite type is identified by its kind and
+ * the addresses of its elements.
+ */
+static u64 type_table_hash(TypeKind    kind,
+                           Type const *return_type,
+                           TupleType const *restrict tuple) {
+    u64 hash = hash_fnv1a(HASH_FNV1A_OFFSET_BASIS, &kind, sizeof(kind));
+    hash     = hash_fnv1a(hash, &return_type, sizeof(return_type));
+    hash     = hash_fnv1a(hash, &tuple->size, sizeof(tuple->size));
+    if (tuple->size == 0) { return hash; }
+    return hash_fnv1a(hash, tuple->types, tuple->size * sizeof(Type const *));
+}
+
+static bool type_table_match(Type const *type,
+                             TypeKind    kind,
+                             Type const *return_type,
+                             TupleType const *restrict tuple) {
+    if (type->kind != kind) { return false; }
+
+    TupleType const *elements = &type->tuple_type;
+    if (kind == TYPE_KIND_FUNCTION) {
+        if (type->function_type.return_type != return_type) { return false; }
+        elements = &type->function_type.argument_types;
+    }
+
+    if (elements->size != tuple->size) { return false; }
+    for (u32 index = 0; index < tuple->size; ++index) {
+        if (elements->types[index] != tuple->types[index]) { return false; }
+    }
+    return true;
+}
+
+/**
+ * @brief find the slot of the composite type with the given kind
+ * and elements, or the empty slot where it belongs.
+ */
+static TypeInternerSlot *type_table_find(TypeTable *restrict table,
+                                         u64         hash,
+                                         TypeKind    kind,
+                                         Type const *return_type,
+                                         TupleType const *restrict tuple) {
+    if (type_table_full(table)) { type_table_grow(table); }
+
+    u64 mask  = table->capacity - 1;
+    u64 index = hash & mask;
+    while (1) {
+        TypeInternerSlot *slot = table->buffer + index;
+        if (slot->type == NULL) { return slot; }
+        if ((slot->hash == hash) &&
+            type_table_match(slot->type, kind, return_type, tuple)) {
+            return slot;
+        }
+
+        index = (index + 1) & mask;
+    }
+}
+
+static TypeLayout type_layout_scalar(u64 size) {
+    return (TypeLayout){.size = size, .alignment = size, .offsets = NULL};
+}
+
+/*
+ * the elements are laid out one after another, without padding, as
+ * the backend has always assumed. the element layouts are already
+ * known, as every element type was interned before the tuple.
+ * an element may land at any offset, so a packed tuple is only byte
+ * aligned, which also keeps the size a multiple of the alignment.
+ */
+static TypeLayout type_layout_tuple(TypeInterner *restrict type_interner,
+                                    TupleType const *restrict tuple) {
+    TypeLayout layout = {.size = 0, .alignment = 1, .offsets = NULL};
+    if (tuple->size == 0) { return layout; }
+
+    u64 *offsets = arena_allocate(&type_interner->arena,
+                                  tuple->size * sizeof(u64),
+                                  alignof(u64));
+    for (u32 index = 0; index < tuple->size; ++index) {
+        TypeLayout const *element = &tuple->types[index]->layout;
+        offsets[index]            = layout.size;
+        layout.size += element->size;
+    }
+
+    layout.offsets = offsets;
+    return layout;
+}
+
 TypeInterner type_interner_create() {
     TypeInterner type_interner;
     type_interner.nil_type     = type_create_nil();
@@ -73,8 +231,21 @@ TypeInterner type_interner_create() {
     type_interner.i16_type     = type_create_i16();
     type_interner.i32_type     = type_create_i32();
     type_interner.i64_type     = type_create_i64();
+    // #NOTE: the scalars are laid out as on x86-64
+    type_interner.nil_type.layout     = type_layout_scalar(1);
+    type_interner.boolean_type.layout = type_layout_scalar(1);
+    type_interner.u8_type.layout      = type_layout_scalar(1);
+    type_interner.u16_type.layout     = type_layout_scalar(2);
+    type_interner.u32_type.layout     = type_layout_scalar(4);
+    type_interner.u64_type.layout     = type_layout_scalar(8);
+    type_interner.i8_type.layout      = type_layout_scalar(1);
+    type_interner.i16_type.layout     = type_layout_scalar(2);
+    type_interner.i32_type.layout     = type_layout_scalar(4);
+    type_interner.i64_type.layout     = type_layout_scalar(8);
     type_list_create(&type_interner.tuple_types);
     type_list_create(&type_interner.function_types);
+    type_table_create(&type_interner.table);
+    type_interner.arena = arena_create();
     return type_interner;
 }
 
@@ -82,9 +253,19 @@ void type_interner_destroy(TypeInterner *restrict type_interner) {
     assert(type_interner != NULL);
     type_list_destroy(&type_interner->tuple_types);
     type_list_destroy(&type_interner->function_types);
+    type_table_destroy(&type_interner->table);
+    arena_destroy(&type_interner->arena);
     return;
 }
 
+void type_interner_clear(TypeInterner *restrict type_interner) {
+    assert(type_interner != NULL);
+    type_list_clear(&type_interner->tuple_types);
+    type_list_clear(&type_interner->function_types);
+    type_table_clear(&type_interner->table);
+    arena_clear(&type_interner->arena);
+}
+
 Type const *type_interner_nil_type(TypeInterner *restrict type_interner) {
     assert(type_interner != NULL);
     return &(type_interner->nil_type);
@@ -138,9 +319,22 @@ Type const *type_interner_i64_type(TypeInterner *restrict type_interner) {
 Type const *type_interner_tuple_type(TypeInterner *restrict type_interner,
                                      TupleType tuple) {
     assert(type_interner != NULL);
-    Type *type = allocate(sizeof(Type));
-    *type      = type_create_tuple(tuple);
+    u64 hash = type_table_hash(TYPE_KIND_TUPLE, NULL, &tuple);
+    TypeInternerSlot *slot = type_table_find(
+        &type_interner->table, hash, TYPE_KIND_TUPLE, NULL, &tuple);
+    if (slot->type != NULL) {
+        tuple_type_destroy(&tuple);
+        return slot->type;
+    }
+
+    Type *type =
+        arena_allocate(&type_interner->arena, sizeof(Type), alignof(Type));
+    *type        = type_create_tuple(tuple);
+    type->layout = type_layout_tuple(type_interner, &type->tuple_type);
     type_list_append(&type_interner->tuple_types, type);
+    type_interner->table.count++;
+    slot->hash = hash;
+    slot->type = type;
     return type;
 }
 
@@ -149,8 +343,24 @@ Type const *type_interner_function_type(TypeInterner *restrict type_interner,
                                         TupleType   argument_types) {
     assert(type_interner != NULL);
     assert(return_type != NULL);
-    Type *type = allocate(sizeof(Type));
+    u64 hash =
+        type_table_hash(TYPE_KIND_FUNCTION, return_type, &argument_types);
+    TypeInternerSlot *slot = type_table_find(&type_interner->table,
+                                             hash,
+                                             TYPE_KIND_FUNCTION,
+                                             return_type,
+                                             &argument_types);
+    if (slot->type != NULL) {
+        tuple_type_destroy(&argument_types);
+        return slot->type;
+    }
+
+    Type *type =
+        arena_allocate(&type_interner->arena, sizeof(Type), alignof(Type));
     *type      = type_create_function(return_type, argument_types);
     type_list_append(&type_interner->function_types, type);
+    type_interner->table.count++;
+    slot->hash = hash;
+    slot->type = type;
     return type;
 }
@@ -45,7 +45,8 @@ static bool bytecode_full(Bytecode *restrict bytecode) {
 
 static void bytecode_grow(Bytecode *restrict bytecode) {
     Growth_u32 g = array_growth_u32(bytecode->capacity, sizeof(Instruction));
-    bytecode->buffer   = reallocate(bytecode->buffer, g.alloc_size);
+    bytecode->buffer =
+        reallocate_tagged("bytecode", bytecode->buffer, g.alloc_size);
     bytecode->capacity = g.new_capacity;
 }
 
@@ -46,7 +46,7 @@ static bool formal_argument_list_full(FormalArgumentList *restrict fal) {
 
 static void formal_argument_list_grow(FormalArgumentList *restrict fal) {
     Growth_u8 g   = array_growth_u8(fal->capacity, sizeof(Local *));
-    fal->list     = reallocate(fal->list, g.alloc_size);
+    fal->list     = reallocate_tagged("bytecode", fal->list, g.alloc_size);
     fal->capacity = g.new_capacity;
 }
 
@@ -77,10 +77,11 @@ void function_destroy(Function *restrict function) {
     function->return_type = NULL;
 }
 
-Local *function_declare_argument(Function *restrict function) {
+Local *function_declare_argument(Function *restrict function,
+                                 Arena *restrict arena) {
     assert(function != NULL);
 
-    Local *arg = locals_declare(&function->locals);
+    Local *arg = locals_declare(&function->locals, arena);
     assert(arg != NULL);
     formal_argument_list_append(&function->arguments, arg);
 
@@ -94,10 +95,11 @@ Local *function_lookup_argument(Function *restrict function, u8 index) {
     return function->arguments.list[index];
 }
 
-Local *function_declare_local(Function *restrict function) {
+Local *function_declare_local(Function *restrict function,
+                              Arena *restrict arena) {
     assert(function != NULL);
 
-    Local *local = locals_declare(&function->locals);
+    Local *local = locals_declare(&function->locals, arena);
     assert(local != NULL);
 
     return local;
@@ -110,12 +112,29 @@ Local *function_lookup_local(Function *restrict function, u32 ssa) {
 }
 
 Local *function_lookup_local_name(Function *restrict function,
-                                  StringView name) {
+                                  ConstantString const *name) {
     assert(function != NULL);
 
     return locals_lookup_name(&function->locals, name);
 }
 
+void function_enter_scope(Function *restrict function) {
+    assert(function != NULL);
+    locals_enter_scope(&function->locals);
+}
+
+void function_leave_scope(Function *restrict function) {
+    assert(function != NULL);
+    locals_leave_scope(&function->locals);
+}
+
+void function_bind_local(Function *restrict function,
+                         Local *restrict local,
+                         ConstantString const *name) {
+    assert(function != NULL);
+    locals_bind_name(&function->locals, local, name);
+}
+
 static void print_formal_argument(String *restrict string,
                                   Local *restrict arg) {
     string_append(string, arg->name);
@@ -17,17 +17,145 @@
  * along with exp.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stdint.h>
+
 #include "imr/locals.h"
 #include "imr/local.h"
 #include "support/allocation.h"
 #include "support/array_growth.h"
 #include "support/assert.h"
 
+#define LOCAL_NAMES_UNBOUND u32_MAX
+
+static void local_names_create(LocalNames *restrict names) {
+    names->slot_count       = 0;
+    names->slot_capacity    = 0;
+    names->slots            = NULL;
+    names->binding_count    = 0;
+    names->binding_capacity = 0;
+    names->bindings         = NULL;
+    names->scope_count      = 0;
+    names->scope_capacity   = 0;
+    names->scopes           = NULL;
+}
+
+static void local_names_destroy(LocalNames *restrict names) {
+    deallocate(names->slots);
+    deallocate(names->bindings);
+    deallocate(names->scopes);
+    local_names_create(names);
+}
+
+static u32 local_names_hash(ConstantString const *name) {
+    // the low bits of an address are mostly alignment, fibonacci
+    // hashing moves the bits which vary into the high half.
+    u64 hash = (u64)(uintptr_t)name * 0x9E3779B97F4A7C15ull;
+    return (u32)(hash >> 32);
+}
+
+static LocalNameSlot *local_names_find(LocalNameSlot *slots,
+                                       u32 capacity,
+                                       ConstantString const *name) {
+    u32 mask  = capacity - 1;
+    u32 index = local_names_hash(name) & mask;
+    while (1) {
+        LocalNameSlot *slot = slots + index;
+        if ((slot->name == name) || (slot->name == NULL)) { return slot; }
+        index = (index + 1) & mask;
+    }
+}
+
+static void local_names_grow(LocalNames *restrict names) {
+    u32            capacity = (names->slot_capacity == 0)
+                                ? 16
+                                : (names->slot_capacity * 2);
+    LocalNameSlot *slots =
+        callocate_tagged("locals", capacity, sizeof(LocalNameSlot));
+
+    for (u32 index = 0; index < names->slot_capacity; ++index) {
+        LocalNameSlot *slot = names->slots + index;
+        if (slot->name == NULL) { continue; }
+        *local_names_find(slots, capacity, slot->name) = *slot;
+    }
+
+    deallocate(names->slots);
+    names->slots         = slots;
+    names->slot_capacity = capacity;
+}
+
+static LocalNameSlot *local_names_slot(LocalNames *restrict names,
+                                       ConstantString const *name) {
+    // the load factor is kept at or below 3/4
+    if (((names->slot_count + 1) * 4) > (names->slot_capacity * 3)) {
+        local_names_grow(names);
+    }
+
+    LocalNameSlot *slot =
+        local_names_find(names->slots, names->slot_capacity, name);
+    if (slot->name == NULL) {
+        slot->name    = name;
+        slot->binding = LOCAL_NAMES_UNBOUND;
+        names->slot_count += 1;
+    }
+    return slot;
+}
+
+static void local_names_bind(LocalNames *restrict names,
+                             ConstantString const *name,
+                             Local *restrict local) {
+    if (names->binding_capacity <= (names->binding_count + 1)) {
+        Growth_u32 g =
+            array_growth_u32(names->binding_capacity, sizeof(LocalBinding));
+        names->bindings =
+            reallocate_tagged("locals", names->bindings, g.alloc_size);
+        names->binding_capacity = g.new_capacity;
+    }
+
+    LocalNameSlot *slot  = local_names_slot(names, name);
+    u32            index = names->binding_count++;
+    names->bindings[index] =
+        (LocalBinding){.name = name, .local = local, .shadowed = slot->binding};
+    slot->binding = index;
+}
+
+static Local *local_names_lookup(LocalNames const *restrict names,
+                                 ConstantString const *name) {
+    if (names->slot_count == 0) { return NULL; }
+    LocalNameSlot *slot =
+        local_names_find(names->slots, names->slot_capacity, name);
+    if ((slot->name == NULL) || (slot->binding == LOCAL_NAMES_UNBOUND)) {
+        return NULL;
+    }
+    return names->bindings[slot->binding].local;
+}
+
+static void local_names_enter_scope(LocalNames *restrict names) {
+    if (names->scope_capacity <= (names->scope_count + 1)) {
+        Growth_u32 g = array_growth_u32(names->scope_capacity, sizeof(u32));
+        names->scopes =
+            reallocate_tagged("locals", names->scopes, g.alloc_size);
+        names->scope_capacity = g.new_capacity;
+    }
+    names->scopes[names->scope_count++] = names->binding_count;
+}
+
+static void local_names_leave_scope(LocalNames *restrict names) {
+    exp_assert(names->scope_count > 0);
+    u32 height = names->scopes[--names->scope_count];
+    while (names->binding_count > height) {
+        LocalBinding  *binding = names->bindings + (--names->binding_count);
+        LocalNameSlot *slot =
+            local_names_find(names->slots, names->slot_capacity, binding->name);
+        slot->binding = binding->shadowed;
+    }
+}
+
 void locals_create(Locals *restrict locals) {
     exp_assert(locals != NULL);
     locals->count    = 0;
     locals->capacity = 0;
     locals->buffer   = NULL;
+    local_names_create(&locals->names);
 }
 
 void locals_destroy(Locals *restrict locals) {
@@ -36,6 +164,7 @@ void locals_destroy(Locals *restrict locals) {
     locals->capacity = 0;
     deallocate(locals->buffer);
     locals->buffer = NULL;
+    local_names_destroy(&locals->names);
 }
 
 static bool locals_full(Locals const *restrict locals) {
@@ -43,15 +172,16 @@ static bool locals_full(Locals const *restrict locals) {
 }
 
 static void locals_grow(Locals *restrict locals) {
-    Growth_u32 g     = array_growth_u32(locals->capacity, sizeof(Local *));
-    locals->buffer   = reallocate(locals->buffer, g.alloc_size);
+    Growth_u32 g   = array_growth_u32(locals->capacity, sizeof(Local *));
+    locals->buffer = reallocate_tagged("locals", locals->buffer, g.alloc_size);
     locals->capacity = g.new_capacity;
 }
 
-Local *locals_declare(Locals *restrict locals) {
+Local *locals_declare(Locals *restrict locals, Arena *restrict arena) {
+    exp_assert(arena != NULL);
     if (locals_full(locals)) { locals_grow(locals); }
     Local **local = locals->buffer + locals->count;
-    *local        = (Local *)allocate(sizeof(Local));
+    *local        = arena_allocate(arena, sizeof(Local), alignof(Local));
     local_init(*local, locals->count);
     locals->count += 1;
     return *local;
@@ -63,11 +193,27 @@ Local *locals_lookup(Locals *restrict locals, u32 ssa) {
     return locals->buffer[ssa];
 }
 
-Local *locals_lookup_name(Locals *restrict locals, StringView name) {
-    for (u32 i = 0; i < locals->count; ++i) {
-        if (string_view_equal(locals->buffer[i]->name, name)) {
-            return locals->buffer[i];
-        }
-    }
-    return NULL;
+void locals_enter_scope(Locals *restrict locals) {
+    exp_assert(locals != NULL);
+    local_names_enter_scope(&locals->names);
+}
+
+void locals_leave_scope(Locals *restrict locals) {
+    exp_assert(locals != NULL);
+    local_names_leave_scope(&locals->names);
+}
+
+void locals_bind_name(Locals *restrict locals,
+                      Local *restrict local,
+                      ConstantString const *name) {
+    exp_assert(locals != NULL);
+    exp_assert(local != NULL);
+    exp_assert(name != NULL);
+    local->name = constant_string_to_view(name);
+    local_names_bind(&locals->names, name, local);
+}
+
+Local *locals_lookup_name(Locals *restrict locals, ConstantString const *name) {
+    exp_assert(locals != NULL);
+    return local_names_lookup(&locals->names, name);
 }
@@ -21,6 +21,7 @@
 #include "env/context.h"
 #include "imr/operand.h"
 #include "support/assert.h"
+#include "support/hash.h"
 #include "support/string.h"
 #include "support/unreachable.h"
 
@@ -36,8 +37,8 @@ Operand operand_constant(u32 index) {
     return (Operand){.kind = OPERAND_KIND_CONSTANT, .data.constant = index};
 }
 
-Operand operand_label(ConstantString *cs) {
-    return (Operand){.kind = OPERAND_KIND_LABEL, .data.label = cs};
+Operand operand_label(u32 index) {
+    return (Operand){.kind = OPERAND_KIND_LABEL, .data.label = index};
 }
 
 Operand operand_u8(u8 u8_) {
@@ -53,7 +54,8 @@ Operand operand_u32(u32 u32_) {
 }
 
 Operand operand_u64(u64 u64_) {
-    return (Operand){.kind = OPERAND_KIND_U64, .data.u64_ = u64_};
+    exp_assert(u64_in_range_u32(u64_));
+    return (Operand){.kind = OPERAND_KIND_U64, .data.u32_ = (u32)u64_};
 }
 
 Operand operand_i8(i8 i8_) {
@@ -69,7 +71,8 @@ Operand operand_i32(i32 i32_) {
 }
 
 Operand operand_i64(i64 i64_) {
-    return (Operand){.kind = OPERAND_KIND_I64, .data.i64_ = i64_};
+    exp_assert(i64_in_range_i32(i64_));
+    return (Operand){.kind = OPERAND_KIND_I64, .data.i32_ = (i32)i64_};
 }
 
 bool operand_equality(Operand A, Operand B) {
@@ -80,17 +83,40 @@ bool operand_equality(Operand A, Operand B) {
     case OPERAND_KIND_CONSTANT: return A.data.constant == B.data.constant;
     case OPERAND_KIND_U8:       return A.data.u8_ == B.data.u8_;
     case OPERAND_KIND_U16:      return A.data.u16_ == B.data.u16_;
-    case OPERAND_KIND_U32:      return A.data.u32_ == B.data.u32_;
-    case OPERAND_KIND_U64:      return A.data.u64_ == B.data.u64_;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64:      return A.data.u32_ == B.data.u32_;
     case OPERAND_KIND_I8:       return A.data.i8_ == B.data.i8_;
     case OPERAND_KIND_I16:      return A.data.i16_ == B.data.i16_;
-    case OPERAND_KIND_I32:      return A.data.i32_ == B.data.i32_;
-    case OPERAND_KIND_I64:      return A.data.i64_ == B.data.i64_;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64:      return A.data.i32_ == B.data.i32_;
     case OPERAND_KIND_LABEL:    return A.data.label == B.data.label;
     default:                    EXP_UNREACHABLE();
     }
 }
 
+u64 operand_hash(u64 hash, Operand A) {
+    // only the member named by the kind is hashed, the remaining
+    // bytes of the union are unspecified.
+    u64 payload = 0;
+    switch (A.kind) {
+    case OPERAND_KIND_SSA:      payload = A.data.ssa; break;
+    case OPERAND_KIND_CONSTANT: payload = A.data.constant; break;
+    case OPERAND_KIND_U8:       payload = A.data.u8_; break;
+    case OPERAND_KIND_U16:      payload = A.data.u16_; break;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64:      payload = A.data.u32_; break;
+    case OPERAND_KIND_I8:       payload = (u64)A.data.i8_; break;
+    case OPERAND_KIND_I16:      payload = (u64)A.data.i16_; break;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64:      payload = (u64)A.data.i32_; break;
+    case OPERAND_KIND_LABEL:    payload = A.data.label; break;
+    default:                    EXP_UNREACHABLE();
+    }
+
+    hash = hash_fnv1a(hash, &A.kind, sizeof(A.kind));
+    return hash_fnv1a(hash, &payload, sizeof(payload));
+}
+
 bool operand_is_index(Operand A) {
     switch (A.kind) {
     case OPERAND_KIND_U8:
@@ -99,8 +125,8 @@ bool operand_is_index(Operand A) {
     case OPERAND_KIND_U64: return true;
     case OPERAND_KIND_I8:  return A.data.i8_ >= 0;
     case OPERAND_KIND_I16: return A.data.i16_ >= 0;
-    case OPERAND_KIND_I32: return A.data.i32_ >= 0;
-    case OPERAND_KIND_I64: return A.data.i64_ >= 0;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64: return A.data.i32_ >= 0;
     default:               return false;
     }
 }
@@ -110,12 +136,12 @@ u64 operand_as_index(Operand A) {
     switch (A.kind) {
     case OPERAND_KIND_U8:  return A.data.u8_;
     case OPERAND_KIND_U16: return A.data.u16_;
-    case OPERAND_KIND_U32: return A.data.u32_;
-    case OPERAND_KIND_U64: return A.data.u64_;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64: return A.data.u32_;
     case OPERAND_KIND_I8:  return (u64)A.data.i8_;
     case OPERAND_KIND_I16: return (u64)A.data.i16_;
-    case OPERAND_KIND_I32: return (u64)A.data.i32_;
-    case OPERAND_KIND_I64: return (u64)A.data.i64_;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64: return (u64)A.data.i32_;
 
     default: EXP_UNREACHABLE();
     }
@@ -134,9 +160,11 @@ static void print_operand_value(String *restrict string,
 }
 
 static void print_operand_label(String *restrict string,
-                                ConstantString const *restrict cs) {
+                                u32 index,
+                                Context *restrict context) {
+    ConstantString *label = context_labels_at(context, index);
     string_append(string, SV("%"));
-    string_append(string, constant_string_to_view(cs));
+    string_append(string, constant_string_to_view(label));
 }
 
 void print_operand(String *restrict string,
@@ -148,16 +176,16 @@ void print_operand(String *restrict string,
         print_operand_value(string, operand.data.constant, context);
         break;
     case OPERAND_KIND_LABEL:
-        print_operand_label(string, operand.data.label);
+        print_operand_label(string, operand.data.label, context);
         break;
     case OPERAND_KIND_U8:  string_append_u64(string, operand.data.u8_); break;
     case OPERAND_KIND_U16: string_append_u64(string, operand.data.u16_); break;
-    case OPERAND_KIND_U32: string_append_u64(string, operand.data.u32_); break;
-    case OPERAND_KIND_U64: string_append_u64(string, operand.data.u64_); break;
+    case OPERAND_KIND_U32:
+    case OPERAND_KIND_U64: string_append_u64(string, operand.data.u32_); break;
     case OPERAND_KIND_I8:  string_append_i64(string, operand.data.i8_); break;
     case OPERAND_KIND_I16: string_append_i64(string, operand.data.i16_); break;
-    case OPERAND_KIND_I32: string_append_i64(string, operand.data.i32_); break;
-    case OPERAND_KIND_I64: string_append_i64(string, operand.data.i64_); break;
+    case OPERAND_KIND_I32:
+    case OPERAND_KIND_I64: string_append_i64(string, operand.data.i32_); break;
 
     default: EXP_UNREACHABLE();
     }
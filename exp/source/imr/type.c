@@ -151,17 +151,11 @@ void type_destroy(Type *type) {
 }
 
 bool type_equality(Type const *A, Type const *B) {
-    if (A->kind != B->kind) { return 0; }
-
-    switch (A->kind) {
-    case TYPE_KIND_TUPLE:
-        return tuple_type_equality(&A->tuple_type, &B->tuple_type);
-    case TYPE_KIND_FUNCTION:
-        return function_type_equality(&A->function_type, &B->function_type);
-
-    // #NOTE: scalar types are equal when their kinds are equal
-    default: return true;
-    }
+    exp_assert(A != NULL);
+    exp_assert(B != NULL);
+    // every Type is interned by the TypeInterner, which holds each
+    // type exactly once, so equal types are always the same pointer.
+    return A == B;
 }
 
 bool type_is_scalar(Type const *T) {
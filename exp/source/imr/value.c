@@ -20,6 +20,7 @@
 #include "imr/value.h"
 #include "env/context.h"
 #include "support/assert.h"
+#include "support/hash.h"
 #include "support/unreachable.h"
 
 Value value_create() {
@@ -129,6 +130,37 @@ bool value_equality(Value *A, Value *B) {
     }
 }
 
+u64 value_hash(Value const *v) {
+    u64 hash = hash_fnv1a(HASH_FNV1A_OFFSET_BASIS, &v->kind, sizeof(v->kind));
+    u64 payload = 0;
+    switch (v->kind) {
+    case VALUE_KIND_UNINITIALIZED:
+    case VALUE_KIND_NIL:           break;
+    case VALUE_KIND_BOOLEAN:       payload = v->boolean; break;
+    case VALUE_KIND_U8:            payload = v->u8_; break;
+    case VALUE_KIND_U16:           payload = v->u16_; break;
+    case VALUE_KIND_U32:           payload = v->u32_; break;
+    case VALUE_KIND_U64:           payload = v->u64_; break;
+    case VALUE_KIND_I8:            payload = (u64)v->i8_; break;
+    case VALUE_KIND_I16:           payload = (u64)v->i16_; break;
+    case VALUE_KIND_I32:           payload = (u64)v->i32_; break;
+    case VALUE_KIND_I64:           payload = (u64)v->i64_; break;
+
+    case VALUE_KIND_TUPLE: {
+        Tuple const *tuple = &v->tuple;
+        hash = hash_fnv1a(hash, &tuple->size, sizeof(tuple->size));
+        for (u32 i = 0; i < tuple->size; ++i) {
+            hash = operand_hash(hash, tuple->elements[i]);
+        }
+        return hash;
+    }
+
+    default: EXP_UNREACHABLE();
+    }
+
+    return hash_fnv1a(hash, &payload, sizeof(payload));
+}
+
 bool value_is_index(const Value *v) {
     switch (v->kind) {
     case VALUE_KIND_U8:
@@ -19,12 +19,10 @@
 #include <assert.h>
 
 #include "intrinsics/align_of.h"
-#include "support/unreachable.h"
 
 u64 align_of(Type const *restrict type) {
     assert(type != NULL);
-
-    switch (type->kind) {
+    assert(type->kind != TYPE_KIND_FUNCTION);
     // #NOTE: single byte objects do not
     // have an alignment specified by gcc or
     // clang. I believe this is
@@ -37,27 +35,5 @@ u64 align_of(Type const *restrict type) {
     // alignment is 8. ints are 4 bytes, and their
     // alignment is 4.
     // string literals are align 8 as well.
-    case TYPE_KIND_NIL:     return 1;
-    case TYPE_KIND_BOOLEAN: return 1;
-    case TYPE_KIND_U8:      return 1;
-    case TYPE_KIND_U16:     return 2;
-    case TYPE_KIND_U32:     return 4;
-    case TYPE_KIND_U64:     return 8;
-    case TYPE_KIND_I8:      return 1;
-    case TYPE_KIND_I16:     return 2;
-    case TYPE_KIND_I32:     return 4;
-    case TYPE_KIND_I64:     return 8;
-    case TYPE_KIND_TUPLE:   {
-        TupleType *tuple_type = (TupleType *)type;
-        u64        max        = 0;
-        for (u32 i = 0; i < tuple_type->size; ++i) {
-            Type const *t = tuple_type->types[i];
-            u64         a = align_of(t);
-            if (a > max) { max = a; }
-        }
-        return max;
-    }
-
-    default: EXP_UNREACHABLE();
-    }
+    return type->layout.alignment;
 }
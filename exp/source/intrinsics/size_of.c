@@ -19,32 +19,16 @@
 #include <assert.h>
 
 #include "intrinsics/size_of.h"
-#include "support/unreachable.h"
 
 u64 size_of(Type const *restrict type) {
     assert(type != NULL);
+    assert(type->kind != TYPE_KIND_FUNCTION);
+    return type->layout.size;
+}
 
-    switch (type->kind) {
-    case TYPE_KIND_NIL:     return 1;
-    case TYPE_KIND_BOOLEAN: return 1;
-    case TYPE_KIND_U8:      return 1;
-    case TYPE_KIND_U16:     return 2;
-    case TYPE_KIND_U32:     return 4;
-    case TYPE_KIND_U64:     return 8;
-    case TYPE_KIND_I8:      return 1;
-    case TYPE_KIND_I16:     return 2;
-    case TYPE_KIND_I32:     return 4;
-    case TYPE_KIND_I64:     return 8;
-
-    case TYPE_KIND_TUPLE: {
-        TupleType const *tuple = &type->tuple_type;
-        u64              acc   = 0;
-        for (u64 i = 0; i < tuple->size; ++i) {
-            acc += size_of(tuple->types[i]);
-        }
-        return acc;
-    }
-
-    default: EXP_UNREACHABLE();
-    }
+u64 offset_of(Type const *restrict type, u64 index) {
+    assert(type != NULL);
+    assert(type->kind == TYPE_KIND_TUPLE);
+    assert(index < type->tuple_type.size);
+    return type->layout.offsets[index];
 }
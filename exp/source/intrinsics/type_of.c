@@ -27,6 +27,7 @@ Type const *type_of_value(Value *restrict value, Context *restrict context) {
     case VALUE_KIND_UNINITIALIZED: PANIC("uninitialized Value");
     case VALUE_KIND_NIL:           return context_nil_type(context);
     case VALUE_KIND_BOOLEAN:       return context_boolean_type(context);
+    case VALUE_KIND_U64:           return context_u64_type(context);
     case VALUE_KIND_I64:           return context_i64_type(context);
     case VALUE_KIND_TUPLE:         {
         Tuple    *tuple      = &value->tuple;
@@ -79,7 +80,8 @@ Type const *type_of_operand(Operand operand, Context *restrict context) {
     }
 
     case OPERAND_KIND_LABEL: {
-        StringView label  = constant_string_to_view(operand.data.label);
+        StringView label  = constant_string_to_view(
+            context_labels_at(context, operand.data.label));
         Symbol    *symbol = context_global_symbol_table_at(context, label);
         assert(!string_view_empty(symbol->name));
         assert(symbol->type != NULL);
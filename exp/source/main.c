@@ -16,9 +16,30 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <string.h>
+
 #include "core/compile.h"
+#include "core/run.h"
+#include "core/server.h"
 
 i32 main(i32 argc, char const *argv[], [[maybe_unused]] char *envv[]) {
+  if ((argc > 1) && (strcmp(argv[1], "--server") == 0)) { return server(); }
+
+  // the client is given the remaining arguments as its own command line.
+  if ((argc > 1) && (strcmp(argv[1], "--client") == 0)) {
+    return client(argc - 1, argv + 1);
+  }
+
+  // likewise for run, which compiles into memory and calls main.
+  if ((argc > 1) && (strcmp(argv[1], "--run") == 0)) {
+    return run(argc - 1, argv + 1);
+  }
+
+  // and for evaluate, which interprets the bytecode of main.
+  if ((argc > 1) && (strcmp(argv[1], "--evaluate") == 0)) {
+    return interpret(argc - 1, argv + 1);
+  }
+
   return compile(argc, argv);
 }
 
@@ -0,0 +1,226 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scanning/definitions.h"
+#include "support/allocation.h"
+#include "support/array_growth.h"
+#include "support/hash.h"
+
+typedef enum DefinitionState : u8 {
+    DEFINITION_UNVISITED,
+    DEFINITION_VISITING,
+    DEFINITION_VISITED,
+} DefinitionState;
+
+void definitions_create(Definitions *restrict definitions) {
+    assert(definitions != nullptr);
+    definitions->count    = 0;
+    definitions->capacity = 0;
+    definitions->buffer   = nullptr;
+    definitions->by_name  = nullptr;
+}
+
+void definitions_destroy(Definitions *restrict definitions) {
+    assert(definitions != nullptr);
+    definitions->count    = 0;
+    definitions->capacity = 0;
+    deallocate(definitions->buffer);
+    definitions->buffer = nullptr;
+    deallocate(definitions->by_name);
+    definitions->by_name = nullptr;
+}
+
+static bool definitions_full(Definitions *restrict definitions) {
+    return definitions->capacity <= (definitions->count + 1);
+}
+
+static void definitions_grow(Definitions *restrict definitions) {
+    Growth_u32 g = array_growth_u32(definitions->capacity, sizeof(Definition));
+    definitions->buffer =
+        reallocate_tagged("definitions", definitions->buffer, g.alloc_size);
+    definitions->capacity = g.new_capacity;
+}
+
+static void definitions_append(Definitions *restrict definitions,
+                               Definition definition) {
+    if (definitions_full(definitions)) { definitions_grow(definitions); }
+    definitions->buffer[definitions->count++] = definition;
+}
+
+/**
+ * @brief find the brace closing the body of the definition whose
+ * "fn" token is at <first>.
+ *
+ * @return false if the definition is not well formed
+ */
+static bool definitions_extent(Tokens const *restrict tokens,
+                               u32 first,
+                               u32 *restrict last) {
+    u32 depth = 0;
+    for (u32 index = first + 2;; ++index) {
+        switch (tokens_kind(tokens, index)) {
+        case TOK_BEGIN_BRACE: depth += 1; break;
+
+        case TOK_END_BRACE:
+            if (depth == 0) { return false; }
+            depth -= 1;
+            if (depth == 0) {
+                *last = index;
+                return true;
+            }
+            break;
+
+        case TOK_END:
+        case TOK_ERROR_UNEXPECTED_CHAR:
+        case TOK_ERROR_UNMATCHED_DOUBLE_QUOTE:
+        case TOK_FN:                           return false;
+
+        default: break;
+        }
+    }
+}
+
+static i32 definitions_compare(void const *left, void const *right) {
+    StringView a = (*(Definition *const *)left)->name;
+    StringView b = (*(Definition *const *)right)->name;
+    u64 length   = (a.length < b.length) ? a.length : b.length;
+    i32 result   = memcmp(a.ptr, b.ptr, length);
+    if (result != 0) { return result; }
+    if (a.length == b.length) { return 0; }
+    return (a.length < b.length) ? -1 : 1;
+}
+
+Definition *definitions_lookup(Definitions const *restrict definitions,
+                               StringView name) {
+    assert(definitions != nullptr);
+    if (definitions->count == 0) { return nullptr; }
+
+    Definition  key     = {.name = name};
+    Definition *pointer = &key;
+    Definition **found  = bsearch(&pointer,
+                                 definitions->by_name,
+                                 definitions->count,
+                                 sizeof(Definition *),
+                                 definitions_compare);
+    return (found == nullptr) ? nullptr : *found;
+}
+
+static u64 definitions_key(Definitions *restrict definitions,
+                           Tokens const *restrict tokens,
+                           u8 *restrict states,
+                           u32 index) {
+    Definition *definition = definitions->buffer + index;
+    switch (states[index]) {
+    case DEFINITION_VISITED:  return definition->key;
+    case DEFINITION_VISITING: return 0; // a cycle
+    default:                  break;
+    }
+
+    states[index] = DEFINITION_VISITING;
+    // every identifier which names a definition is taken as a dependency,
+    // this overestimates when a local shadows a definition, which only
+    // costs a rebuild.
+    u64  key       = definition->source_hash;
+    bool cacheable = true;
+    for (u32 token = definition->first + 2; token < definition->last;
+         ++token) {
+        if (tokens_kind(tokens, token) != TOK_IDENTIFIER) { continue; }
+        Definition *dependency =
+            definitions_lookup(definitions, tokens_text(tokens, token));
+        if (dependency == nullptr) { continue; }
+
+        u32 position       = (u32)(dependency - definitions->buffer);
+        u64 dependency_key =
+            definitions_key(definitions, tokens, states, position);
+        if (dependency_key == 0) {
+            cacheable = false;
+            break;
+        }
+        key = hash_fnv1a(key, &dependency_key, sizeof(dependency_key));
+    }
+
+    if (!cacheable) {
+        key = 0;
+    } else if (key == 0) {
+        key = 1;
+    }
+
+    definition->key = key;
+    states[index]   = DEFINITION_VISITED;
+    return key;
+}
+
+void definitions_scan(Definitions *restrict definitions,
+                      Tokens const *restrict tokens) {
+    assert(definitions != nullptr);
+    assert(tokens != nullptr);
+    definitions->count = 0;
+
+    u32 token = 0;
+    while ((tokens_kind(tokens, token) == TOK_FN) &&
+           (tokens_kind(tokens, token + 1) == TOK_IDENTIFIER)) {
+        u32 last = 0;
+        if (!definitions_extent(tokens, token, &last)) { break; }
+
+        u32 begin = tokens->offsets[token];
+        u32 end   = tokens->offsets[last] + tokens->lengths[last];
+        u64 hash  = hash_fnv1a(
+            HASH_FNV1A_OFFSET_BASIS, tokens->buffer + begin, end - begin);
+        definitions_append(definitions,
+                           (Definition){.name  = tokens_text(tokens, token + 1),
+                                        .first = token,
+                                        .last  = last,
+                                        .source_hash = hash,
+                                        .key         = 0});
+        token = last + 1;
+    }
+
+    if (definitions->count == 0) { return; }
+
+    definitions->by_name = reallocate_tagged(
+        "definitions",
+        definitions->by_name,
+        definitions->count * sizeof(Definition *));
+    for (u32 index = 0; index < definitions->count; ++index) {
+        definitions->by_name[index] = definitions->buffer + index;
+    }
+    qsort(definitions->by_name,
+          definitions->count,
+          sizeof(Definition *),
+          definitions_compare);
+
+    u8 *states =
+        callocate_tagged("definitions", definitions->count, sizeof(u8));
+    // a name defined twice is ambiguous, neither definition is cached.
+    for (u32 index = 1; index < definitions->count; ++index) {
+        Definition *previous = definitions->by_name[index - 1];
+        Definition *current  = definitions->by_name[index];
+        if (!string_view_equal(previous->name, current->name)) { continue; }
+        states[previous - definitions->buffer] = DEFINITION_VISITED;
+        states[current - definitions->buffer]  = DEFINITION_VISITED;
+    }
+
+    for (u32 index = 0; index < definitions->count; ++index) {
+        definitions_key(definitions, tokens, states, index);
+    }
+    deallocate(states);
+}
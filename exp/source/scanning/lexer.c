@@ -17,7 +17,6 @@
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
-#include <ctype.h>
 #include <string.h>
 
 #include "scanning/lexer.h"
@@ -32,7 +31,6 @@ void lexer_init(Lexer *restrict lexer) {
     assert(lexer != NULL);
     lexer->length = 0;
     lexer->buffer = lexer->cursor = lexer->token = NULL;
-    lexer->line = lexer->column = 1;
 }
 
 void lexer_reset(Lexer *restrict lexer) {
@@ -62,56 +60,345 @@ StringView lexer_current_text(Lexer const *restrict lexer) {
     return result;
 }
 
+/*
+ * the line and column are only needed for diagnostics, so rather
+ * than track them for every character scanned, they are recomputed
+ * from the newlines preceding the current token.
+ */
 u64 lexer_current_line(Lexer const *restrict lexer) {
     assert(lexer != NULL);
-    return lexer->line;
+    u64         line   = 1;
+    char const *cursor = lexer->buffer;
+    while ((cursor = memchr(cursor, '\n', (size_t)(lexer->token - cursor))) !=
+           NULL) {
+        ++line;
+        ++cursor;
+    }
+    return line;
 }
 
 u64 lexer_current_column(Lexer const *restrict lexer) {
     assert(lexer != NULL);
-    return lexer->column;
+    char const *cursor = lexer->token;
+    while ((cursor > lexer->buffer) && (cursor[-1] != '\n')) {
+        --cursor;
+    }
+    return (u64)(lexer->token - cursor) + 1;
+}
+
+/*
+ * every character belongs to exactly one class. the class drives
+ * the dispatch of lexer_scan, and the scalar scanning of runs.
+ */
+typedef enum LexerClass : u8 {
+    LEXER_UNEXPECTED  = 0,
+    LEXER_WHITESPACE  = 1 << 0,
+    LEXER_DIGIT       = 1 << 1,
+    LEXER_LETTER      = 1 << 2,
+    LEXER_PUNCTUATION = 1 << 3,
+    LEXER_QUOTE       = 1 << 4,
+} LexerClass;
+
+static LexerClass const lexer_classes[256] = {
+    [' ']  = LEXER_WHITESPACE, ['\t'] = LEXER_WHITESPACE,
+    ['\r'] = LEXER_WHITESPACE, ['\n'] = LEXER_WHITESPACE,
+    ['0'] = LEXER_DIGIT, ['1'] = LEXER_DIGIT, ['2'] = LEXER_DIGIT,
+    ['3'] = LEXER_DIGIT, ['4'] = LEXER_DIGIT, ['5'] = LEXER_DIGIT,
+    ['6'] = LEXER_DIGIT, ['7'] = LEXER_DIGIT, ['8'] = LEXER_DIGIT,
+    ['9'] = LEXER_DIGIT,
+    ['_'] = LEXER_LETTER, ['a'] = LEXER_LETTER, ['b'] = LEXER_LETTER,
+    ['c'] = LEXER_LETTER, ['d'] = LEXER_LETTER, ['e'] = LEXER_LETTER,
+    ['f'] = LEXER_LETTER, ['g'] = LEXER_LETTER, ['h'] = LEXER_LETTER,
+    ['i'] = LEXER_LETTER, ['j'] = LEXER_LETTER, ['k'] = LEXER_LETTER,
+    ['l'] = LEXER_LETTER, ['m'] = LEXER_LETTER, ['n'] = LEXER_LETTER,
+    ['o'] = LEXER_LETTER, ['p'] = LEXER_LETTER, ['q'] = LEXER_LETTER,
+    ['r'] = LEXER_LETTER, ['s'] = LEXER_LETTER, ['t'] = LEXER_LETTER,
+    ['u'] = LEXER_LETTER, ['v'] = LEXER_LETTER, ['w'] = LEXER_LETTER,
+    ['x'] = LEXER_LETTER, ['y'] = LEXER_LETTER, ['z'] = LEXER_LETTER,
+    ['A'] = LEXER_LETTER, ['B'] = LEXER_LETTER, ['C'] = LEXER_LETTER,
+    ['D'] = LEXER_LETTER, ['E'] = LEXER_LETTER, ['F'] = LEXER_LETTER,
+    ['G'] = LEXER_LETTER, ['H'] = LEXER_LETTER, ['I'] = LEXER_LETTER,
+    ['J'] = LEXER_LETTER, ['K'] = LEXER_LETTER, ['L'] = LEXER_LETTER,
+    ['M'] = LEXER_LETTER, ['N'] = LEXER_LETTER, ['O'] = LEXER_LETTER,
+    ['P'] = LEXER_LETTER, ['Q'] = LEXER_LETTER, ['R'] = LEXER_LETTER,
+    ['S'] = LEXER_LETTER, ['T'] = LEXER_LETTER, ['U'] = LEXER_LETTER,
+    ['V'] = LEXER_LETTER, ['W'] = LEXER_LETTER, ['X'] = LEXER_LETTER,
+    ['Y'] = LEXER_LETTER, ['Z'] = LEXER_LETTER,
+    ['('] = LEXER_PUNCTUATION, [')'] = LEXER_PUNCTUATION,
+    ['{'] = LEXER_PUNCTUATION, ['}'] = LEXER_PUNCTUATION,
+    [';'] = LEXER_PUNCTUATION, [':'] = LEXER_PUNCTUATION,
+    [','] = LEXER_PUNCTUATION, ['.'] = LEXER_PUNCTUATION,
+    ['-'] = LEXER_PUNCTUATION, ['+'] = LEXER_PUNCTUATION,
+    ['/'] = LEXER_PUNCTUATION, ['*'] = LEXER_PUNCTUATION,
+    ['%'] = LEXER_PUNCTUATION, ['!'] = LEXER_PUNCTUATION,
+    ['='] = LEXER_PUNCTUATION, ['<'] = LEXER_PUNCTUATION,
+    ['>'] = LEXER_PUNCTUATION, ['&'] = LEXER_PUNCTUATION,
+    ['|'] = LEXER_PUNCTUATION, ['^'] = LEXER_PUNCTUATION,
+    ['"'] = LEXER_QUOTE,
+};
+
+static LexerClass lexer_class(char c) { return lexer_classes[(u8)c]; }
+
+/*
+ * a punctuation character scans as <single>, unless it is followed
+ * by <second>, in which case the two scan as <pair>.
+ */
+typedef struct LexerPunctuation {
+    Token single;
+    char  second;
+    Token pair;
+} LexerPunctuation;
+
+static LexerPunctuation const lexer_punctuation[256] = {
+    ['('] = {TOK_BEGIN_PAREN, ')', TOK_NIL},
+    [')'] = {TOK_END_PAREN, '\0', TOK_END},
+    ['{'] = {TOK_BEGIN_BRACE, '\0', TOK_END},
+    ['}'] = {TOK_END_BRACE, '\0', TOK_END},
+    [';'] = {TOK_SEMICOLON, '\0', TOK_END},
+    [':'] = {TOK_COLON, '\0', TOK_END},
+    [','] = {TOK_COMMA, '\0', TOK_END},
+    ['.'] = {TOK_DOT, '\0', TOK_END},
+    ['-'] = {TOK_MINUS, '>', TOK_RIGHT_ARROW},
+    ['+'] = {TOK_PLUS, '\0', TOK_END},
+    ['/'] = {TOK_SLASH, '\0', TOK_END},
+    ['*'] = {TOK_STAR, '\0', TOK_END},
+    ['%'] = {TOK_PERCENT, '\0', TOK_END},
+    ['!'] = {TOK_BANG, '=', TOK_BANG_EQUAL},
+    ['='] = {TOK_EQUAL, '=', TOK_EQUAL_EQUAL},
+    ['<'] = {TOK_LESS, '=', TOK_LESS_EQUAL},
+    ['>'] = {TOK_GREATER, '=', TOK_GREATER_EQUAL},
+    ['&'] = {TOK_AND, '\0', TOK_END},
+    ['|'] = {TOK_OR, '\0', TOK_END},
+    ['^'] = {TOK_XOR, '\0', TOK_END},
+};
+
+/*
+ * a perfect hash of the keywords, found by search: the first and last
+ * characters and the length of each keyword select a distinct slot.
+ * a new keyword which collides initializes a slot twice, which is
+ * diagnosed by -Woverride-init, and caught by the lexer tests.
+ */
+#define LEXER_KEYWORD_SLOTS 32
+#define LEXER_KEYWORD_HASH(first, last, length)                                \
+    ((((u32)(first)) + (7u * (u32)(last)) + (4u * (u32)(length))) %            \
+     LEXER_KEYWORD_SLOTS)
+#define LEXER_KEYWORD(text, first, last, token)                                \
+    [LEXER_KEYWORD_HASH(first, last, sizeof(text) - 1)] = {                    \
+        text, sizeof(text) - 1, token}
+
+typedef struct LexerKeyword {
+    char const *text;
+    u64         length;
+    Token       token;
+} LexerKeyword;
+
+static LexerKeyword const lexer_keywords[LEXER_KEYWORD_SLOTS] = {
+    LEXER_KEYWORD("bool", 'b', 'l', TOK_TYPE_BOOL),
+    LEXER_KEYWORD("false", 'f', 'e', TOK_FALSE),
+    LEXER_KEYWORD("fn", 'f', 'n', TOK_FN),
+    LEXER_KEYWORD("i8", 'i', '8', TOK_TYPE_I8),
+    LEXER_KEYWORD("i16", 'i', '6', TOK_TYPE_I16),
+    LEXER_KEYWORD("i32", 'i', '2', TOK_TYPE_I32),
+    LEXER_KEYWORD("i64", 'i', '4', TOK_TYPE_I64),
+    LEXER_KEYWORD("let", 'l', 't', TOK_LET),
+    LEXER_KEYWORD("nil", 'n', 'l', TOK_TYPE_NIL),
+    LEXER_KEYWORD("return", 'r', 'n', TOK_RETURN),
+    LEXER_KEYWORD("true", 't', 'e', TOK_TRUE),
+    LEXER_KEYWORD("u8", 'u', '8', TOK_TYPE_U8),
+    LEXER_KEYWORD("u16", 'u', '6', TOK_TYPE_U16),
+    LEXER_KEYWORD("u32", 'u', '2', TOK_TYPE_U32),
+    LEXER_KEYWORD("u64", 'u', '4', TOK_TYPE_U64),
+    LEXER_KEYWORD("var", 'v', 'r', TOK_VAR),
+};
+
+#undef LEXER_KEYWORD
+
+/*
+ * scanning a run of whitespace, a comment, an identifier, or an
+ * integer classifies a whole block of bytes at once.
+ *
+ * a block is only loaded when it lies wholly before the end of the
+ * buffer. the bytes of the final partial block are copied into a
+ * zeroed block, so nothing past the end of the buffer is read, and
+ * the zero after them ends every run.
+ */
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+
+#if defined(__AVX2__)
+#define LEXER_BLOCK_SIZE 32
+#define LEXER_BLOCK_MASK 0xFFFFFFFFu
+typedef __m256i LexerBlock;
+
+static LexerBlock lexer_block_load(char const *block) {
+    return _mm256_loadu_si256((LexerBlock const *)block);
+}
+
+static LexerBlock lexer_block_splat(char c) { return _mm256_set1_epi8(c); }
+
+static LexerBlock lexer_block_equal(LexerBlock A, LexerBlock B) {
+    return _mm256_cmpeq_epi8(A, B);
+}
+
+static LexerBlock lexer_block_or(LexerBlock A, LexerBlock B) {
+    return _mm256_or_si256(A, B);
+}
+
+static LexerBlock lexer_block_sub(LexerBlock A, LexerBlock B) {
+    return _mm256_sub_epi8(A, B);
+}
+
+static LexerBlock lexer_block_min(LexerBlock A, LexerBlock B) {
+    return _mm256_min_epu8(A, B);
+}
+
+static u32 lexer_block_bits(LexerBlock A) {
+    return (u32)_mm256_movemask_epi8(A);
+}
+#else
+#define LEXER_BLOCK_SIZE 16
+#define LEXER_BLOCK_MASK 0xFFFFu
+typedef __m128i LexerBlock;
+
+static LexerBlock lexer_block_load(char const *block) {
+    return _mm_loadu_si128((LexerBlock const *)block);
+}
+
+static LexerBlock lexer_block_splat(char c) { return _mm_set1_epi8(c); }
+
+static LexerBlock lexer_block_equal(LexerBlock A, LexerBlock B) {
+    return _mm_cmpeq_epi8(A, B);
+}
+
+static LexerBlock lexer_block_or(LexerBlock A, LexerBlock B) {
+    return _mm_or_si128(A, B);
+}
+
+static LexerBlock lexer_block_sub(LexerBlock A, LexerBlock B) {
+    return _mm_sub_epi8(A, B);
+}
+
+static LexerBlock lexer_block_min(LexerBlock A, LexerBlock B) {
+    return _mm_min_epu8(A, B);
+}
+
+static u32 lexer_block_bits(LexerBlock A) {
+    return (u32)_mm_movemask_epi8(A);
+}
+#endif
+
+static LexerBlock lexer_block_is(LexerBlock block, char c) {
+    return lexer_block_equal(block, lexer_block_splat(c));
+}
+
+// the bytes of <block> within [low, high]
+static LexerBlock lexer_block_in(LexerBlock block, char low, char high) {
+    LexerBlock offset = lexer_block_sub(block, lexer_block_splat(low));
+    LexerBlock limit  = lexer_block_splat((char)(high - low));
+    return lexer_block_equal(lexer_block_min(offset, limit), offset);
+}
+
+static u32 lexer_whitespace(LexerBlock block) {
+    return lexer_block_bits(
+        lexer_block_or(lexer_block_or(lexer_block_is(block, ' '),
+                                      lexer_block_is(block, '\t')),
+                       lexer_block_or(lexer_block_is(block, '\r'),
+                                      lexer_block_is(block, '\n'))));
+}
+
+static u32 lexer_comment(LexerBlock block) {
+    return ~lexer_block_bits(lexer_block_or(lexer_block_is(block, '\n'),
+                                            lexer_block_is(block, '\0')));
 }
 
-static bool isid(char c) {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == '_');
+static u32 lexer_digits(LexerBlock block) {
+    return lexer_block_bits(lexer_block_in(block, '0', '9'));
 }
 
+static u32 lexer_identifier_characters(LexerBlock block) {
+    LexerBlock lower = lexer_block_or(block, lexer_block_splat(0x20));
+    return lexer_block_bits(
+        lexer_block_or(lexer_block_or(lexer_block_in(lower, 'a', 'z'),
+                                      lexer_block_in(block, '0', '9')),
+                       lexer_block_is(block, '_')));
+}
+
+/**
+ * @brief the first character at or after the cursor of <lexer> which
+ * is not in the class of characters given by <members>, or the end
+ * of the buffer
+ */
+static inline char const *lexer_span(Lexer const *restrict lexer,
+                                     u32 (*members)(LexerBlock)) {
+    char const *cursor = lexer->cursor;
+    char const *end    = lexer->buffer + lexer->length;
+    while ((u64)(end - cursor) >= LEXER_BLOCK_SIZE) {
+        u32 outside = ~members(lexer_block_load(cursor)) & LEXER_BLOCK_MASK;
+        if (outside != 0) { return cursor + __builtin_ctz(outside); }
+        cursor += LEXER_BLOCK_SIZE;
+    }
+
+    char tail[LEXER_BLOCK_SIZE] = {0};
+    memcpy(tail, cursor, (size_t)(end - cursor));
+    u32 outside = ~members(lexer_block_load(tail)) & LEXER_BLOCK_MASK;
+    return cursor + __builtin_ctz(outside);
+}
+
+#undef LEXER_BLOCK_MASK
+#undef LEXER_BLOCK_SIZE
+#else
+static bool lexer_whitespace(char c) {
+    return lexer_class(c) == LEXER_WHITESPACE;
+}
+
+static bool lexer_comment(char c) { return (c != '\n') && (c != '\0'); }
+
+static bool lexer_digits(char c) { return lexer_class(c) == LEXER_DIGIT; }
+
+static bool lexer_identifier_characters(char c) {
+    return (lexer_class(c) & (LEXER_DIGIT | LEXER_LETTER)) != 0;
+}
+
+static char const *lexer_span(Lexer const *restrict lexer,
+                              bool (*members)(char)) {
+    char const *cursor = lexer->cursor;
+    char const *end    = lexer->buffer + lexer->length;
+    while ((cursor < end) && members(*cursor)) {
+        ++cursor;
+    }
+    return cursor;
+}
+#endif
+
 static char lexer_next(Lexer *restrict lexer) {
-    lexer->column++;
     lexer->cursor++;
     return lexer->cursor[-1];
 }
 
-static char lexer_peek(Lexer *restrict lexer) { return *lexer->cursor; }
+// nothing past the end of the buffer is read, it reads as a zero.
+static char lexer_peek(Lexer *restrict lexer) {
+    if (lexer_at_end(lexer)) { return '\0'; }
+
+    return lexer->cursor[0];
+}
 
 static char lexer_peek_next(Lexer *restrict lexer) {
-    if (lexer_at_end(lexer)) { return '\0'; }
+    if (((u64)(lexer->cursor - lexer->buffer) + 1) >= lexer->length) {
+        return '\0';
+    }
 
     return lexer->cursor[1];
 }
 
 static void lexer_skip_whitespace(Lexer *restrict lexer) {
-    while (1) {
-        if (lexer_at_end(lexer)) break;
-        switch (lexer_peek(lexer)) {
-        case '\n':
-            lexer->column = 1;
-            lexer->line++;
-            [[fallthrough]];
-        case ' ':
-        case '\r':
-        case '\t': lexer_next(lexer); break;
+    while (!lexer_at_end(lexer)) {
+        lexer->cursor = lexer_span(lexer, lexer_whitespace);
 
         // single line comments
-        case '/':
-            if (lexer_peek_next(lexer) == '/') {
-                while ((lexer_peek(lexer) != '\n') && !lexer_at_end(lexer)) {
-                    lexer_next(lexer);
-                }
-                break;
-            }
-        default: return;
+        if ((lexer_peek(lexer) != '/') || (lexer_peek_next(lexer) != '/')) {
+            return;
         }
+        lexer->cursor = lexer_span(lexer, lexer_comment);
     }
 }
 
@@ -120,83 +407,27 @@ static bool lexer_match(Lexer *restrict lexer, char c) {
 
     if (lexer_peek(lexer) != c) { return 0; }
 
-    lexer->column++;
     lexer->cursor++;
     return 1;
 }
 
 static Token lexer_integer(Lexer *restrict lexer) {
-    while (isdigit(lexer_peek(lexer))) {
-        lexer_next(lexer);
-    }
+    lexer->cursor = lexer_span(lexer, lexer_digits);
 
     return TOK_INTEGER;
 }
 
-static Token lexer_check_keyword(Lexer *restrict lexer,
-                                 u64         begin,
-                                 u64         length,
-                                 const char *rest,
-                                 Token       keyword) {
-    if ((lexer_current_text_length(lexer) == (begin + length)) &&
-        (memcmp(lexer->token + begin, rest, length) == 0)) {
-        return keyword;
-    }
-
-    return TOK_IDENTIFIER;
-}
-
 static Token lexer_identifier_or_keyword(Lexer *restrict lexer) {
-    switch (lexer->token[0]) {
-    case 'b': return lexer_check_keyword(lexer, 1, 3, "ool", TOK_TYPE_BOOL);
-    case 'f':
-        if (lexer_current_text_length(lexer) > 1) {
-            switch (lexer->token[1]) {
-            case 'a': return lexer_check_keyword(lexer, 2, 3, "lse", TOK_FALSE);
-            case 'n': return lexer_check_keyword(lexer, 2, 0, "", TOK_FN);
-            default:  break;
-            }
-        }
-        break;
-
-    case 'i':
-        if (lexer_current_text_length(lexer) > 1) {
-            switch (lexer->token[1]) {
-            case '8': return lexer_check_keyword(lexer, 2, 0, "", TOK_TYPE_I8);
-            case '1':
-                return lexer_check_keyword(lexer, 2, 1, "6", TOK_TYPE_I16);
-            case '3':
-                return lexer_check_keyword(lexer, 2, 1, "2", TOK_TYPE_I32);
-            case '6':
-                return lexer_check_keyword(lexer, 2, 1, "4", TOK_TYPE_I64);
-            default: break;
-            }
-        }
-        break;
-
-    case 'l': return lexer_check_keyword(lexer, 1, 2, "et", TOK_LET);
-    case 'n': return lexer_check_keyword(lexer, 1, 2, "il", TOK_TYPE_NIL);
-    case 'r': return lexer_check_keyword(lexer, 1, 5, "eturn", TOK_RETURN);
-    case 't': return lexer_check_keyword(lexer, 1, 3, "rue", TOK_TRUE);
-
-    case 'u':
-        if (lexer_current_text_length(lexer) > 1) {
-            switch (lexer->token[1]) {
-            case '8': return lexer_check_keyword(lexer, 2, 0, "", TOK_TYPE_U8);
-            case '1':
-                return lexer_check_keyword(lexer, 2, 1, "6", TOK_TYPE_U16);
-            case '3':
-                return lexer_check_keyword(lexer, 2, 1, "2", TOK_TYPE_U32);
-            case '6':
-                return lexer_check_keyword(lexer, 2, 1, "4", TOK_TYPE_U64);
-            default: break;
-            }
-        }
-        break;
-
-    case 'v': return lexer_check_keyword(lexer, 1, 2, "ar", TOK_VAR);
-
-    default: break;
+    u64 length = lexer_current_text_length(lexer);
+    if (length < 2) { return TOK_IDENTIFIER; }
+
+    LexerKeyword const *keyword = lexer_keywords + LEXER_KEYWORD_HASH(
+                                      (u8)lexer->token[0],
+                                      (u8)lexer->token[length - 1],
+                                      length);
+    if ((keyword->length == length) &&
+        (memcmp(lexer->token, keyword->text, length) == 0)) {
+        return keyword->token;
     }
 
     return TOK_IDENTIFIER;
@@ -207,22 +438,19 @@ static Token lexer_string_literal(Lexer *restrict lexer) {
     lexer->token++;
     // #TODO handle escape sequences
     while (lexer_peek(lexer) != '"') {
-        lexer_next(lexer);
-
         // unmatched '"' in token stream.
         if (lexer_at_end(lexer)) { return TOK_ERROR_UNMATCHED_DOUBLE_QUOTE; }
+
+        lexer_next(lexer);
     }
     // eat the '"'
-    lexer->column++;
     lexer->cursor++;
 
     return TOK_STRING_LITERAL;
 }
 
 static Token lexer_identifier(Lexer *restrict lexer) {
-    while (isid(lexer_peek(lexer)) || isdigit(lexer_peek(lexer))) {
-        lexer_next(lexer);
-    }
+    lexer->cursor = lexer_span(lexer, lexer_identifier_characters);
 
     return lexer_identifier_or_keyword(lexer);
 }
@@ -237,97 +465,22 @@ Token lexer_scan(Lexer *restrict lexer) {
     if (lexer_at_end(lexer)) { return TOK_END; }
 
     char c = lexer_next(lexer);
-    switch (c) {
-    case '(': return lexer_match(lexer, ')') ? TOK_NIL : TOK_BEGIN_PAREN;
-    case ')': return TOK_END_PAREN;
-    case '{': return TOK_BEGIN_BRACE;
-    case '}': return TOK_END_BRACE;
-    case ';': return TOK_SEMICOLON;
-    case ':': return TOK_COLON;
-    case ',': return TOK_COMMA;
-    case '.': return TOK_DOT;
-
-    case '-': return lexer_match(lexer, '>') ? TOK_RIGHT_ARROW : TOK_MINUS;
-    case '+': return TOK_PLUS;
-    case '/': return TOK_SLASH;
-    case '*': return TOK_STAR;
-    case '%': return TOK_PERCENT;
-
-    case '!': return lexer_match(lexer, '=') ? TOK_BANG_EQUAL : TOK_BANG;
-    case '=': return lexer_match(lexer, '=') ? TOK_EQUAL_EQUAL : TOK_EQUAL;
-    case '<': return lexer_match(lexer, '=') ? TOK_LESS_EQUAL : TOK_LESS;
-    case '>': return lexer_match(lexer, '=') ? TOK_GREATER_EQUAL : TOK_GREATER;
-    case '&': return TOK_AND;
-    case '|': return TOK_OR;
-    case '^': return TOK_XOR;
-
-    case '"': return lexer_string_literal(lexer);
-
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9': return lexer_integer(lexer);
-
-    case '_':
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-    case 'f':
-    case 'g':
-    case 'h':
-    case 'i':
-    case 'j':
-    case 'k':
-    case 'l':
-    case 'm':
-    case 'n':
-    case 'o':
-    case 'p':
-    case 'q':
-    case 'r':
-    case 's':
-    case 't':
-    case 'u':
-    case 'v':
-    case 'w':
-    case 'x':
-    case 'y':
-    case 'z':
-    case 'A':
-    case 'B':
-    case 'C':
-    case 'D':
-    case 'E':
-    case 'F':
-    case 'G':
-    case 'H':
-    case 'I':
-    case 'J':
-    case 'K':
-    case 'L':
-    case 'M':
-    case 'N':
-    case 'O':
-    case 'P':
-    case 'Q':
-    case 'R':
-    case 'S':
-    case 'T':
-    case 'U':
-    case 'V':
-    case 'W':
-    case 'X':
-    case 'Y':
-    case 'Z': return lexer_identifier(lexer);
-
-    default: return TOK_ERROR_UNEXPECTED_CHAR;
+    switch (lexer_class(c)) {
+    case LEXER_PUNCTUATION: {
+        LexerPunctuation const *punctuation = lexer_punctuation + (u8)c;
+        if ((punctuation->second != '\0') &&
+            lexer_match(lexer, punctuation->second)) {
+            return punctuation->pair;
+        }
+        return punctuation->single;
+    }
+
+    case LEXER_QUOTE:  return lexer_string_literal(lexer);
+    case LEXER_DIGIT:  return lexer_integer(lexer);
+    case LEXER_LETTER: return lexer_identifier(lexer);
+    default:           return TOK_ERROR_UNEXPECTED_CHAR;
     }
 }
+
+#undef LEXER_KEYWORD_HASH
+#undef LEXER_KEYWORD_SLOTS
@@ -17,21 +17,33 @@
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "env/error.h"
+#include "env/function_cache.h"
 #include "imr/operand.h"
-#include "scanning/lexer.h"
+#include "scanning/definitions.h"
 #include "scanning/parser.h"
 #include "scanning/token.h"
+#include "scanning/tokens.h"
+#include "support/hash.h"
 #include "support/io.h"
+#include "support/message.h"
 #include "support/numeric_conversions.h"
 #include "support/unreachable.h"
 
+/**
+ * @note <definitions> are only scanned when the function cache is in
+ * use, <definition> is the first of them not yet behind the parser.
+ */
 typedef struct Parser {
-    Lexer lexer;
-    Token curtok;
+    Tokens      tokens;
+    u32         index;
+    Token       curtok;
+    Definitions definitions;
+    u32         definition;
 } Parser;
 
 typedef enum Precedence {
@@ -64,8 +76,17 @@ typedef struct ParseRule {
 
 static void parser_create(Parser *restrict parser) {
     assert(parser != NULL);
-    lexer_init(&(parser->lexer));
+    tokens_create(&(parser->tokens));
+    parser->index  = 0;
     parser->curtok = TOK_END;
+    definitions_create(&(parser->definitions));
+    parser->definition = 0;
+}
+
+static void parser_destroy(Parser *restrict parser) {
+    assert(parser != NULL);
+    tokens_destroy(&(parser->tokens));
+    definitions_destroy(&(parser->definitions));
 }
 
 static void parser_set_view(Parser *restrict parser,
@@ -73,7 +94,9 @@ static void parser_set_view(Parser *restrict parser,
                             u64 length) {
     assert(parser != NULL);
     assert(buffer != NULL);
-    lexer_set_view(&(parser->lexer), buffer, length);
+    tokens_scan(&(parser->tokens), buffer, length);
+    parser->index  = 0;
+    parser->curtok = tokens_kind(&(parser->tokens), 0);
 }
 
 static bool finished(Parser const *restrict parser) {
@@ -81,18 +104,18 @@ static bool finished(Parser const *restrict parser) {
 }
 
 static StringView curtxt(Parser const *restrict parser) {
-    return lexer_current_text(&parser->lexer);
+    return tokens_text(&parser->tokens, parser->index);
 }
 
 static u64 curline(Parser const *restrict parser) {
-    return lexer_current_line(&parser->lexer);
+    return tokens_line(&parser->tokens, parser->index);
 }
 
 static bool error(Parser const *restrict parser,
                   Context *restrict context,
                   ErrorCode code) {
     Error *current_error = context_current_error(context);
-    error_assign(current_error, code, lexer_current_text(&parser->lexer));
+    error_assign(current_error, code, curtxt(parser));
     return false;
 }
 
@@ -101,13 +124,8 @@ static bool peek(Parser const *restrict parser, Token token) {
 }
 
 static bool nexttok(Parser *restrict parser) {
-    if (lexer_at_end(&parser->lexer)) {
-        parser->curtok = TOK_END;
-        return true;
-    }
-
-    parser->curtok = lexer_scan(&parser->lexer);
-
+    if (parser->curtok != TOK_END) { parser->index += 1; }
+    parser->curtok = tokens_kind(&parser->tokens, parser->index);
     return true;
 }
 
@@ -237,7 +255,7 @@ static bool parse_formal_argument(Local *restrict arg,
     if (!parse_type(&type, parser, context)) { return false; }
     assert(type != NULL);
 
-    arg->name = constant_string_to_view(name);
+    context_bind_local(context, arg, name);
     arg->type = type;
     return true;
 }
@@ -268,7 +286,7 @@ static bool parse_formal_argument_list(Function *restrict body,
     case EXPECT_RESULT_TOKEN_NOT_FOUND: {
         bool comma_found = false;
         do {
-            Local *arg = function_declare_argument(body);
+            Local *arg = function_declare_argument(body, &context->arena);
 
             if (!parse_formal_argument(arg, parser, context)) { return false; }
 
@@ -349,7 +367,7 @@ static bool let(Operand *restrict result,
     Operand A = context_emit_load(context, *result);
     assert(A.kind == OPERAND_KIND_SSA);
     Local *local = context_lookup_local(context, A.data.ssa);
-    local->name  = constant_string_to_view(name);
+    context_bind_local(context, local, name);
 
     return true;
 }
@@ -414,10 +432,70 @@ static bool parse_block(Operand *restrict result,
     }
 }
 
+/**
+ * @brief record the span of the definition of <symbol>, from the
+ * token <first> to the token <last>, and hash its text.
+ */
+static void function_span(Symbol *restrict symbol,
+                          Parser const *restrict parser,
+                          u32 first,
+                          u32 last) {
+    Tokens const *tokens  = &parser->tokens;
+    u32           begin   = tokens->offsets[first];
+    u32           end     = tokens->offsets[last] + tokens->lengths[last];
+    symbol->source_offset = begin;
+    symbol->source_length = end - begin;
+    symbol->source_hash   = hash_fnv1a(
+        HASH_FNV1A_OFFSET_BASIS, tokens->buffer + begin, end - begin);
+}
+
+/**
+ * @brief the definition scanned ahead of the parser which begins
+ * at the token <first>, if any.
+ */
+static Definition const *parser_definition(Parser *restrict parser,
+                                           u32 first) {
+    Definitions const *definitions = &parser->definitions;
+    while ((parser->definition < definitions->count) &&
+           (definitions->buffer[parser->definition].first < first)) {
+        parser->definition += 1;
+    }
+
+    if ((parser->definition == definitions->count) ||
+        (definitions->buffer[parser->definition].first != first)) {
+        return nullptr;
+    }
+
+    return definitions->buffer + parser->definition;
+}
+
+/**
+ * @brief define <symbol> from the function cache, and skip the tokens
+ * of its definition, which begins at the token <first>.
+ *
+ * @return true on a cache hit
+ */
+static bool function_cached(Symbol *restrict symbol,
+                            Parser *restrict parser,
+                            Context *restrict context,
+                            u32 first) {
+    Definition const *definition = parser_definition(parser, first);
+    if (definition == nullptr) { return false; }
+
+    symbol->cache_key = definition->key;
+    if (!function_cache_retrieve(context->function_cache, context, symbol)) {
+        return false;
+    }
+
+    function_span(symbol, parser, first, definition->last);
+    parser->index = definition->last;
+    return nexttok(parser);
+}
+
 static bool function(Operand *restrict result,
                      Parser *restrict parser,
                      Context *restrict context) {
-
+    u32 first = parser->index;
     if (!nexttok(parser)) { return false; } // eat "fn"
 
     if (!peek(parser, TOK_IDENTIFIER)) {
@@ -427,8 +505,14 @@ static bool function(Operand *restrict result,
     ConstantString *name = context_intern(context, curtxt(parser));
     if (!nexttok(parser)) { return false; }
 
-    Function *body =
-        context_enter_function(context, constant_string_to_view(name));
+    StringView name_view = constant_string_to_view(name);
+    Symbol    *symbol    = context_global_symbol_table_at(context, name_view);
+    if (function_cached(symbol, parser, context, first)) { return true; }
+
+    Function *body = context_enter_function(context, name_view);
+    // the arguments and the locals of the body share the scope of
+    // the function.
+    context_enter_scope(context);
 
     if (!parse_formal_argument_list(body, parser, context)) { return false; }
 
@@ -442,7 +526,9 @@ static bool function(Operand *restrict result,
 
     if (!parse_block(result, parser, context)) { return false; }
 
+    context_leave_scope(context);
     context_leave_function(context);
+    function_span(symbol, parser, first, parser->index - 1);
     return true;
 }
 
@@ -634,9 +720,9 @@ static bool integer(Operand *restrict result,
 
     if (!nexttok(parser)) { return false; }
     if (u64_in_range_i64(integer)) {
-        *result = operand_i64((i64)integer);
+        *result = context_immediate_i64(context, (i64)integer);
     } else {
-        *result = operand_u64(integer);
+        *result = context_immediate_u64(context, integer);
     }
 
     return true;
@@ -650,8 +736,7 @@ static bool identifier(Operand *restrict result,
     ConstantString *name = context_intern(context, curtxt(parser));
     if (!nexttok(parser)) { return false; }
 
-    Local *local =
-        context_lookup_local_name(context, constant_string_to_view(name));
+    Local *local = context_lookup_local_name(context, name);
     if (local != NULL) {
         *result = operand_ssa(local->ssa);
         return true;
@@ -663,7 +748,7 @@ static bool identifier(Operand *restrict result,
         return error(parser, context, ERROR_ANALYSIS_UNDEFINED_SYMBOL);
     }
 
-    *result = operand_label(name);
+    *result = operand_label(context_labels_insert(context, name));
     return true;
 }
 
@@ -758,40 +843,44 @@ i32 parse_buffer(char const *restrict buffer,
     assert(buffer != NULL);
     assert(context != NULL);
 
+    if (length > UINT32_MAX) {
+        message(MESSAGE_ERROR,
+                NULL,
+                0,
+                SV("source files are limited to 4GiB"),
+                stderr);
+        return EXIT_FAILURE;
+    }
+
     Parser parser;
     parser_create(&parser);
-
     parser_set_view(&parser, buffer, length);
-    if (!nexttok(&parser)) {
-        error_print(context_current_error(context),
-                    context_source_path(context),
-                    curline(&parser));
-        return EXIT_FAILURE;
+    if (context->function_cache != nullptr) {
+        definitions_scan(&parser.definitions, &parser.tokens);
     }
 
+    i32 result = EXIT_SUCCESS;
     while (!finished(&parser)) {
-        Operand result;
-        if (!definition(&result, &parser, context)) {
+        Operand operand;
+        if (!definition(&operand, &parser, context)) {
             error_print(context_current_error(context),
                         context_source_path(context),
                         curline(&parser));
-            return EXIT_FAILURE;
+            result = EXIT_FAILURE;
+            break;
         }
     }
 
-    return EXIT_SUCCESS;
+    parser_destroy(&parser);
+    return result;
 }
 
 i32 parse_source(Context *restrict context) {
     assert(context != NULL);
-    StringView path   = context_source_path(context);
-    FILE      *file   = file_open(path.ptr, "r");
-    String     buffer = string_from_file(file);
-    file_close(file);
-    i32 result =
-        parse_buffer(string_to_cstring(&buffer), buffer.length, context);
-    string_destroy(&buffer);
-    return result;
+    // the source is lexed in place. the context owns the mapping, so
+    // views into the source remain valid until it is destroyed.
+    StringView source = context_source(context);
+    return parse_buffer(source.ptr, source.length, context);
 }
 
 #undef TRY
@@ -0,0 +1,357 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "scanning/lexer.h"
+#include "scanning/tokens.h"
+#include "support/allocation.h"
+#include "support/array_growth.h"
+#include "support/thread_pool.h"
+
+// buffers smaller than this are scanned by the calling thread alone,
+// and no chunk is made smaller than the minimum.
+#define TOKENS_PARALLEL_THRESHOLD (1u << 22)
+#define TOKENS_CHUNK_MINIMUM      (1u << 20)
+
+static_assert(TOK_TYPE_I64 <= UINT8_MAX, "a Token must fit within a u8");
+
+void tokens_create(Tokens *restrict tokens) {
+    assert(tokens != NULL);
+    tokens->buffer   = NULL;
+    tokens->count    = 0;
+    tokens->capacity = 0;
+    tokens->kinds    = NULL;
+    tokens->offsets  = NULL;
+    tokens->lengths  = NULL;
+}
+
+void tokens_destroy(Tokens *restrict tokens) {
+    assert(tokens != NULL);
+    deallocate(tokens->kinds);
+    deallocate(tokens->offsets);
+    deallocate(tokens->lengths);
+    tokens_create(tokens);
+}
+
+static void tokens_reserve(Tokens *restrict tokens, u32 capacity) {
+    tokens->kinds   = reallocate_tagged("tokens", tokens->kinds, capacity);
+    tokens->offsets = reallocate_tagged(
+        "tokens", tokens->offsets, capacity * sizeof(*tokens->offsets));
+    tokens->lengths = reallocate_tagged(
+        "tokens", tokens->lengths, capacity * sizeof(*tokens->lengths));
+    tokens->capacity = capacity;
+}
+
+static bool tokens_full(Tokens const *restrict tokens) {
+    return tokens->capacity <= (tokens->count + 1);
+}
+
+static void tokens_grow(Tokens *restrict tokens) {
+    Growth_u32 g = array_growth_u32(tokens->capacity, sizeof(u32));
+    tokens_reserve(tokens, g.new_capacity);
+}
+
+void tokens_append(Tokens *restrict tokens,
+                   Token kind,
+                   u32   offset,
+                   u32   length) {
+    assert(tokens != NULL);
+    if (tokens_full(tokens)) { tokens_grow(tokens); }
+    tokens->kinds[tokens->count]   = (u8)kind;
+    tokens->offsets[tokens->count] = offset;
+    tokens->lengths[tokens->count] = length;
+    tokens->count += 1;
+}
+
+static void tokens_ensure(Tokens *restrict tokens, u32 count) {
+    while (tokens->capacity <= (tokens->count + count)) {
+        tokens_grow(tokens);
+    }
+}
+
+/*
+ * scan the tokens within [begin, end) of buffer, excluding the final
+ * TOK_END. offsets are relative to the start of the whole buffer.
+ */
+static void tokens_scan_range(Tokens *restrict tokens,
+                              char const *buffer,
+                              u32         begin,
+                              u32         end) {
+    Lexer lexer;
+    lexer_init(&lexer);
+    lexer_set_view(&lexer, buffer + begin, end - begin);
+
+    while (true) {
+        Token token = lexer_scan(&lexer);
+        if (token == TOK_END) { return; }
+
+        StringView text = lexer_current_text(&lexer);
+        tokens_append(
+            tokens, token, (u32)(text.ptr - buffer), (u32)text.length);
+    }
+}
+
+typedef struct TokensChunk {
+    char const *buffer;
+    u32         begin;
+    u32         end;
+    Tokens      tokens;
+} TokensChunk;
+
+static void tokens_scan_chunk(void *argument) {
+    TokensChunk *chunk = argument;
+    tokens_create(&chunk->tokens);
+    tokens_reserve(&chunk->tokens, ((chunk->end - chunk->begin) / 8) + 2);
+    tokens_scan_range(
+        &chunk->tokens, chunk->buffer, chunk->begin, chunk->end);
+}
+
+static bool tokens_search(Tokens const *restrict tokens,
+                          u32 offset,
+                          u32 *restrict index) {
+    u32 low  = 0;
+    u32 high = tokens->count;
+    while (low < high) {
+        u32 middle = low + ((high - low) / 2);
+        if (tokens->offsets[middle] < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    *index = low;
+    return (low < tokens->count) && (tokens->offsets[low] == offset);
+}
+
+/*
+ * a string literal which crosses the end of a chunk is scanned as
+ * unmatched, and the chunks after it were scanned starting within the
+ * literal. so rescan from the end of the token before the literal,
+ * until a token starts where a token of a later chunk also starts.
+ * the lexer holds no state besides its position, so from there on
+ * the later chunk agrees with a scan of the whole buffer.
+ */
+static void tokens_rescan(Tokens *restrict tokens,
+                          TokensChunk const *chunks,
+                          u64                count,
+                          u32                begin,
+                          u64 *restrict chunk,
+                          u32 *restrict next) {
+    char const *buffer = chunks[0].buffer;
+    u32         length = chunks[count - 1].end;
+    Lexer       lexer;
+    lexer_init(&lexer);
+    lexer_set_view(&lexer, buffer + begin, length - begin);
+
+    u64 later = *chunk + 1;
+    while (true) {
+        Token token = lexer_scan(&lexer);
+        if (token == TOK_END) {
+            *chunk = count;
+            return;
+        }
+
+        StringView text   = lexer_current_text(&lexer);
+        u32        offset = (u32)(text.ptr - buffer);
+        while ((later < count) && (offset >= chunks[later].end)) {
+            ++later;
+        }
+
+        // the offset of a string literal excludes its opening quote,
+        // so the kinds must agree too, for the scans to have started
+        // the token at the same position.
+        if ((later < count) &&
+            tokens_search(&chunks[later].tokens, offset, next) &&
+            (chunks[later].tokens.kinds[*next] == token)) {
+            *chunk = later;
+            return;
+        }
+
+        tokens_append(tokens, token, offset, (u32)text.length);
+    }
+}
+
+static void tokens_stitch(Tokens *restrict tokens,
+                          TokensChunk const *chunks,
+                          u64                count) {
+    u64 chunk = 0;
+    u32 next  = 0;
+    while (chunk < count) {
+        Tokens const *part   = &chunks[chunk].tokens;
+        u32           last   = part->count;
+        bool          broken = ((chunk + 1) < count) && (last > 0) &&
+                      (part->kinds[last - 1] ==
+                       TOK_ERROR_UNMATCHED_DOUBLE_QUOTE);
+        u32 end = broken ? (last - 1) : last;
+
+        if (next < end) {
+            u32 n = end - next;
+            tokens_ensure(tokens, n);
+            memcpy(tokens->kinds + tokens->count, part->kinds + next, n);
+            memcpy(tokens->offsets + tokens->count,
+                   part->offsets + next,
+                   n * sizeof(*tokens->offsets));
+            memcpy(tokens->lengths + tokens->count,
+                   part->lengths + next,
+                   n * sizeof(*tokens->lengths));
+            tokens->count += n;
+        }
+
+        if (!broken) {
+            chunk += 1;
+            next = 0;
+            continue;
+        }
+
+        u32 begin = (last > 1)
+                      ? (part->offsets[last - 2] + part->lengths[last - 2])
+                      : chunks[chunk].begin;
+        tokens_rescan(tokens, chunks, count, begin, &chunk, &next);
+    }
+}
+
+void tokens_scan_chunked(Tokens *restrict tokens,
+                         char const *buffer,
+                         u64         length,
+                         u64         chunk_count) {
+    assert(tokens != NULL);
+    assert(buffer != NULL);
+    assert(length <= UINT32_MAX);
+    assert(chunk_count > 0);
+    tokens->buffer = buffer;
+
+    // chunks end just after a newline, so that no identifier,
+    // integer or comment is split between two chunks.
+    TokensChunk *chunks = callocate(chunk_count, sizeof(TokensChunk));
+    u32          begin  = 0;
+    for (u64 index = 0; index < chunk_count; ++index) {
+        u32 end = (u32)length;
+        if ((index + 1) < chunk_count) {
+            u64 split = ((index + 1) * length) / chunk_count;
+            if (split < begin) { split = begin; }
+            char const *newline =
+                memchr(buffer + split, '\n', (size_t)(length - split));
+            if (newline != NULL) { end = (u32)(newline - buffer) + 1; }
+        }
+
+        chunks[index].buffer = buffer;
+        chunks[index].begin  = begin;
+        chunks[index].end    = end;
+        begin                = end;
+    }
+
+    if (chunk_count == 1) {
+        tokens_scan_chunk(chunks);
+    } else {
+        ThreadPool workers;
+        thread_pool_create(&workers, chunk_count);
+        for (u64 index = 0; index < chunk_count; ++index) {
+            thread_pool_submit(&workers, tokens_scan_chunk, chunks + index);
+        }
+        thread_pool_wait(&workers);
+        thread_pool_destroy(&workers);
+    }
+
+    u64 total = 0;
+    for (u64 index = 0; index < chunk_count; ++index) {
+        total += chunks[index].tokens.count;
+    }
+    if (tokens->capacity <= (tokens->count + total + 1)) {
+        tokens_reserve(tokens, (u32)(tokens->count + total + 2));
+    }
+
+    tokens_stitch(tokens, chunks, chunk_count);
+    tokens_append(tokens, TOK_END, (u32)length, 0);
+
+    for (u64 index = 0; index < chunk_count; ++index) {
+        tokens_destroy(&chunks[index].tokens);
+    }
+    deallocate(chunks);
+}
+
+void tokens_scan(Tokens *restrict tokens, char const *buffer, u64 length) {
+    assert(tokens != NULL);
+    assert(buffer != NULL);
+    assert(length <= UINT32_MAX);
+
+    u64 chunk_count = 1;
+    if (length >= TOKENS_PARALLEL_THRESHOLD) {
+        chunk_count = thread_pool_hardware_concurrency();
+        // when scanning on a worker of another pool, such as the one
+        // compiling each source of a batch, take only our share of the
+        // threads, so that the two pools do not oversubscribe the host.
+        ThreadPool *enclosing = thread_pool_current();
+        if (enclosing != NULL) {
+            chunk_count /= enclosing->thread_count;
+            if (chunk_count == 0) { chunk_count = 1; }
+        }
+        if (chunk_count > (length / TOKENS_CHUNK_MINIMUM)) {
+            chunk_count = length / TOKENS_CHUNK_MINIMUM;
+        }
+    }
+
+    if (chunk_count > 1) {
+        tokens_scan_chunked(tokens, buffer, length, chunk_count);
+        return;
+    }
+
+    tokens->buffer = buffer;
+
+    // a guess at the number of tokens, so that a large buffer
+    // does not grow the arrays through every intermediate size.
+    if (tokens->capacity == 0) {
+        tokens_reserve(tokens, (u32)(length / 8) + 2);
+    }
+
+    tokens_scan_range(tokens, buffer, 0, (u32)length);
+    tokens_append(tokens, TOK_END, (u32)length, 0);
+}
+
+Token tokens_kind(Tokens const *restrict tokens, u32 index) {
+    assert(tokens != NULL);
+    assert(tokens->count > 0);
+    if (index >= tokens->count) { return TOK_END; }
+    return (Token)tokens->kinds[index];
+}
+
+StringView tokens_text(Tokens const *restrict tokens, u32 index) {
+    assert(tokens != NULL);
+    assert(tokens->count > 0);
+    if (index >= tokens->count) { index = tokens->count - 1; }
+    return string_view(tokens->buffer + tokens->offsets[index],
+                       tokens->lengths[index]);
+}
+
+u64 tokens_line(Tokens const *restrict tokens, u32 index) {
+    assert(tokens != NULL);
+    assert(tokens->count > 0);
+    if (index >= tokens->count) { index = tokens->count - 1; }
+
+    u64         line   = 1;
+    char const *cursor = tokens->buffer;
+    char const *end    = tokens->buffer + tokens->offsets[index];
+    while ((cursor = memchr(cursor, '\n', (size_t)(end - cursor))) != NULL) {
+        ++line;
+        ++cursor;
+    }
+    return line;
+}
@@ -17,6 +17,8 @@
 #ifndef EXP_SUPPORT_MALLOC_H
 #define EXP_SUPPORT_MALLOC_H
 
+#include <stdio.h>
+
 #include "support/scalar.h"
 
 /**
@@ -52,4 +54,25 @@ void *reallocate(void *ptr, u64 size);
  */
 void deallocate(void *ptr);
 
+/**
+ * @brief the tagged variants attribute the allocation to the subsystem
+ * named by <tag>, which must be a string literal.
+ *
+ * @note tags are only recorded when built with EXP_ALLOCATION_STATISTICS,
+ * otherwise these are identical to their untagged counterparts, which
+ * use the tag "untagged".
+ */
+void *allocate_tagged(char const *tag, u64 size);
+void *callocate_tagged(char const *tag, u64 num, u64 size);
+void *reallocate_tagged(char const *tag, void *ptr, u64 size);
+
+/**
+ * @brief print the calls, bytes, peak live bytes and the copies made
+ * by a growing reallocate, of each tag.
+ *
+ * @note when built with EXP_ALLOCATION_STATISTICS this is called
+ * on exit, writing to stderr. otherwise it prints nothing.
+ */
+void allocation_statistics_print(FILE *restrict stream);
+
 #endif // !EXP_SUPPORT_MALLOC_H
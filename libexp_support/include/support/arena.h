@@ -0,0 +1,70 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_SUPPORT_ARENA_H
+#define EXP_SUPPORT_ARENA_H
+
+#include <stddef.h>
+
+#include "support/scalar.h"
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    u64                size;
+    u64                used;
+    alignas(max_align_t) char bytes[];
+} ArenaChunk;
+
+/**
+ * @brief a region allocator, objects are bump allocated from a list
+ * of chunks, newest first, and are only ever freed all at once.
+ *
+ * @note chunks start small and double in size up to a limit, so a
+ * small region costs little, and a large one needs few allocations.
+ * objects allocated together are adjacent in memory.
+ */
+typedef struct Arena {
+    ArenaChunk *chunks;
+} Arena;
+
+Arena arena_create();
+
+/**
+ * @brief free every chunk, and with them every object
+ * allocated from the arena.
+ */
+void arena_destroy(Arena *restrict arena);
+
+/**
+ * @brief free every object allocated from the arena, keeping the
+ * newest (and largest) chunk for reuse.
+ */
+void arena_clear(Arena *restrict arena);
+
+/**
+ * @brief allocate <size> bytes aligned to <alignment>, which must be
+ * a power of two no greater than alignof(max_align_t).
+ *
+ * @note the memory is not initialized.
+ */
+void *arena_allocate(Arena *restrict arena, u64 size, u64 alignment);
+
+/**
+ * @brief as arena_allocate, but the memory is zeroed.
+ */
+void *arena_callocate(Arena *restrict arena, u64 size, u64 alignment);
+
+#endif // !EXP_SUPPORT_ARENA_H
@@ -21,9 +21,29 @@
 /**
  * @brief computes the hash of the given string.
  *
+ * @note the string is hashed a word at a time, and every bit of the
+ * result depends on every byte, so the low bits alone may index a
+ * power of two sized table. the result is not portable across hosts
+ * of different endianness, it must not be persisted.
+ *
  * @param string
  * @return u64
  */
 u64 hash_cstring(char const *restrict string, u64 length);
 
+#define HASH_FNV1A_OFFSET_BASIS 14695981039346656037ul
+
+/**
+ * @brief fold the given bytes into <hash> using 64 bit FNV-1a.
+ *
+ * @note this allows data which is not contiguous to be hashed
+ * in pieces. the first piece is folded into HASH_FNV1A_OFFSET_BASIS.
+ *
+ * @param hash
+ * @param bytes
+ * @param length
+ * @return u64
+ */
+u64 hash_fnv1a(u64 hash, void const *restrict bytes, u64 length);
+
 #endif // !EXP_UTILITY_HASH_H
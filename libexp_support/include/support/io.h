@@ -38,4 +38,33 @@ void file_write_i64(i64 value, FILE *restrict stream);
 void file_write_u64(u64 value, FILE *restrict stream);
 u64 file_read(char *restrict buffer, u64 size, FILE *restrict stream);
 
+/**
+ * @brief create an anonymous file which lives only in memory.
+ *
+ * @note the file can be opened by path, both by us and by our
+ * child processes, as "/proc/self/fd/<fd>".
+ */
+i32 memory_file_create(char const *restrict name);
+void memory_file_close(i32 fd);
+
+/**
+ * @brief a file mapped read only into memory.
+ *
+ * @note the contents are always followed by at least one zero
+ * byte, so they may be read as a cstring.
+ */
+typedef struct MappedFile {
+    char const *contents;
+    u64         length;
+    u64         size;
+} MappedFile;
+
+/**
+ * @brief map the file at <path> into memory
+ *
+ * @note the file must not be truncated while it is mapped.
+ */
+void file_map(MappedFile *restrict mapped, char const *restrict path);
+void file_unmap(MappedFile *restrict mapped);
+
 #endif // !EXP_SUPPORT_IO_H
@@ -18,6 +18,18 @@
 #define EXP_UTILITY_PROCESS_H
 
 #include "support/scalar.h"
+#include "support/string.h"
+
+/**
+ * @brief a child process which has been started but not yet waited on.
+ */
+typedef struct Process {
+    i32          pid;
+    String       cmd;
+    i32          argc;
+    String      *args;
+    char const **argv;
+} Process;
 
 /**
  * @brief fork/execvp the given file, passing args
@@ -30,4 +42,49 @@
  */
 i32 process(char const *executable, i32 argc, char const *argv[]);
 
+/**
+ * @brief fork/execvp the given file, passing args, without waiting
+ * for it to exit.
+ *
+ * @note this allows the caller to have many children running at
+ * once. every spawned process must be given to process_await.
+ *
+ * @warning args must have a NULL at the end
+ */
+void process_spawn(Process *restrict process,
+                   char const *executable,
+                   i32         argc,
+                   char const *argv[]);
+
+/**
+ * @brief wait for a spawned process to exit
+ *
+ * @return the exit status of the process, or EXIT_FAILURE
+ * if it did not exit normally.
+ */
+i32 process_await(Process *restrict process);
+
+/**
+ * @brief fork/execvp the given file, connecting its stdin and stdout
+ * to pipes.
+ *
+ * @note if input.ptr is NULL the child inherits our stdin, otherwise
+ * <input> is written to the child's stdin.
+ * if output is NULL the child inherits our stdout, otherwise
+ * everything the child writes to stdout is appended to <output>.
+ *
+ * @warning args must have a NULL at the end
+ *
+ * @param executable
+ * @param args
+ * @param input
+ * @param output
+ * @return i32
+ */
+i32 process_piped(char const *executable,
+                  i32         argc,
+                  char const *argv[],
+                  StringView  input,
+                  String *restrict output);
+
 #endif // !EXP_UTILITY_PROCESS_H
@@ -0,0 +1,91 @@
+// Copyright (C) 2024 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef EXP_SUPPORT_THREAD_POOL_H
+#define EXP_SUPPORT_THREAD_POOL_H
+
+#include <pthread.h>
+
+#include "support/scalar.h"
+
+typedef void (*ThreadPoolTask)(void *argument);
+
+typedef struct ThreadPoolJob {
+    ThreadPoolTask task;
+    void          *argument;
+} ThreadPoolJob;
+
+/**
+ * @brief the jobs which have been submitted, but not yet started.
+ *
+ * @note jobs are started in the order they were submitted,
+ * [head, count) are waiting.
+ */
+typedef struct ThreadPoolQueue {
+    u64            head;
+    u64            count;
+    u64            capacity;
+    ThreadPoolJob *buffer;
+} ThreadPoolQueue;
+
+/**
+ * @brief a fixed number of worker threads which run submitted jobs.
+ */
+typedef struct ThreadPool {
+    pthread_mutex_t lock;
+    pthread_cond_t  work_available;
+    pthread_cond_t  work_finished;
+    ThreadPoolQueue queue;
+    u64             running;
+    bool            stopping;
+    u64             thread_count;
+    pthread_t      *threads;
+} ThreadPool;
+
+/**
+ * @brief the number of threads the host can run at once
+ */
+u64 thread_pool_hardware_concurrency();
+
+/**
+ * @brief the pool the calling thread is a worker of, or NULL when the
+ * calling thread belongs to no pool
+ */
+ThreadPool *thread_pool_current();
+
+/**
+ * @brief start <thread_count> worker threads
+ */
+void thread_pool_create(ThreadPool *restrict pool, u64 thread_count);
+
+/**
+ * @brief wait for all submitted jobs, then join the worker threads
+ */
+void thread_pool_destroy(ThreadPool *restrict pool);
+
+/**
+ * @brief run task(argument) on one of the worker threads
+ */
+void thread_pool_submit(ThreadPool *restrict pool,
+                        ThreadPoolTask task,
+                        void          *argument);
+
+/**
+ * @brief block until every submitted job has finished
+ */
+void thread_pool_wait(ThreadPool *restrict pool);
+
+#endif // !EXP_SUPPORT_THREAD_POOL_H
@@ -0,0 +1,48 @@
+// Copyright (C) 2025 Cade Weinberg
+//
+// This file is part of exp.
+//
+// exp is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// exp is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with exp.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef EXP_SUPPORT_TIMER_H
+#define EXP_SUPPORT_TIMER_H
+
+#include "support/scalar.h"
+
+/**
+ * @brief a point in time, along with the memory in use at that point.
+ *
+ * @note nanoseconds are measured from an arbitrary, but fixed, point
+ * with CLOCK_MONOTONIC, so only the difference of two samples is
+ * meaningful. resident_bytes is the resident set size of the whole
+ * process, not of the calling thread.
+ */
+typedef struct TimerSample {
+    u64 nanoseconds;
+    u64 resident_bytes;
+} TimerSample;
+
+TimerSample timer_sample();
+
+/**
+ * @brief the nanoseconds elapsed between <start> and <stop>
+ */
+u64 timer_elapsed(TimerSample start, TimerSample stop);
+
+/**
+ * @brief the change in resident set size between <start> and <stop>,
+ * negative if memory was returned to the system.
+ */
+i64 timer_resident_delta(TimerSample start, TimerSample stop);
+
+#endif // !EXP_SUPPORT_TIMER_H
@@ -19,24 +19,285 @@
 #include <stdlib.h>
 
 #include "support/allocation.h"
+#include "support/config.h"
 #include "support/panic.h"
 
-void *allocate(u64 size) {
+void *allocate(u64 size) { return allocate_tagged("untagged", size); }
+
+void *callocate(u64 num, u64 size) {
+    return callocate_tagged("untagged", num, size);
+}
+
+void *reallocate(void *ptr, u64 size) {
+    return reallocate_tagged("untagged", ptr, size);
+}
+
+#if defined(EXP_ALLOCATION_STATISTICS)
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "support/io.h"
+#include "support/numeric_conversions.h"
+
+/*
+ * every block is preceded by a header recording its size and tag,
+ * so that deallocate and reallocate can account for the block.
+ * the header is a multiple of the strictest alignment malloc
+ * guarantees, so the block handed out keeps that alignment.
+ */
+typedef struct AllocationHeader {
+    u64 size;
+    u64 tag;
+} AllocationHeader;
+
+static_assert((sizeof(AllocationHeader) % alignof(max_align_t)) == 0,
+              "allocations must stay aligned");
+
+typedef struct AllocationStatistics {
+    char const *tag;
+    u64         allocations;
+    u64         reallocations;
+    u64         deallocations;
+    u64         bytes;
+    u64         live_bytes;
+    u64         peak_live_bytes;
+    u64         growth_copies;
+    u64         bytes_copied;
+} AllocationStatistics;
+
+// tags beyond the last are counted together in the last.
+#define ALLOCATION_TAGS_MAX 32
+
+static pthread_mutex_t      allocation_lock = PTHREAD_MUTEX_INITIALIZER;
+static AllocationStatistics allocation_statistics[ALLOCATION_TAGS_MAX];
+static u64                  allocation_tag_count       = 0;
+static u64                  allocation_live_bytes      = 0;
+static u64                  allocation_peak_live_bytes = 0;
+
+static void allocation_statistics_exit() {
+    allocation_statistics_print(stderr);
+}
+
+static void allocation_lock_acquire() {
+    if (pthread_mutex_lock(&allocation_lock) != 0) {
+        PANIC("pthread_mutex_lock failed");
+    }
+}
+
+static void allocation_lock_release() {
+    if (pthread_mutex_unlock(&allocation_lock) != 0) {
+        PANIC("pthread_mutex_unlock failed");
+    }
+}
+
+// the lock must be held
+static u64 allocation_tag_index(char const *tag) {
+    for (u64 index = 0; index < allocation_tag_count; ++index) {
+        char const *name = allocation_statistics[index].tag;
+        if ((name == tag) || (strcmp(name, tag) == 0)) { return index; }
+    }
+
+    if (allocation_tag_count == 0) { atexit(allocation_statistics_exit); }
+
+    if (allocation_tag_count == ALLOCATION_TAGS_MAX) {
+        allocation_statistics[ALLOCATION_TAGS_MAX - 1].tag = "other";
+        return ALLOCATION_TAGS_MAX - 1;
+    }
+
+    allocation_statistics[allocation_tag_count].tag = tag;
+    return allocation_tag_count++;
+}
+
+// the lock must be held
+static void allocation_live_add(AllocationStatistics *restrict statistics,
+                                u64 size) {
+    statistics->live_bytes += size;
+    if (statistics->live_bytes > statistics->peak_live_bytes) {
+        statistics->peak_live_bytes = statistics->live_bytes;
+    }
+
+    allocation_live_bytes += size;
+    if (allocation_live_bytes > allocation_peak_live_bytes) {
+        allocation_peak_live_bytes = allocation_live_bytes;
+    }
+}
+
+// the lock must be held
+static void allocation_live_remove(AllocationStatistics *restrict statistics,
+                                   u64 size) {
+    statistics->live_bytes -= size;
+    allocation_live_bytes -= size;
+}
+
+static void *allocation_track(char const *tag,
+                              AllocationHeader *restrict header,
+                              u64 size) {
+    allocation_lock_acquire();
+    u64                   index      = allocation_tag_index(tag);
+    AllocationStatistics *statistics = allocation_statistics + index;
+    statistics->allocations += 1;
+    statistics->bytes += size;
+    allocation_live_add(statistics, size);
+    allocation_lock_release();
+
+    header->size = size;
+    header->tag  = index;
+    return header + 1;
+}
+
+void *allocate_tagged(char const *tag, u64 size) {
+    AllocationHeader *header = malloc(sizeof(AllocationHeader) + size);
+    if (header == NULL) { PANIC_ERRNO("malloc failed"); }
+    return allocation_track(tag, header, size);
+}
+
+void *callocate_tagged(char const *tag, u64 num, u64 size) {
+    u64 total = num * size;
+    if ((num != 0) && ((total / num) != size)) {
+        PANIC("calloc size overflow");
+    }
+
+    AllocationHeader *header = calloc(1, sizeof(AllocationHeader) + total);
+    if (header == NULL) { PANIC_ERRNO("calloc failed"); }
+    return allocation_track(tag, header, total);
+}
+
+void *reallocate_tagged(char const *tag, void *ptr, u64 size) {
+    if (ptr == NULL) { return allocate_tagged(tag, size); }
+
+    AllocationHeader *old         = (AllocationHeader *)ptr - 1;
+    uintptr_t         old_address = (uintptr_t)old;
+    u64               old_size    = old->size;
+    u64               old_tag     = old->tag;
+
+    AllocationHeader *header = realloc(old, sizeof(AllocationHeader) + size);
+    if (header == NULL) { PANIC_ERRNO("reallocate failed."); }
+
+    allocation_lock_acquire();
+    allocation_live_remove(allocation_statistics + old_tag, old_size);
+    u64                   index      = allocation_tag_index(tag);
+    AllocationStatistics *statistics = allocation_statistics + index;
+    statistics->reallocations += 1;
+    statistics->bytes += size;
+    if ((uintptr_t)header != old_address) {
+        statistics->growth_copies += 1;
+        statistics->bytes_copied += (old_size < size) ? old_size : size;
+    }
+    allocation_live_add(statistics, size);
+    allocation_lock_release();
+
+    header->size = size;
+    header->tag  = index;
+    return header + 1;
+}
+
+void deallocate(void *ptr) {
+    if (ptr == NULL) { return; }
+
+    AllocationHeader *header = (AllocationHeader *)ptr - 1;
+    allocation_lock_acquire();
+    AllocationStatistics *statistics = allocation_statistics + header->tag;
+    statistics->deallocations += 1;
+    allocation_live_remove(statistics, header->size);
+    allocation_lock_release();
+
+    free(header);
+}
+
+static void print_padding(u64 length, u64 width, FILE *restrict stream) {
+    while (length++ < width) {
+        file_write(SV(" "), stream);
+    }
+}
+
+static void print_column(u64 value, FILE *restrict stream) {
+    print_padding(u64_safe_strlen(value), 14, stream);
+    file_write_u64(value, stream);
+}
+
+static void print_row(AllocationStatistics const *restrict statistics,
+                      FILE *restrict stream) {
+    StringView tag = string_view_from_cstring(statistics->tag);
+    file_write(tag, stream);
+    print_padding(tag.length, 16, stream);
+    print_column(statistics->allocations, stream);
+    print_column(statistics->reallocations, stream);
+    print_column(statistics->deallocations, stream);
+    print_column(statistics->bytes, stream);
+    print_column(statistics->peak_live_bytes, stream);
+    print_column(statistics->live_bytes, stream);
+    print_column(statistics->growth_copies, stream);
+    print_column(statistics->bytes_copied, stream);
+    file_write(SV("\n"), stream);
+}
+
+void allocation_statistics_print(FILE *restrict stream) {
+    // printing must not allocate while holding the lock,
+    // so the statistics are copied out first.
+    AllocationStatistics statistics[ALLOCATION_TAGS_MAX];
+    allocation_lock_acquire();
+    u64 count = allocation_tag_count;
+    memcpy(statistics, allocation_statistics, sizeof(statistics));
+    AllocationStatistics total = {.tag             = "total",
+                                  .live_bytes      = allocation_live_bytes,
+                                  .peak_live_bytes =
+                                      allocation_peak_live_bytes};
+    allocation_lock_release();
+
+    for (u64 index = 0; index < count; ++index) {
+        total.allocations += statistics[index].allocations;
+        total.reallocations += statistics[index].reallocations;
+        total.deallocations += statistics[index].deallocations;
+        total.bytes += statistics[index].bytes;
+        total.growth_copies += statistics[index].growth_copies;
+        total.bytes_copied += statistics[index].bytes_copied;
+    }
+
+    file_write(SV("tag"), stream);
+    print_padding(3, 16, stream);
+    StringView headings[] = {SV("allocate"),
+                             SV("reallocate"),
+                             SV("deallocate"),
+                             SV("bytes"),
+                             SV("peak live"),
+                             SV("live"),
+                             SV("growth copies"),
+                             SV("bytes copied")};
+    for (u64 index = 0; index < sizeof(headings) / sizeof(*headings);
+         ++index) {
+        print_padding(headings[index].length, 14, stream);
+        file_write(headings[index], stream);
+    }
+    file_write(SV("\n"), stream);
+    for (u64 index = 0; index < count; ++index) {
+        print_row(statistics + index, stream);
+    }
+    print_row(&total, stream);
+}
+#else
+void *allocate_tagged([[maybe_unused]] char const *tag, u64 size) {
     void *result = malloc(size);
     if (result == NULL) { PANIC_ERRNO("malloc failed"); }
     return result;
 }
 
-void *callocate(u64 num, u64 size) {
+void *callocate_tagged([[maybe_unused]] char const *tag, u64 num, u64 size) {
     void *result = calloc(num, size);
     if (result == NULL) { PANIC_ERRNO("calloc failed"); }
     return result;
 }
 
-void *reallocate(void *ptr, u64 size) {
+void *reallocate_tagged([[maybe_unused]] char const *tag,
+                        void *ptr,
+                        u64   size) {
     void *result = realloc(ptr, size);
     if (result == NULL) { PANIC_ERRNO("reallocate failed."); }
     return result;
 }
 
 void deallocate(void *ptr) { free(ptr); }
+
+void allocation_statistics_print([[maybe_unused]] FILE *restrict stream) {}
+#endif
@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <string.h>
+
+#include "support/allocation.h"
+#include "support/arena.h"
+
+#define ARENA_CHUNK_MINIMUM 4096
+#define ARENA_CHUNK_MAXIMUM (1ul << 20)
+
+Arena arena_create() {
+    Arena arena;
+    arena.chunks = NULL;
+    return arena;
+}
+
+static void arena_free_chunks(ArenaChunk *chunk) {
+    while (chunk != NULL) {
+        ArenaChunk *next = chunk->next;
+        deallocate(chunk);
+        chunk = next;
+    }
+}
+
+void arena_destroy(Arena *restrict arena) {
+    assert(arena != NULL);
+    arena_free_chunks(arena->chunks);
+    arena->chunks = NULL;
+}
+
+void arena_clear(Arena *restrict arena) {
+    assert(arena != NULL);
+    ArenaChunk *chunk = arena->chunks;
+    if (chunk == NULL) { return; }
+    arena_free_chunks(chunk->next);
+    chunk->next = NULL;
+    chunk->used = 0;
+}
+
+void *arena_allocate(Arena *restrict arena, u64 size, u64 alignment) {
+    assert(arena != NULL);
+    assert((alignment != 0) && ((alignment & (alignment - 1)) == 0));
+    assert(alignment <= alignof(max_align_t));
+
+    ArenaChunk *chunk = arena->chunks;
+    u64 offset = (chunk == NULL) ? 0
+                                 : ((chunk->used + alignment - 1) &
+                                    ~(alignment - 1));
+    if ((chunk == NULL) || (offset > chunk->size) ||
+        ((chunk->size - offset) < size)) {
+        u64 chunk_size =
+            (chunk == NULL) ? ARENA_CHUNK_MINIMUM : (chunk->size * 2);
+        if (chunk_size > ARENA_CHUNK_MAXIMUM) {
+            chunk_size = ARENA_CHUNK_MAXIMUM;
+        }
+        if (chunk_size < size) { chunk_size = size; }
+
+        ArenaChunk *fresh =
+            allocate_tagged("arena", sizeof(ArenaChunk) + chunk_size);
+        fresh->next   = chunk;
+        fresh->size   = chunk_size;
+        fresh->used   = 0;
+        arena->chunks = fresh;
+        chunk         = fresh;
+        offset        = 0;
+    }
+
+    chunk->used = offset + size;
+    return chunk->bytes + offset;
+}
+
+void *arena_callocate(Arena *restrict arena, u64 size, u64 alignment) {
+    void *memory = arena_allocate(arena, size, alignment);
+    memset(memory, 0, size);
+    return memory;
+}
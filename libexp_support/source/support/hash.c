@@ -16,21 +16,93 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <string.h>
+
 #include "support/hash.h"
 
-// non-crypto hash algorithm based on djb2
-// https://stackoverflow.com/questions/7666509/hash-function-for-string
-// specifically this answer https://stackoverflow.com/a/69812981
+/*
+ * the primes and the final avalanche are those of xxHash64,
+ * https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ */
+#define HASH_PRIME_1 0x9E3779B185EBCA87ul
+#define HASH_PRIME_2 0xC2B2AE3D27D4EB4Ful
+#define HASH_PRIME_3 0x165667B19E3779F9ul
+#define HASH_PRIME_4 0x85EBCA77C2B2AE63ul
+#define HASH_PRIME_5 0x27D4EB2F165667C5ul
+
+static inline u64 hash_rotate(u64 value, u32 bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline u64 hash_read_u64(u8 const *bytes) {
+    u64 value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline u64 hash_read_u32(u8 const *bytes) {
+    u32 value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline u64 hash_round(u64 hash, u64 word) {
+    word *= HASH_PRIME_2;
+    word  = hash_rotate(word, 31);
+    word *= HASH_PRIME_1;
+    hash ^= word;
+    return (hash_rotate(hash, 27) * HASH_PRIME_1) + HASH_PRIME_4;
+}
+
 u64 hash_cstring(char const *restrict string, u64 length) {
-    // generated randomly using:
-    // https://asecuritysite.com/encryption/nprimes?y=64 no testing has been
-    // done to check if this prime is "good"
-#define LARGE_PRIME 11931085111904720063ul
-
-    u64 hash = 5381;
-    for (u64 i = 0; i < length; ++i)
-        hash = (LARGE_PRIME * hash) + (u8)(string[i]);
+    // the string is consumed 8 bytes at a time, the tail of less
+    // than 8 bytes is read as, at most, two overlapping words. so
+    // every byte is read once or twice, and never one at a time,
+    // unless the whole string is shorter than 4 bytes.
+    u8 const *cursor = (u8 const *)string;
+    u64       hash   = HASH_PRIME_5 + length;
+
+    u64 remaining = length;
+    while (remaining >= 8) {
+        hash = hash_round(hash, hash_read_u64(cursor));
+        cursor += 8;
+        remaining -= 8;
+    }
+
+    if (remaining >= 4) {
+        u64 word = hash_read_u32(cursor) |
+                   (hash_read_u32(cursor + remaining - 4) << 32);
+        hash = hash_round(hash, word);
+    } else if (remaining > 0) {
+        u64 word = ((u64)cursor[0] << 16) |
+                   ((u64)cursor[remaining / 2] << 8) |
+                   (u64)cursor[remaining - 1];
+        hash = hash_round(hash, word);
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+#undef HASH_PRIME_1
+#undef HASH_PRIME_2
+#undef HASH_PRIME_3
+#undef HASH_PRIME_4
+#undef HASH_PRIME_5
+
+u64 hash_fnv1a(u64 hash, void const *restrict bytes, u64 length) {
+#define FNV1A_PRIME 1099511628211ul
+
+    u8 const *cursor = bytes;
+    for (u64 i = 0; i < length; ++i) {
+        hash ^= cursor[i];
+        hash *= FNV1A_PRIME;
+    }
     return hash;
 
-#undef LARGE_PRIME
+#undef FNV1A_PRIME
 }
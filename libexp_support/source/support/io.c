@@ -16,10 +16,14 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
+// memfd_create(2) is a GNU extension
+#define _GNU_SOURCE
+
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "support/allocation.h"
 #include "support/config.h"
 #include "support/io.h"
 #include "support/numeric_conversions.h"
@@ -70,10 +74,25 @@ u64 file_read(char *restrict buffer, u64 length, FILE *restrict stream) {
 }
 
 #if defined(EXP_HOST_SYSTEM_LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+i32 memory_file_create(char const *restrict name) {
+    assert(name != NULL);
+    // the descriptor is deliberately inherited across exec, so that
+    // child processes can open it by way of its /proc/self/fd path.
+    i32 fd = memfd_create(name, 0);
+    if (fd < 0) { PANIC_ERRNO("memfd_create failed"); }
+    return fd;
+}
+
+void memory_file_close(i32 fd) {
+    if (close(fd) != 0) { PANIC_ERRNO("close failed"); }
+}
+
 u64 file_length(FILE *restrict file) {
     i32 fd = fileno(file);
 
@@ -83,6 +102,55 @@ u64 file_length(FILE *restrict file) {
     return (u64)info.st_size;
 }
 
+void file_map(MappedFile *restrict mapped, char const *restrict path) {
+    assert(mapped != NULL);
+    assert(path != NULL);
+    i32 fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { PANIC_ERRNO("open failed"); }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) { PANIC_ERRNO("fstat failed"); }
+
+    // reserve at least one page past the end of the file. the kernel
+    // zero fills both the anonymous reservation and the tail of the
+    // last page of the file, which gives us the terminating zero
+    // without copying the file.
+    u64   length = (u64)info.st_size;
+    u64   page   = (u64)sysconf(_SC_PAGESIZE);
+    u64   size   = ((length / page) + 1) * page;
+    void *base =
+        mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) { PANIC_ERRNO("mmap failed"); }
+
+    if ((length > 0) &&
+        (mmap(base, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) ==
+         MAP_FAILED)) {
+        PANIC_ERRNO("mmap failed");
+    }
+
+    // the lexer reads the file front to back, exactly once.
+    if ((length > 0) && (madvise(base, length, MADV_SEQUENTIAL) != 0)) {
+        PANIC_ERRNO("madvise failed");
+    }
+
+    if (close(fd) != 0) { PANIC_ERRNO("close failed"); }
+
+    mapped->contents = base;
+    mapped->length   = length;
+    mapped->size     = size;
+}
+
+void file_unmap(MappedFile *restrict mapped) {
+    assert(mapped != NULL);
+    if (mapped->contents == NULL) { return; }
+    if (munmap((void *)mapped->contents, mapped->size) != 0) {
+        PANIC_ERRNO("munmap failed");
+    }
+    mapped->contents = NULL;
+    mapped->length   = 0;
+    mapped->size     = 0;
+}
+
 #else
 u64 file_length(FILE *restrict file) {
     if (fseek(file, 0L, SEEK_END) != 0) { PANIC_ERRNO("fseek failed"); }
@@ -93,4 +161,26 @@ u64 file_length(FILE *restrict file) {
     rewind(file);
     return (u64)size;
 }
+
+void file_map(MappedFile *restrict mapped, char const *restrict path) {
+    assert(mapped != NULL);
+    assert(path != NULL);
+    FILE *file   = file_open(path, "r");
+    u64   length = file_length(file);
+    char *buffer = callocate(length + 1, sizeof(char));
+    file_read(buffer, length, file);
+    file_close(file);
+
+    mapped->contents = buffer;
+    mapped->length   = length;
+    mapped->size     = length + 1;
+}
+
+void file_unmap(MappedFile *restrict mapped) {
+    assert(mapped != NULL);
+    deallocate((void *)mapped->contents);
+    mapped->contents = NULL;
+    mapped->length   = 0;
+    mapped->size     = 0;
+}
 #endif
@@ -16,82 +16,301 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
+// pipe2(2) is a GNU extension
+#define _GNU_SOURCE
 
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
 #include <stdlib.h>
 
+#include "support/allocation.h"
 #include "support/config.h"
 #include "support/message.h"
 #include "support/panic.h"
 #include "support/process.h"
+#include "support/string.h"
 
 #if defined(EXP_HOST_SYSTEM_LINUX)
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
-i32 process(char const *cmd, i32 argc, char const *argv[]) {
+// the most either direction of process_transfer moves at once, so
+// that neither direction can starve the other.
+#define PROCESS_TRANSFER_SIZE 4096
+
+static i32
+process_wait(pid_t pid, char const *cmd, i32 argc, char const *argv[]) {
+    siginfo_t status = {};
+    if (waitid(P_PID, (id_t)pid, &status, WEXITED | WSTOPPED) == -1) {
+        PANIC_ERRNO("waitid failed");
+    }
+
+    switch (status.si_code) {
+    case CLD_EXITED: {
+        i32 result = status.si_status;
+        return result;
+    }
+
+    case CLD_KILLED: {
+        message(MESSAGE_ERROR, NULL, 0, SV("child killed by signal."), stderr);
+        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+        return EXIT_FAILURE;
+    }
+
+    case CLD_DUMPED: {
+        message(MESSAGE_ERROR, NULL, 0, SV("child dumped core."), stderr);
+        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+        return EXIT_FAILURE;
+    }
+
+    case CLD_STOPPED: {
+        message(MESSAGE_ERROR, NULL, 0, SV("child stopped."), stderr);
+        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+        return EXIT_FAILURE;
+    }
+
+    case CLD_TRAPPED: {
+        message(MESSAGE_ERROR, NULL, 0, SV("child trapped."), stderr);
+        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+        return EXIT_FAILURE;
+    }
+
+    case CLD_CONTINUED: {
+        message(MESSAGE_ERROR, NULL, 0, SV("child continued."), stderr);
+        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+        return EXIT_FAILURE;
+    }
+
+    default: {
+        message(MESSAGE_ERROR, NULL, 0, SV("unknown child status."), stderr);
+        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+        return EXIT_FAILURE;
+    }
+    }
+}
+
+[[noreturn]] static void
+process_exec(char const *cmd, i32 argc, char const *argv[]) {
+    execvp(cmd, (char *const *)argv);
+
+    message(MESSAGE_ERROR, NULL, 0, SV("execvp failed"), stderr);
+    trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
+    abort();
+}
+
+void process_spawn(Process *restrict process,
+                   char const *cmd,
+                   i32         argc,
+                   char const *argv[]) {
+    assert(process != NULL);
+    assert(argc >= 0);
     pid_t pid = fork();
     if (pid < 0) {
         PANIC_ERRNO("fork failed");
     } else if (pid == 0) {
         // child process
-        execvp(cmd, (char *const *)argv);
+        process_exec(cmd, argc, argv);
+    }
 
-        message(MESSAGE_ERROR, NULL, 0, SV("execvp failed"), stderr);
-        trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-        abort();
+    // parent process, the arguments are only needed for diagnostics,
+    // but the caller's are not guaranteed to outlive the child.
+    process->pid  = pid;
+    process->cmd  = string_from_cstring(cmd);
+    process->argc = argc;
+    process->args = callocate((u64)argc, sizeof(String));
+    process->argv = callocate((u64)argc + 1, sizeof(char const *));
+    for (i32 index = 0; index < argc; ++index) {
+        process->args[index] = string_from_cstring(argv[index]);
+        process->argv[index] = string_to_cstring(process->args + index);
+    }
+}
+
+i32 process_await(Process *restrict process) {
+    assert(process != NULL);
+    i32 result = process_wait(process->pid,
+                              string_to_cstring(&process->cmd),
+                              process->argc,
+                              process->argv);
+
+    for (i32 index = 0; index < process->argc; ++index) {
+        string_destroy(process->args + index);
+    }
+    deallocate(process->argv);
+    deallocate(process->args);
+    string_destroy(&process->cmd);
+    process->pid  = -1;
+    process->argc = 0;
+    process->args = NULL;
+    process->argv = NULL;
+    return result;
+}
+
+i32 process(char const *cmd, i32 argc, char const *argv[]) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        PANIC_ERRNO("fork failed");
+    } else if (pid == 0) {
+        // child process
+        process_exec(cmd, argc, argv);
     } else {
         // parent process
-        siginfo_t status = {};
-        if (waitid(P_PID, (id_t)pid, &status, WEXITED | WSTOPPED) == -1) {
-            PANIC_ERRNO("waitid failed");
-        }
+        return process_wait(pid, cmd, argc, argv);
+    }
+}
 
-        switch (status.si_code) {
-        case CLD_EXITED: {
-            i32 result = status.si_status;
-            return result;
-        }
+static void process_close(i32 *restrict fd) {
+    if (*fd < 0) { return; }
+    if (close(*fd) != 0) { PANIC_ERRNO("close failed"); }
+    *fd = -1;
+}
 
-        case CLD_KILLED: {
-            message(
-                MESSAGE_ERROR, NULL, 0, SV("child killed by signal."), stderr);
-            trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-            return EXIT_FAILURE;
-        }
+static void process_nonblocking(i32 fd) {
+    if (fd < 0) { return; }
+    i32 flags = fcntl(fd, F_GETFL);
+    if ((flags < 0) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0)) {
+        PANIC_ERRNO("fcntl failed");
+    }
+}
 
-        case CLD_DUMPED: {
-            message(MESSAGE_ERROR, NULL, 0, SV("child dumped core."), stderr);
-            trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-            return EXIT_FAILURE;
-        }
+/**
+ * @brief write <input> to <input_fd> and read <output_fd> into <output>
+ * until the child closes its end of both pipes.
+ *
+ * @note both directions are serviced together, so a child which
+ * writes before it has read all of its input cannot deadlock us.
+ * this relies on both of our ends being nonblocking, as a blocking
+ * write would wait for all of <input> to fit in the pipe.
+ *
+ * @return true if the child closed its stdin before reading all of <input>
+ */
+static bool process_transfer(i32 input_fd,
+                             StringView input,
+                             i32        output_fd,
+                             String *restrict output) {
+    u64  written = 0;
+    bool broken  = false;
+    if ((input_fd >= 0) && (input.length == 0)) { process_close(&input_fd); }
+
+    while ((input_fd >= 0) || (output_fd >= 0)) {
+        struct pollfd fds[2] = {
+            {.fd = input_fd,  .events = POLLOUT, .revents = 0},
+            {.fd = output_fd, .events = POLLIN,  .revents = 0},
+        };
 
-        case CLD_STOPPED: {
-            message(MESSAGE_ERROR, NULL, 0, SV("child stopped."), stderr);
-            trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-            return EXIT_FAILURE;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) { continue; }
+            PANIC_ERRNO("poll failed");
         }
 
-        case CLD_TRAPPED: {
-            message(MESSAGE_ERROR, NULL, 0, SV("child trapped."), stderr);
-            trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-            return EXIT_FAILURE;
+        if ((input_fd >= 0) && (fds[0].revents != 0)) {
+            u64 length = input.length - written;
+            if (length > PROCESS_TRANSFER_SIZE) {
+                length = PROCESS_TRANSFER_SIZE;
+            }
+
+            ssize_t count = write(input_fd, input.ptr + written, length);
+            if ((count < 0) && (errno == EPIPE)) {
+                // the child exited without reading all of its input,
+                // its exit status will tell the caller what happened.
+                broken = true;
+                process_close(&input_fd);
+            } else if (count < 0) {
+                // the pipe filled, or we were interrupted, before any
+                // of it was written. poll again.
+                if ((errno != EAGAIN) && (errno != EINTR)) {
+                    PANIC_ERRNO("write failed");
+                }
+            } else {
+                written += (u64)count;
+                if (written == input.length) { process_close(&input_fd); }
+            }
         }
 
-        case CLD_CONTINUED: {
-            message(MESSAGE_ERROR, NULL, 0, SV("child continued."), stderr);
-            trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-            return EXIT_FAILURE;
+        if ((output_fd >= 0) && (fds[1].revents != 0)) {
+            char    buffer[PROCESS_TRANSFER_SIZE];
+            ssize_t count = read(output_fd, buffer, sizeof(buffer));
+            if (count < 0) {
+                if ((errno == EAGAIN) || (errno == EINTR)) { continue; }
+                PANIC_ERRNO("read failed");
+            } else if (count == 0) {
+                process_close(&output_fd);
+            } else {
+                string_append(output, string_view(buffer, (u64)count));
+            }
         }
+    }
+
+    return broken;
+}
+
+i32 process_piped(char const *cmd,
+                  i32         argc,
+                  char const *argv[],
+                  StringView  input,
+                  String *restrict output) {
+    i32 input_pipe[2]  = {-1, -1};
+    i32 output_pipe[2] = {-1, -1};
+    bool has_input     = input.ptr != NULL;
+    bool has_output    = output != NULL;
+
+    if (has_input && (pipe2(input_pipe, O_CLOEXEC) != 0)) {
+        PANIC_ERRNO("pipe2 failed");
+    }
+
+    if (has_output && (pipe2(output_pipe, O_CLOEXEC) != 0)) {
+        PANIC_ERRNO("pipe2 failed");
+    }
 
-        default: {
-            message(
-                MESSAGE_ERROR, NULL, 0, SV("unknown child status."), stderr);
-            trace_command(string_view_from_cstring(cmd), argc, argv, stderr);
-            return EXIT_FAILURE;
+    pid_t pid = fork();
+    if (pid < 0) {
+        PANIC_ERRNO("fork failed");
+    } else if (pid == 0) {
+        // child process, dup2 clears O_CLOEXEC on the duplicate.
+        if (has_input && (dup2(input_pipe[0], STDIN_FILENO) < 0)) {
+            abort();
         }
+
+        if (has_output && (dup2(output_pipe[1], STDOUT_FILENO) < 0)) {
+            abort();
         }
+
+        process_exec(cmd, argc, argv);
+    }
+
+    // parent process
+    process_close(&input_pipe[0]);
+    process_close(&output_pipe[1]);
+    process_nonblocking(input_pipe[1]);
+    process_nonblocking(output_pipe[0]);
+
+    // a child which exits early must not kill us with SIGPIPE.
+    // the signal is blocked rather than ignored, as the signal
+    // disposition is shared by every thread, while the mask is not.
+    sigset_t pipe_set;
+    sigset_t previous;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &pipe_set, &previous) != 0) {
+        PANIC("pthread_sigmask failed");
     }
+
+    if (process_transfer(input_pipe[1], input, output_pipe[0], output)) {
+        // discard the SIGPIPE our write raised, it is pending
+        // on this thread.
+        struct timespec poll_only = {.tv_sec = 0, .tv_nsec = 0};
+        while (sigtimedwait(&pipe_set, NULL, &poll_only) == SIGPIPE) {}
+    }
+
+    if (pthread_sigmask(SIG_SETMASK, &previous, NULL) != 0) {
+        PANIC("pthread_sigmask failed");
+    }
+
+    return process_wait(pid, cmd, argc, argv);
 }
 
 #else
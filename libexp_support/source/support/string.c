@@ -84,7 +84,7 @@ void string_assign(String *restrict str, StringView sv) {
         memcpy(str->buffer, sv.ptr, str->length);
         str->buffer[str->length] = '\0';
     } else {
-        str->ptr = callocate(str->capacity, sizeof(char));
+        str->ptr = callocate_tagged("string", str->capacity, sizeof(char));
         memcpy(str->ptr, sv.ptr, str->length);
     }
 }
@@ -138,7 +138,7 @@ void string_resize(String *restrict str, u64 capacity) {
     assert(str != NULL);
     if (string_is_small(str)) {
         if (capacity >= sizeof(char *)) {
-            char *buf     = callocate(capacity, sizeof(char));
+            char *buf     = callocate_tagged("string", capacity, sizeof(char));
             str->capacity = capacity;
             memcpy(buf, str->buffer, str->length);
             str->ptr = buf;
@@ -146,7 +146,7 @@ void string_resize(String *restrict str, u64 capacity) {
         return;
     }
 
-    str->ptr              = reallocate(str->ptr, capacity);
+    str->ptr              = reallocate_tagged("string", str->ptr, capacity);
     str->capacity         = capacity;
     str->ptr[str->length] = '\0';
 }
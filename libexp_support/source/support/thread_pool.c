@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) 2024 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <assert.h>
+#include <unistd.h>
+
+#include "support/allocation.h"
+#include "support/array_growth.h"
+#include "support/panic.h"
+#include "support/thread_pool.h"
+
+static thread_local ThreadPool *thread_pool_self = NULL;
+
+static void thread_pool_lock(ThreadPool *restrict pool) {
+    if (pthread_mutex_lock(&pool->lock) != 0) {
+        PANIC("pthread_mutex_lock failed");
+    }
+}
+
+static void thread_pool_unlock(ThreadPool *restrict pool) {
+    if (pthread_mutex_unlock(&pool->lock) != 0) {
+        PANIC("pthread_mutex_unlock failed");
+    }
+}
+
+static bool thread_pool_queue_empty(ThreadPoolQueue const *restrict queue) {
+    return queue->head == queue->count;
+}
+
+static bool thread_pool_queue_full(ThreadPoolQueue const *restrict queue) {
+    return (queue->count + 1) >= queue->capacity;
+}
+
+static void thread_pool_queue_grow(ThreadPoolQueue *restrict queue) {
+    Growth_u64 g = array_growth_u64(queue->capacity, sizeof(ThreadPoolJob));
+    queue->buffer   = reallocate(queue->buffer, g.alloc_size);
+    queue->capacity = g.new_capacity;
+}
+
+static void thread_pool_queue_push(ThreadPoolQueue *restrict queue,
+                                   ThreadPoolJob job) {
+    // reuse the buffer from the start once every job has been taken.
+    if (thread_pool_queue_empty(queue)) {
+        queue->head  = 0;
+        queue->count = 0;
+    }
+
+    if (thread_pool_queue_full(queue)) { thread_pool_queue_grow(queue); }
+
+    queue->buffer[queue->count++] = job;
+}
+
+static ThreadPoolJob thread_pool_queue_pop(ThreadPoolQueue *restrict queue) {
+    assert(!thread_pool_queue_empty(queue));
+    return queue->buffer[queue->head++];
+}
+
+static void *thread_pool_worker(void *argument) {
+    ThreadPool *pool = argument;
+    thread_pool_self = pool;
+    thread_pool_lock(pool);
+
+    while (true) {
+        while (thread_pool_queue_empty(&pool->queue) && !pool->stopping) {
+            if (pthread_cond_wait(&pool->work_available, &pool->lock) != 0) {
+                PANIC("pthread_cond_wait failed");
+            }
+        }
+
+        if (thread_pool_queue_empty(&pool->queue)) { break; }
+
+        ThreadPoolJob job = thread_pool_queue_pop(&pool->queue);
+        pool->running += 1;
+        thread_pool_unlock(pool);
+
+        job.task(job.argument);
+
+        thread_pool_lock(pool);
+        pool->running -= 1;
+        if (thread_pool_queue_empty(&pool->queue) && (pool->running == 0)) {
+            if (pthread_cond_broadcast(&pool->work_finished) != 0) {
+                PANIC("pthread_cond_broadcast failed");
+            }
+        }
+    }
+
+    thread_pool_unlock(pool);
+    return NULL;
+}
+
+ThreadPool *thread_pool_current() { return thread_pool_self; }
+
+u64 thread_pool_hardware_concurrency() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) { return 1; }
+    return (u64)count;
+}
+
+void thread_pool_create(ThreadPool *restrict pool, u64 thread_count) {
+    assert(pool != NULL);
+    assert(thread_count > 0);
+    if ((pthread_mutex_init(&pool->lock, NULL) != 0) ||
+        (pthread_cond_init(&pool->work_available, NULL) != 0) ||
+        (pthread_cond_init(&pool->work_finished, NULL) != 0)) {
+        PANIC("thread pool initialization failed");
+    }
+    pool->queue.head     = 0;
+    pool->queue.count    = 0;
+    pool->queue.capacity = 0;
+    pool->queue.buffer   = NULL;
+    pool->running        = 0;
+    pool->stopping       = false;
+    pool->thread_count   = thread_count;
+    pool->threads        = callocate(thread_count, sizeof(pthread_t));
+
+    for (u64 index = 0; index < thread_count; ++index) {
+        if (pthread_create(
+                pool->threads + index, NULL, thread_pool_worker, pool) != 0) {
+            PANIC("pthread_create failed");
+        }
+    }
+}
+
+void thread_pool_destroy(ThreadPool *restrict pool) {
+    assert(pool != NULL);
+    thread_pool_lock(pool);
+    pool->stopping = true;
+    if (pthread_cond_broadcast(&pool->work_available) != 0) {
+        PANIC("pthread_cond_broadcast failed");
+    }
+    thread_pool_unlock(pool);
+
+    // workers drain the queue before they observe <stopping>
+    for (u64 index = 0; index < pool->thread_count; ++index) {
+        if (pthread_join(pool->threads[index], NULL) != 0) {
+            PANIC("pthread_join failed");
+        }
+    }
+
+    deallocate(pool->threads);
+    deallocate(pool->queue.buffer);
+    pthread_cond_destroy(&pool->work_finished);
+    pthread_cond_destroy(&pool->work_available);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+void thread_pool_submit(ThreadPool *restrict pool,
+                        ThreadPoolTask task,
+                        void          *argument) {
+    assert(pool != NULL);
+    assert(task != NULL);
+    thread_pool_lock(pool);
+    thread_pool_queue_push(&pool->queue,
+                           (ThreadPoolJob){.task = task, .argument = argument});
+    if (pthread_cond_signal(&pool->work_available) != 0) {
+        PANIC("pthread_cond_signal failed");
+    }
+    thread_pool_unlock(pool);
+}
+
+void thread_pool_wait(ThreadPool *restrict pool) {
+    assert(pool != NULL);
+    thread_pool_lock(pool);
+    while (!thread_pool_queue_empty(&pool->queue) || (pool->running != 0)) {
+        if (pthread_cond_wait(&pool->work_finished, &pool->lock) != 0) {
+            PANIC("pthread_cond_wait failed");
+        }
+    }
+    thread_pool_unlock(pool);
+}
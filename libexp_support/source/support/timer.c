@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "support/panic.h"
+#include "support/timer.h"
+
+static u64 timer_nanoseconds() {
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == -1) {
+        PANIC_ERRNO("clock_gettime failed");
+    }
+    return ((u64)now.tv_sec * 1000000000) + (u64)now.tv_nsec;
+}
+
+static u64 timer_resident_bytes() {
+    // the second field of statm is the resident set, in pages.
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) { return 0; }
+
+    unsigned long pages = 0;
+    if (fscanf(statm, "%*u %lu", &pages) != 1) { pages = 0; }
+    fclose(statm);
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size == -1) { return 0; }
+    return (u64)pages * (u64)page_size;
+}
+
+TimerSample timer_sample() {
+    TimerSample sample = {.nanoseconds    = timer_nanoseconds(),
+                          .resident_bytes = timer_resident_bytes()};
+    return sample;
+}
+
+u64 timer_elapsed(TimerSample start, TimerSample stop) {
+    if (stop.nanoseconds < start.nanoseconds) { return 0; }
+    return stop.nanoseconds - start.nanoseconds;
+}
+
+i64 timer_resident_delta(TimerSample start, TimerSample stop) {
+    return (i64)stop.resident_bytes - (i64)start.resident_bytes;
+}
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "support/allocation.h"
 #include "support/config.h"
 #include "support/io.h"
 #include "support/numeric_conversions.h"
@@ -94,6 +95,13 @@ u8 parse_exit_code(StringView path) {
 }
 
 i32 test_source(StringView path) {
+    return test_source_with_option(path, nullptr);
+}
+
+/**
+ * @brief run the executable compiled from <path>, and check its exit code
+ */
+static i32 test_executable(StringView path) {
     String exe_string = string_create();
     string_assign(&exe_string, path);
     string_replace_extension(&exe_string, SV(""));
@@ -101,12 +109,6 @@ i32 test_source(StringView path) {
 
     u8 exit_code = parse_exit_code(path);
 
-    char const *exp_args[] = {exp_path, path.ptr, nullptr};
-    if (process(exp_path, 2, exp_args) == EXIT_FAILURE) {
-        string_destroy(&exe_string);
-        return EXIT_FAILURE;
-    }
-
     char const *test_args[] = {exe_path, nullptr};
     i32         test_result = process(exe_path, 1, test_args);
     file_remove(exe_path);
@@ -126,3 +128,62 @@ i32 test_source(StringView path) {
 
     return EXIT_SUCCESS;
 }
+
+i32 test_source_with_option(StringView path, char const *option) {
+    char const *exp_args[] = {exp_path, path.ptr, nullptr, nullptr};
+    i32         exp_argc   = 2;
+    if (option != nullptr) {
+        exp_args[1] = option;
+        exp_args[2] = path.ptr;
+        exp_argc    = 3;
+    }
+
+    if (process(exp_path, exp_argc, exp_args) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    return test_executable(path);
+}
+
+i32 test_sources(u64 count, String const *paths) {
+    u64          exp_argc = count + 1;
+    char const **exp_args = callocate(exp_argc + 1, sizeof(char const *));
+    exp_args[0]           = exp_path;
+    for (u64 index = 0; index < count; ++index) {
+        exp_args[index + 1] = string_to_cstring(paths + index);
+    }
+
+    i32 result = process(exp_path, (i32)exp_argc, exp_args);
+    deallocate(exp_args);
+    if (result == EXIT_FAILURE) { return EXIT_FAILURE; }
+
+    for (u64 index = 0; index < count; ++index) {
+        result |= test_executable(string_to_view(paths + index));
+    }
+
+    return result;
+}
+
+static i32 test_without_artifacts(char const *flag, StringView path) {
+    char const *exp_args[] = {exp_path, flag, path.ptr, nullptr};
+    u8          exit_code  = parse_exit_code(path);
+    i32         result     = process(exp_path, 3, exp_args);
+    if (result != exit_code) {
+        file_write(SV("\ntest resource: "), stderr);
+        file_write(path, stderr);
+        file_write(SV("\nexpected exit code: "), stderr);
+        file_write_i64(exit_code, stderr);
+        file_write(SV(" actual exit code: "), stderr);
+        file_write_i64(result, stderr);
+        file_write(SV("\n"), stderr);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+i32 test_run(StringView path) { return test_without_artifacts("--run", path); }
+
+i32 test_evaluate(StringView path) {
+    return test_without_artifacts("--evaluate", path);
+}
@@ -18,10 +18,31 @@
 #define EXP_TEST_LIBEXP_TEST_TEST_EXP_H
 
 #include "support/scalar.h"
-#include "support/string_view.h"
+#include "support/string.h"
 
 i32 test_exp(StringView source_path, char const *contents, i32 expected_code);
 
 i32 test_source(StringView path);
 
+/**
+ * @brief as test_source, passing <option> to exp before the source path
+ */
+i32 test_source_with_option(StringView path, char const *option);
+
+/**
+ * @brief as test_source, compiling every source with a single
+ * invocation of exp
+ */
+i32 test_sources(u64 count, String const *paths);
+
+/**
+ * @brief run <path> with exp --run, and check the exit code
+ */
+i32 test_run(StringView path);
+
+/**
+ * @brief evaluate <path> with exp --evaluate, and check the exit code
+ */
+i32 test_evaluate(StringView path);
+
 #endif // !EXP_TEST_LIBEXP_TEST_TEST_EXP_H
@@ -130,6 +130,47 @@ void test_resources_gather(TestResources *test_resources,
     if (closedir(resource_directory) < 0) { PANIC_ERRNO("closedir"); }
 }
 
+static void test_resources_directory(char const *directory) {
+    if ((mkdir(directory, 0755) < 0) && (errno != EEXIST)) {
+        PANIC_ERRNO("mkdir");
+    }
+}
+
+void test_resources_initialize_isolated(TestResources *test_resources,
+                                        char const    *test_name) {
+    assert(test_resources != nullptr);
+    assert(test_name != nullptr);
+    test_resources_initialize(test_resources);
+
+    String directory = string_create();
+    string_append(&directory, SV(EXP_BINARY_DIR "/test_resources"));
+    test_resources_directory(string_to_cstring(&directory));
+    string_append(&directory, SV("/"));
+    string_append(&directory, string_view_from_cstring(test_name));
+    test_resources_directory(string_to_cstring(&directory));
+
+    // the file names of the resources are unique, and encode the
+    // expected exit code, so each copy keeps the name of its resource.
+    for (u64 index = 0; index < test_resources->count; ++index) {
+        String     *resource = test_resources->buffer + index;
+        char const *name     = strrchr(string_to_cstring(resource), '/');
+        assert(name != nullptr);
+
+        FILE  *source   = file_open(string_to_cstring(resource), "r");
+        String contents = string_from_file(source);
+        file_close(source);
+
+        string_assign(resource, string_to_view(&directory));
+        string_append(resource, string_view_from_cstring(name));
+        FILE *copy = file_open(string_to_cstring(resource), "w");
+        file_write(string_to_view(&contents), copy);
+        file_close(copy);
+        string_destroy(&contents);
+    }
+
+    string_destroy(&directory);
+}
+
 #elif defined(EXP_HOST_SYSTEM_WINDOWS)
 #error "TODO"
 #else
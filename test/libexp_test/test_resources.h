@@ -14,4 +14,12 @@ typedef struct TestResources {
 void test_resources_initialize(TestResources *test_resources);
 void test_resources_terminate(TestResources *test_resources);
 
+/**
+ * @brief as test_resources_initialize, copying each resource into a
+ * directory of its own for <test_name>, so the artifacts written next
+ * to each resource are not shared with tests running alongside.
+ */
+void test_resources_initialize_isolated(TestResources *test_resources,
+                                        char const    *test_name);
+
 #endif // EXP_TEST_END_TO_END_TEST_RESOURCES_H
@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "support/arena.h"
+
+static bool test_alignment(Arena *restrict arena) {
+    bool failure = 0;
+    for (u64 alignment = 1; alignment <= alignof(max_align_t);
+         alignment *= 2) {
+        // an odd sized allocation first, so the next must be padded.
+        arena_allocate(arena, 3, 1);
+        void *memory = arena_allocate(arena, alignment, alignment);
+        failure |= ((uintptr_t)memory % alignment) != 0;
+    }
+    return failure;
+}
+
+/*
+ * allocations outlive the chunk they were made in, and
+ * never overlap, even when larger than any chunk.
+ */
+static bool test_chunks(Arena *restrict arena) {
+    bool failure = 0;
+    enum { COUNT = 4096 };
+    u64 *values[COUNT];
+    for (u64 i = 0; i < COUNT; ++i) {
+        values[i]  = arena_allocate(arena, sizeof(u64), alignof(u64));
+        *values[i] = i;
+    }
+
+    u8 *large = arena_callocate(arena, 1ul << 21, 1);
+    failure |= (large[0] != 0) || (large[(1ul << 21) - 1] != 0);
+    memset(large, 0xFF, 1ul << 21);
+
+    for (u64 i = 0; i < COUNT; ++i) {
+        failure |= *values[i] != i;
+    }
+    return failure;
+}
+
+i32 arena_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
+    bool  failure = 0;
+    Arena arena   = arena_create();
+
+    failure |= test_alignment(&arena);
+    failure |= test_chunks(&arena);
+
+    // clearing keeps a single chunk, which is reused.
+    arena_clear(&arena);
+    failure |= arena.chunks == NULL;
+    failure |= arena.chunks->next != NULL;
+    failure |= arena.chunks->used != 0;
+    failure |= test_alignment(&arena);
+    failure |= test_chunks(&arena);
+
+    arena_destroy(&arena);
+    failure |= arena.chunks != NULL;
+    if (failure) {
+        return EXIT_FAILURE;
+    } else {
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "test_exp.h"
+#include "test_resources.h"
+
+i32 batch_tests([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    TestResources test_resources;
+    test_resources_initialize_isolated(&test_resources, "batch_tests");
+
+    i32 result = test_sources(test_resources.count, test_resources.buffer);
+
+    test_resources_terminate(&test_resources);
+    return result;
+}
@@ -0,0 +1,135 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include "support/config.h"
+#include "support/io.h"
+#include "support/string.h"
+#include "test_exp.h"
+#include "test_resources.h"
+
+/*
+ * set the modification time of every entry within <directory> back to
+ * the epoch, so an entry which is written again can be told apart.
+ * returns the number of entries.
+ */
+static u64 cache_entries_age(String *restrict directory) {
+    DIR *dir = opendir(string_to_cstring(directory));
+    if (dir == nullptr) { return 0; }
+
+    u64            count = 0;
+    String         path  = string_create();
+    struct utimbuf epoch = {.actime = 0, .modtime = 0};
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.') { continue; }
+        string_assign(&path, string_to_view(directory));
+        string_append(&path, SV("/"));
+        string_append(&path, string_view_from_cstring(entry->d_name));
+        if (utime(string_to_cstring(&path), &epoch) == 0) { ++count; }
+    }
+
+    string_destroy(&path);
+    closedir(dir);
+    return count;
+}
+
+/*
+ * true when no entry within <directory> was written since it was aged,
+ * which is only the case when the compilation hit the cache.
+ */
+static bool cache_entries_unchanged(String *restrict directory) {
+    DIR *dir = opendir(string_to_cstring(directory));
+    if (dir == nullptr) { return false; }
+
+    bool           unchanged = true;
+    String         path      = string_create();
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.') { continue; }
+        string_assign(&path, string_to_view(directory));
+        string_append(&path, SV("/"));
+        string_append(&path, string_view_from_cstring(entry->d_name));
+        struct stat status;
+        if ((stat(string_to_cstring(&path), &status) != 0) ||
+            (status.st_mtime != 0)) {
+            unchanged = false;
+        }
+    }
+
+    string_destroy(&path);
+    closedir(dir);
+    return unchanged;
+}
+
+i32 cache_tests([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    i32           result    = EXIT_SUCCESS;
+    String        directory = string_create();
+    TestResources test_resources;
+    test_resources_initialize_isolated(&test_resources, "cache_tests");
+
+    for (u64 index = 0; index < test_resources.count; ++index) {
+        String *resource = test_resources.buffer + index;
+        file_write(SV("testing cached resource: "), stderr);
+        file_write(string_to_view(resource), stderr);
+        file_write(SV("\n"), stderr);
+        StringView path = string_to_view(resource);
+
+        // a directory of its own, inherited by each invocation of exp,
+        // so the entries of this resource are the only entries.
+        string_assign(&directory, SV(EXP_BINARY_DIR "/cache_tests/"));
+        string_append_u64(&directory, index);
+        setenv("EXP_CACHE_DIR", string_to_cstring(&directory), 1);
+
+        // the first compilation may miss, the second must hit, leaving
+        // every entry untouched, and the executable copied from the
+        // cache must behave the same.
+        if (test_source_with_option(path, "-k") != EXIT_SUCCESS) {
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (cache_entries_age(&directory) == 0) {
+            file_write(SV("no cache entries were written\n"), stderr);
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (test_source_with_option(path, "-k") != EXIT_SUCCESS) {
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        if (!cache_entries_unchanged(&directory)) {
+            file_write(SV("the second compilation missed the cache\n"),
+                       stderr);
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    test_resources_terminate(&test_resources);
+    string_destroy(&directory);
+    return result;
+}
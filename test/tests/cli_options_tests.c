@@ -27,7 +27,8 @@ bool test_options(i32 argc, char const *argv[], StringView sv) {
     parse_cli_options(argc, argv, &cli_options);
 
     bool failure = 0;
-    if (!string_eq(&cli_options.source, sv)) {
+    if ((cli_options.sources.count != 1) ||
+        !string_eq(cli_options.sources.buffer, sv)) {
         failure |= 1;
     } else {
         failure |= 0;
@@ -37,6 +38,42 @@ bool test_options(i32 argc, char const *argv[], StringView sv) {
     return failure;
 }
 
+bool test_multiple_sources(i32 argc, char const *argv[]) {
+    CLIOptions cli_options;
+    cli_options_init(&cli_options);
+    parse_cli_options(argc, argv, &cli_options);
+
+    bool failure = 0;
+    if (cli_options.sources.count != (u64)(argc - 1)) {
+        failure |= 1;
+    } else {
+        for (u64 index = 0; index < cli_options.sources.count; ++index) {
+            StringView sv = string_view_from_cstring(argv[index + 1]);
+            if (!string_eq(cli_options.sources.buffer + index, sv)) {
+                failure |= 1;
+            }
+        }
+    }
+
+    cli_options_destroy(&cli_options);
+    return failure;
+}
+
+bool test_phase_time_options(i32 argc, char const *argv[]) {
+    CLIOptions cli_options;
+    cli_options_init(&cli_options);
+    parse_cli_options(argc, argv, &cli_options);
+
+    bool failure = 0;
+    if (!cli_options.context_options.report_phase_times ||
+        !cli_options.context_options.report_phase_times_json) {
+        failure |= 1;
+    }
+
+    cli_options_destroy(&cli_options);
+    return failure;
+}
+
 i32 cli_options_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char **argv) {
     bool failure = 0;
 
@@ -45,6 +82,15 @@ i32 cli_options_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char **argv) {
 
     failure |= test_options(test_argc, test_argv, SV("hello.txt"));
 
+    i32         batch_argc   = 4;
+    char const *batch_argv[] = {
+        "options_tests", "a.exp", "b.exp", "c.exp", NULL};
+    failure |= test_multiple_sources(batch_argc, batch_argv);
+
+    i32         time_argc   = 4;
+    char const *time_argv[] = {"options_tests", "-t", "-j", "a.exp", NULL};
+    failure |= test_phase_time_options(time_argc, time_argv);
+
     if (failure) {
         return EXIT_FAILURE;
     } else {
@@ -32,6 +32,45 @@ bool test_constant(Constants *restrict values, Value value) {
     }
 }
 
+static Value tuple_of(i64 a, i64 b) {
+    Tuple tuple;
+    tuple_create(&tuple);
+    tuple_append(&tuple, operand_i64(a));
+    tuple_append(&tuple, operand_i64(b));
+    return value_create_tuple(tuple);
+}
+
+bool test_deduplication() {
+    Constants values  = constants_create();
+    bool      failure = 0;
+
+    for (i64 i = 0; i < 256; ++i) {
+        Operand A = constants_append(&values, value_create_i64(i));
+        Operand B = constants_append(&values, value_create_i64(i));
+        failure |= A.data.constant != B.data.constant;
+    }
+    failure |= values.count != 256;
+
+    Operand T0 = constants_append(&values, tuple_of(1, 2));
+    Operand T1 = constants_append(&values, tuple_of(1, 2));
+    Operand T2 = constants_append(&values, tuple_of(2, 1));
+    failure |= T0.data.constant != T1.data.constant;
+    failure |= T0.data.constant == T2.data.constant;
+
+    Operand N0 = constants_append(&values, value_create_nil());
+    Operand N1 = constants_append(&values, value_create_boolean(false));
+    Operand N2 = constants_append(&values, value_create_u64(0));
+    failure |= N0.data.constant == N1.data.constant;
+    failure |= N1.data.constant == N2.data.constant;
+
+    failure |= values.count != 261;
+    failure |= values.misses != 261;
+    failure |= values.hits != 257;
+
+    constants_destroy(&values);
+    return failure;
+}
+
 i32 constants_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
     srand((unsigned)time(NULL));
     Constants values = constants_create();
@@ -42,6 +81,7 @@ i32 constants_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
     failure |= test_constant(&values, value_create_i64(rand()));
     failure |= test_constant(&values, value_create_i64(rand()));
     failure |= test_constant(&values, value_create_i64(rand()));
+    failure |= test_deduplication();
 
     constants_destroy(&values);
     if (failure) {
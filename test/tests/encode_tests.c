@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "support/io.h"
+#include "test_exp.h"
+#include "test_resources.h"
+
+i32 encode_tests([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    i32           result = EXIT_SUCCESS;
+    TestResources test_resources;
+    test_resources_initialize_isolated(&test_resources, "encode_tests");
+
+    for (u64 index = 0; index < test_resources.count; ++index) {
+        String *resource = test_resources.buffer + index;
+        file_write(SV("testing encoded resource: "), stderr);
+        file_write(string_to_view(resource), stderr);
+        file_write(SV("\n"), stderr);
+        StringView path = string_to_view(resource);
+        if (test_source_with_option(path, "-d") != EXIT_SUCCESS) {
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    test_resources_terminate(&test_resources);
+    return result;
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core/evaluate.h"
+#include "scanning/parser.h"
+#include "support/io.h"
+#include "test_exp.h"
+#include "test_resources.h"
+
+/*
+ * the source language only has i64 arithmetic, so each of these
+ * programs has the locals of main retyped after parsing, and the
+ * value main evaluates to is checked against the same arithmetic
+ * compiled by the host.
+ */
+typedef struct TypedProgram {
+    char const *source;
+    Type const *(*type)(Context *restrict context);
+    i64 expected;
+} TypedProgram;
+
+static TypedProgram const typed_programs[] = {
+    {"fn main() { let x = 18446744073709551614; let y = 3; return x / y; }",
+     context_u64_type,
+     (i64)((UINT64_MAX - 1) / 3)},
+    {"fn main() { let x = 18446744073709551614; let y = 5; return x % y; }",
+     context_u64_type,
+     (i64)((UINT64_MAX - 1) % 5)},
+    {"fn main() { let x = 200; let y = 100; return x + y; }",
+     context_u8_type,
+     (i64)(u8)(200 + 100)},
+    {"fn main() { let x = 300; let y = 300; return x * y; }",
+     context_u16_type,
+     (i64)(u16)(300 * 300)},
+    {"fn main() { let x = 1; let y = 2; return x - y; }",
+     context_u32_type,
+     (i64)(u32)(1 - 2)},
+    {"fn main() { let x = 100; let y = 100; return x + y; }",
+     context_i8_type,
+     (i64)(i8)(100 + 100)},
+    {"fn main() { let x = 2147483647; let y = 2; return x * y; }",
+     context_i32_type,
+     (i64)(i32)(2147483647LL * 2)},
+};
+
+static i32 test_typed_program(TypedProgram const *restrict program) {
+    ContextOptions options = {};
+    Context        context;
+    context_create(&context, &options, SV("evaluate_tests.exp"));
+
+    StringView source = string_view_from_cstring(program->source);
+    i64        value  = 0;
+    i32        result = parse_buffer(source.ptr, source.length, &context);
+    if (result == EXIT_SUCCESS) {
+        Locals *locals =
+            &context_global_symbol_table_at(&context, SV("main"))
+                 ->function_body.locals;
+        for (u32 ssa = 0; ssa < locals->count; ++ssa) {
+            locals->buffer[ssa]->type = program->type(&context);
+        }
+        result = evaluate(&context, &value);
+    }
+
+    if ((result == EXIT_SUCCESS) && (value != program->expected)) {
+        file_write(source, stderr);
+        file_write(SV("\nevaluated to "), stderr);
+        file_write_i64(value, stderr);
+        file_write(SV(", expected "), stderr);
+        file_write_i64(program->expected, stderr);
+        file_write(SV("\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    context_destroy(&context);
+    return result;
+}
+
+i32 evaluate_tests([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    i32 result = EXIT_SUCCESS;
+    for (u64 index = 0; index < sizeof(typed_programs) / sizeof(TypedProgram);
+         ++index) {
+        if (test_typed_program(typed_programs + index) != EXIT_SUCCESS) {
+            result = EXIT_FAILURE;
+        }
+    }
+    if (result != EXIT_SUCCESS) { return result; }
+
+    TestResources test_resources;
+    test_resources_initialize(&test_resources);
+
+    for (u64 index = 0; index < test_resources.count; ++index) {
+        String *resource = test_resources.buffer + index;
+        file_write(SV("running resource: "), stderr);
+        file_write(string_to_view(resource), stderr);
+        file_write(SV("\n"), stderr);
+        if (test_evaluate(string_to_view(resource)) != EXIT_SUCCESS) {
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    test_resources_terminate(&test_resources);
+    return result;
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core/analyze.h"
+#include "core/evaluate.h"
+#include "env/function_cache.h"
+#include "scanning/parser.h"
+#include "support/config.h"
+#include "support/io.h"
+
+static char const *names[] = {"one", "two", "three", "main"};
+
+enum {
+    CACHED_NONE  = 0x0,
+    CACHED_THREE = 0x4,
+    CACHED_ALL   = 0xF,
+};
+
+/**
+ * @brief compile <source>, taking functions from <cache>, and check
+ * which functions were cached, by bit within <cached>, and the value
+ * main evaluates to.
+ */
+static i32 test_function_cache(FunctionCache const *restrict cache,
+                               StringView source,
+                               u8         cached,
+                               i64        expected) {
+    ContextOptions options = {};
+    Context        context;
+    context_create(&context, &options, SV("function_cache_tests.exp"));
+    context.function_cache = cache;
+
+    i64 value  = 0;
+    i32 result = parse_buffer(source.ptr, source.length, &context);
+    if (result == EXIT_SUCCESS) { result = analyze(&context); }
+    if (result == EXIT_SUCCESS) { result = evaluate(&context, &value); }
+
+    if ((result == EXIT_SUCCESS) && (value != expected)) {
+        file_write(SV("main evaluated to "), stderr);
+        file_write_i64(value, stderr);
+        file_write(SV("\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    for (u8 index = 0; index < 4; ++index) {
+        StringView name   = string_view_from_cstring(names[index]);
+        Symbol    *symbol = context_global_symbol_table_at(&context, name);
+        bool       expect = (cached & (1u << index)) != 0;
+        if (symbol->cached != expect) {
+            file_write(name, stderr);
+            file_write(expect ? SV(" was not cached\n") : SV(" was cached\n"),
+                       stderr);
+            result = EXIT_FAILURE;
+        }
+    }
+
+    if (result == EXIT_SUCCESS) { function_cache_store(cache, &context); }
+    context_destroy(&context);
+    return result;
+}
+
+i32 function_cache_tests([[maybe_unused]] i32 argc,
+                         [[maybe_unused]] char **argv) {
+    StringView directory = SV(EXP_BINARY_DIR "/function_cache_tests");
+    mkdir(directory.ptr, 0755);
+    // a fresh seed names a fresh set of entries, so that entries left
+    // by an earlier run are never found.
+    u64           seed = ((u64)time(nullptr) << 20) ^ (u64)getpid();
+    FunctionCache cache;
+    function_cache_create(&cache, directory, seed);
+
+    StringView source = SV("fn one() { return 1; }\n"
+                           "fn two() { return one() + 1; }\n"
+                           "fn three() { return 3; }\n"
+                           "fn main() { return two() + three(); }\n");
+    // only one has changed, two and main depend upon it.
+    StringView edited = SV("fn one() { return 4; }\n"
+                           "fn two() { return one() + 1; }\n"
+                           "fn three() { return 3; }\n"
+                           "fn main() { return two() + three(); }\n");
+
+    i32 result = EXIT_SUCCESS;
+    result |= test_function_cache(&cache, source, CACHED_NONE, 5);
+    result |= test_function_cache(&cache, source, CACHED_ALL, 5);
+    result |= test_function_cache(&cache, edited, CACHED_THREE, 8);
+    result |= test_function_cache(&cache, edited, CACHED_ALL, 8);
+    result |= test_function_cache(&cache, source, CACHED_ALL, 5);
+
+    function_cache_destroy(&cache);
+    return result;
+}
@@ -0,0 +1,401 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "support/allocation.h"
+#include "support/hash.h"
+#include "support/io.h"
+#include "support/string.h"
+#include "support/timer.h"
+
+/*
+ * checks the distribution of hash_cstring over identifiers taken from
+ * an excerpt of the compiler, and over generated names such as a
+ * compiler emits. given --benchmark, it also reports the probe lengths
+ * and throughput of hash_cstring, of the djb2 variant it replaced, and
+ * of FNV-1a:
+ *   exp_tests hash_tests --benchmark
+ */
+
+typedef u64 (*HashFunction)(char const *string, u64 length);
+
+static u64 hash_djb2(char const *string, u64 length) {
+    u64 hash = 5381;
+    for (u64 i = 0; i < length; ++i) {
+        hash = (11931085111904720063ul * hash) + (u8)(string[i]);
+    }
+    return hash;
+}
+
+static u64 hash_fnv(char const *string, u64 length) {
+    return hash_fnv1a(HASH_FNV1A_OFFSET_BASIS, string, length);
+}
+
+static u64 hash_word(char const *string, u64 length) {
+    return hash_cstring(string, length);
+}
+
+typedef struct Corpus {
+    u64         count;
+    u64         capacity;
+    StringView *buffer;
+    String      text;
+} Corpus;
+
+static void corpus_append(Corpus *restrict corpus, StringView identifier) {
+    if (corpus->capacity <= (corpus->count + 1)) {
+        corpus->capacity = (corpus->capacity == 0) ? 64 : corpus->capacity * 2;
+        corpus->buffer   = reallocate(corpus->buffer,
+                                    corpus->capacity * sizeof(StringView));
+    }
+    corpus->buffer[corpus->count++] = identifier;
+}
+
+static i32 identifier_compare(void const *left, void const *right) {
+    StringView a = *(StringView const *)left;
+    StringView b = *(StringView const *)right;
+    u64 length   = (a.length < b.length) ? a.length : b.length;
+    i32 result   = memcmp(a.ptr, b.ptr, length);
+    if (result != 0) { return result; }
+    if (a.length == b.length) { return 0; }
+    return (a.length < b.length) ? -1 : 1;
+}
+
+static void corpus_unique(Corpus *restrict corpus) {
+    if (corpus->count == 0) { return; }
+    qsort(corpus->buffer,
+          corpus->count,
+          sizeof(StringView),
+          identifier_compare);
+    u64 count = 1;
+    for (u64 index = 1; index < corpus->count; ++index) {
+        StringView identifier = corpus->buffer[index];
+        if (string_view_equal(corpus->buffer[count - 1], identifier)) {
+            continue;
+        }
+        corpus->buffer[count++] = identifier;
+    }
+    corpus->count = count;
+}
+
+static bool identifier_begin(char c) {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+           (c == '_');
+}
+
+static bool identifier_continue(char c) {
+    return identifier_begin(c) || ((c >= '0') && (c <= '9'));
+}
+
+/*
+ * an excerpt of the compiler, standing in for the identifiers of
+ * real source code.
+ */
+static char const excerpt[] =
+    "typedef struct Context {\n"
+    "    ContextOptions options; String source_path; MappedFile source;\n"
+    "    StringInterner string_interner; TypeInterner type_interner;\n"
+    "    SymbolTable global_symbol_table; Labels global_labels;\n"
+    "    Constants constants; Error current_error; Arena arena;\n"
+    "    Function *current_function;\n"
+    "} Context;\n"
+    "void context_create(Context *restrict context,\n"
+    "                    ContextOptions *restrict options,\n"
+    "                    StringView source_path);\n"
+    "bool context_shall_prolix(Context const *context);\n"
+    "bool context_shall_create_ir_artifact(Context const *context);\n"
+    "bool context_shall_create_assembly_artifact(Context const *c);\n"
+    "bool context_shall_cleanup_object_artifact(Context const *c);\n"
+    "ConstantString *context_intern(Context *context, StringView sv);\n"
+    "Type const *context_tuple_type(Context *context, TupleType tuple);\n"
+    "Symbol *context_global_symbol_table_at(Context *c, StringView name);\n"
+    "Function *context_enter_function(Context *c, StringView name);\n"
+    "Local *context_lookup_local_name(Context *c, ConstantString *name);\n"
+    "Operand context_constants_append(Context *context, Value value);\n"
+    "static bool parse_precedence(Operand *result, Precedence precedence,\n"
+    "                             Parser *parser, Context *context) {\n"
+    "    ParseRule *rule = get_rule(curtok(parser));\n"
+    "    if (rule->prefix == NULL) {\n"
+    "        return error(parser, context, ERROR_PARSER_EXPECTED_EXPRESSION);\n"
+    "    }\n"
+    "    Operand left; if (!rule->prefix(&left, parser, context)) {\n"
+    "        return false; }\n"
+    "    while (precedence <= get_rule(curtok(parser))->precedence) {\n"
+    "        ParseRule *infix_rule = get_rule(curtok(parser));\n"
+    "        if (!infix_rule->infix(&left, left, parser, context)) {}\n"
+    "    }\n"
+    "}\n"
+    "x86_Allocation *x86_context_allocate_from_active(x86_Context *c,\n"
+    "    Local *local, Operand operand, u64 block_index);\n"
+    "void x86_codegen_copy_scalar_memory(x86_Address *dst,\n"
+    "    x86_Address *src, u64 size, u64 Idx, x86_Context *context);\n"
+    "x86_Operand x86_operand_immediate(i64 value);\n"
+    "x86_Operand x86_operand_gpr(x86_GPR gpr);\n"
+    "x86_Instruction x86_mov(x86_Operand A, x86_Operand B);\n"
+    "void elf_object_relocation(ELF_Object *object, u64 offset,\n"
+    "    u32 symbol, u32 type, i64 addend);\n"
+    "u64 hash_fnv1a(u64 hash, void const *bytes, u64 length);\n"
+    "Growth_u64 array_growth_u64(u64 current_capacity, u64 size);\n"
+    "TOK_END TOK_ERROR_UNEXPECTED_CHAR TOK_BEGIN_PAREN TOK_END_PAREN\n"
+    "TOK_BEGIN_BRACE TOK_END_BRACE TOK_COMMA TOK_SEMICOLON TOK_COLON\n"
+    "OPCODE_RET OPCODE_CALL OPCODE_LET OPCODE_NEG OPCODE_DOT OPCODE_ADD\n"
+    "OPERAND_KIND_SSA OPERAND_KIND_CONSTANT OPERAND_KIND_LABEL\n"
+    "TYPE_KIND_NIL TYPE_KIND_BOOLEAN TYPE_KIND_TUPLE TYPE_KIND_FUNCTION\n"
+    "X86_GPR_RAX X86_GPR_RBX X86_GPR_RCX X86_GPR_RDX X86_GPR_RSP\n";
+
+/**
+ * @brief the distinct identifiers of the C source <text>
+ */
+static void corpus_from_text(Corpus *restrict corpus, StringView source) {
+    string_append(&corpus->text, source);
+
+    // the text is complete, so views into it remain valid.
+    char const *text   = string_to_cstring(&corpus->text);
+    u64         length = corpus->text.length;
+    for (u64 index = 0; index < length;) {
+        if (!identifier_begin(text[index]) ||
+            ((index > 0) && identifier_continue(text[index - 1]))) {
+            ++index;
+            continue;
+        }
+
+        u64 end = index + 1;
+        while ((end < length) && identifier_continue(text[end])) {
+            ++end;
+        }
+        corpus_append(corpus, string_view(text + index, end - index));
+        index = end;
+    }
+    corpus_unique(corpus);
+}
+
+/**
+ * @brief the names <prefix>0 through <prefix><count - 1>, a compiler
+ * generates names like these, and they differ only in their tails.
+ */
+static void
+corpus_generated(Corpus *restrict corpus, StringView prefix, u64 count) {
+    for (u64 index = 0; index < count; ++index) {
+        string_append(&corpus->text, prefix);
+        string_append_u64(&corpus->text, index);
+        string_append(&corpus->text, SV("\n"));
+    }
+
+    char const *text  = string_to_cstring(&corpus->text);
+    u64         begin = 0;
+    corpus->buffer    = reallocate(corpus->buffer, count * sizeof(StringView));
+    corpus->capacity  = count;
+    for (u64 index = 0; index < corpus->text.length; ++index) {
+        if (text[index] != '\n') { continue; }
+        corpus->buffer[corpus->count++] =
+            string_view(text + begin, index - begin);
+        begin = index + 1;
+    }
+}
+
+static void corpus_destroy(Corpus *restrict corpus) {
+    deallocate(corpus->buffer);
+    string_destroy(&corpus->text);
+}
+
+/**
+ * @brief the mean number of slots probed to find each identifier within
+ * a linear probing table, indexed by the low bits of the hash, at a
+ * load factor of at most 1/2. in thousandths of a probe.
+ */
+static u64 mean_probe_length(Corpus const *restrict corpus,
+                             HashFunction hash) {
+    u64 capacity = 16;
+    while (capacity < (corpus->count * 2)) {
+        capacity *= 2;
+    }
+
+    bool *occupied = callocate(capacity, sizeof(bool));
+    u64   probes   = 0;
+    for (u64 index = 0; index < corpus->count; ++index) {
+        StringView identifier = corpus->buffer[index];
+        u64        slot = hash(identifier.ptr, identifier.length);
+        slot &= capacity - 1;
+        probes += 1;
+        while (occupied[slot]) {
+            slot = (slot + 1) & (capacity - 1);
+            probes += 1;
+        }
+        occupied[slot] = true;
+    }
+
+    deallocate(occupied);
+    return (probes * 1000) / corpus->count;
+}
+
+/**
+ * @brief nanoseconds taken to hash every identifier of the corpus
+ * <rounds> times.
+ */
+static u64 hash_throughput(Corpus const *restrict corpus,
+                           HashFunction hash,
+                           u64          rounds) {
+    u64         sum   = 0;
+    TimerSample start = timer_sample();
+    for (u64 round = 0; round < rounds; ++round) {
+        for (u64 index = 0; index < corpus->count; ++index) {
+            StringView identifier = corpus->buffer[index];
+            sum += hash(identifier.ptr, identifier.length);
+        }
+    }
+    TimerSample stop = timer_sample();
+    // consume the hashes, so that the loop is not removed.
+    if (sum == 1) { file_write(SV(""), stderr); }
+    return timer_elapsed(start, stop);
+}
+
+static void write_thousandths(u64 value) {
+    file_write_u64(value / 1000, stderr);
+    file_write(SV("."), stderr);
+    u64 fraction = value % 1000;
+    if (fraction < 100) { file_write(SV("0"), stderr); }
+    if (fraction < 10) { file_write(SV("0"), stderr); }
+    file_write_u64(fraction, stderr);
+}
+
+static i32 hash_compare(void const *left, void const *right) {
+    u64 a = *(u64 const *)left;
+    u64 b = *(u64 const *)right;
+    return (a < b) ? -1 : (a > b);
+}
+
+static void benchmark_corpus(StringView name,
+                             Corpus const *restrict corpus) {
+    static struct {
+        char const  *name;
+        HashFunction hash;
+    } const functions[] = {
+        {"hash_cstring", hash_word},
+        {"djb2",         hash_djb2},
+        {"fnv1a",        hash_fnv },
+    };
+
+    file_write(name, stderr);
+    file_write(SV(": "), stderr);
+    file_write_u64(corpus->count, stderr);
+    file_write(SV(" identifiers\n"), stderr);
+
+    u64 rounds = 1 + (1000000 / corpus->count);
+    u64 hashed = rounds * corpus->count;
+    for (u64 index = 0; index < sizeof(functions) / sizeof(*functions);
+         ++index) {
+        u64 probes = mean_probe_length(corpus, functions[index].hash);
+        u64 nanoseconds =
+            hash_throughput(corpus, functions[index].hash, rounds);
+        file_write(SV("  "), stderr);
+        file_write(string_view_from_cstring(functions[index].name), stderr);
+        file_write(SV(": mean probe length "), stderr);
+        write_thousandths(probes);
+        file_write(SV(", ns per identifier "), stderr);
+        write_thousandths((nanoseconds * 1000) / hashed);
+        file_write(SV("\n"), stderr);
+    }
+}
+
+static bool test_corpus(Corpus const *restrict corpus) {
+    // at a load factor of 1/2, linear probing expects a mean of 1.5
+    // probes when the hash is uniform.
+    u64 probes = mean_probe_length(corpus, hash_word);
+    if (probes > 2000) {
+        file_write(SV("hash_cstring is poorly distributed\n"), stderr);
+        return false;
+    }
+
+    // every identifier is distinct, no two should share a hash.
+    u64 *hashes = callocate(corpus->count, sizeof(u64));
+    for (u64 index = 0; index < corpus->count; ++index) {
+        StringView identifier = corpus->buffer[index];
+        hashes[index] = hash_cstring(identifier.ptr, identifier.length);
+    }
+    qsort(hashes, corpus->count, sizeof(u64), hash_compare);
+    bool distinct = true;
+    for (u64 index = 1; index < corpus->count; ++index) {
+        if (hashes[index - 1] == hashes[index]) { distinct = false; }
+    }
+    deallocate(hashes);
+    if (!distinct) {
+        file_write(SV("hash_cstring collides\n"), stderr);
+        return false;
+    }
+    return true;
+}
+
+static bool test_lengths() {
+    // every length of tail, each string differs from the next only
+    // in its final byte, or in its length.
+    char buffer[64] = {0};
+    u64  hashes[2 * sizeof(buffer)];
+    for (u64 length = 0; length < sizeof(buffer); ++length) {
+        hashes[2 * length] = hash_cstring(buffer, length);
+        if (length > 0) { buffer[length - 1] = 'x'; }
+        hashes[(2 * length) + 1] = hash_cstring(buffer, length);
+        if (length > 0) { buffer[length - 1] = 0; }
+    }
+
+    u64 count = 2 * sizeof(buffer);
+    for (u64 i = 0; i < count; ++i) {
+        for (u64 j = i + 1; j < count; ++j) {
+            // the empty string is the same with or without an x
+            if ((i == 0) && (j == 1)) { continue; }
+            if (hashes[i] == hashes[j]) {
+                file_write(SV("hash_cstring collides on length "), stderr);
+                file_write_u64(i / 2, stderr);
+                file_write(SV("\n"), stderr);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool
+check_corpus(StringView name, Corpus const *restrict corpus, bool benchmark) {
+    if (benchmark) { benchmark_corpus(name, corpus); }
+    return test_corpus(corpus);
+}
+
+i32 hash_tests(i32 argc, char **argv) {
+    bool benchmark = (argc > 1) && (strcmp(argv[1], "--benchmark") == 0);
+    bool success   = test_lengths();
+
+    Corpus excerpt_corpus = {.text = string_create()};
+    corpus_from_text(&excerpt_corpus,
+                     string_view(excerpt, sizeof(excerpt) - 1));
+    success &= check_corpus(SV("compiler excerpt"), &excerpt_corpus, benchmark);
+    corpus_destroy(&excerpt_corpus);
+
+    Corpus locals_corpus = {.text = string_create()};
+    corpus_generated(&locals_corpus, SV("x"), 20000);
+    success &= check_corpus(SV("generated locals"), &locals_corpus, benchmark);
+    corpus_destroy(&locals_corpus);
+
+    Corpus functions_corpus = {.text = string_create()};
+    corpus_generated(&functions_corpus, SV("function_"), 20000);
+    success &=
+        check_corpus(SV("generated functions"), &functions_corpus, benchmark);
+    corpus_destroy(&functions_corpus);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
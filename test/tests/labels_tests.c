@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+
+#include "env/labels.h"
+#include "env/string_interner.h"
+
+static bool test_labels(StringInterner *restrict interner) {
+    bool   failure = 0;
+    Labels labels  = labels_create();
+
+    enum { COUNT = 64 };
+    ConstantString *names[COUNT];
+    char            buffer[8];
+    for (u32 i = 0; i < COUNT; ++i) {
+        buffer[0] = 'f';
+        buffer[1] = (char)('0' + (i / 10));
+        buffer[2] = (char)('0' + (i % 10));
+        names[i]  = string_interner_insert(interner, string_view(buffer, 3));
+        failure |= labels_insert(&labels, names[i]) != i;
+    }
+
+    // inserting a label again yields the index it was given first.
+    for (u32 i = 0; i < COUNT; ++i) {
+        failure |= labels_insert(&labels, names[i]) != i;
+        failure |= labels_at(&labels, i) != names[i];
+    }
+    failure |= labels.count != COUNT;
+
+    labels_destroy(&labels);
+    failure |= labels.buffer != NULL;
+    return failure;
+}
+
+i32 labels_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
+    bool           failure  = 0;
+    StringInterner interner = string_interner_create();
+
+    failure |= test_labels(&interner);
+
+    string_interner_destroy(&interner);
+    if (failure) {
+        return EXIT_FAILURE;
+    } else {
+        return EXIT_SUCCESS;
+    }
+}
@@ -40,6 +40,32 @@ static bool test_lexer_scans_token(const char *buffer, Token token) {
     }
 }
 
+// return true on failure
+static bool test_lexer_scans_text(const char *buffer,
+                                  Token       token,
+                                  const char *text,
+                                  u64         line,
+                                  u64         column) {
+    Lexer lexer;
+    lexer_init(&lexer);
+    lexer_set_view(&lexer, buffer, strlen(buffer));
+
+    Token      scanned  = lexer_scan(&lexer);
+    StringView view     = lexer_current_text(&lexer);
+    StringView expected = string_view_from_cstring(text);
+    if ((scanned != token) || !string_view_equal(view, expected) ||
+        (lexer_current_line(&lexer) != line) ||
+        (lexer_current_column(&lexer) != column)) {
+        fputs("failed match: ", stderr);
+        fputs("\n", stderr);
+        fputs(buffer, stderr);
+        fputs("\n", stderr);
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
 i32 lexer_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
     bool failed = 0;
 
@@ -66,6 +92,10 @@ i32 lexer_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
     failed |= test_lexer_scans_token("+", TOK_PLUS);
     failed |= test_lexer_scans_token("/", TOK_SLASH);
     failed |= test_lexer_scans_token("*", TOK_STAR);
+    failed |= test_lexer_scans_token("%", TOK_PERCENT);
+    failed |= test_lexer_scans_token(".", TOK_DOT);
+    failed |= test_lexer_scans_token("()", TOK_NIL);
+    failed |= test_lexer_scans_token("@", TOK_ERROR_UNEXPECTED_CHAR);
 
     failed |= test_lexer_scans_token("fn", TOK_FN);
     failed |= test_lexer_scans_token("f", TOK_IDENTIFIER);
@@ -124,6 +154,9 @@ i32 lexer_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
     failed |= test_lexer_scans_token("i64", TOK_TYPE_I64);
     failed |= test_lexer_scans_token("i63", TOK_IDENTIFIER);
     failed |= test_lexer_scans_token("i", TOK_IDENTIFIER);
+    failed |= test_lexer_scans_token("u6", TOK_IDENTIFIER);
+    failed |= test_lexer_scans_token("i4", TOK_IDENTIFIER);
+    failed |= test_lexer_scans_token("vat", TOK_IDENTIFIER);
 
     failed |= test_lexer_scans_token("hello", TOK_IDENTIFIER);
     failed |= test_lexer_scans_token("hello1232", TOK_IDENTIFIER);
@@ -131,6 +164,35 @@ i32 lexer_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
 
     failed |= test_lexer_scans_token("\"hello world!\"", TOK_STRING_LITERAL);
 
+    // runs which span more than one block
+    failed |= test_lexer_scans_text(
+        "a_very_long_identifier_which_spans_several_blocks_0123456789;",
+        TOK_IDENTIFIER,
+        "a_very_long_identifier_which_spans_several_blocks_0123456789",
+        1,
+        1);
+    failed |= test_lexer_scans_text("12345678901234567890123456789012345+",
+                                    TOK_INTEGER,
+                                    "12345678901234567890123456789012345",
+                                    1,
+                                    1);
+    failed |= test_lexer_scans_text(
+        "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t x",
+        TOK_IDENTIFIER,
+        "x",
+        1,
+        35);
+    failed |= test_lexer_scans_text(
+        "// a comment which is longer than a single block\n"
+        "  // and another\n"
+        "\r\n    fn",
+        TOK_FN,
+        "fn",
+        4,
+        5);
+    failed |=
+        test_lexer_scans_text("// a comment at the end", TOK_END, "", 1, 24);
+
     if (failed) {
         return 1;
     } else {
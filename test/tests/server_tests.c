@@ -0,0 +1,218 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "support/config.h"
+#include "support/io.h"
+#include "support/process.h"
+#include "test_exp.h"
+#include "test_resources.h"
+
+#define SERVER_SOCKET EXP_BINARY_DIR "/server_tests.socket"
+
+static bool server_wait_for_socket() {
+    struct timespec delay = {.tv_sec = 0, .tv_nsec = 10000000};
+    for (u64 attempt = 0; attempt < 500; ++attempt) {
+        if (access(SERVER_SOCKET, F_OK) == 0) { return true; }
+        nanosleep(&delay, NULL);
+    }
+    return false;
+}
+
+/**
+ * @brief start the server, which is sent SIGTERM when we exit, even
+ * when we exit abnormally, so that it cannot outlive the test while
+ * holding the test's stdout and stderr.
+ */
+static pid_t server_spawn(char const *exp_path) {
+    pid_t test   = getpid();
+    pid_t server = fork();
+    if (server == 0) {
+        if ((prctl(PR_SET_PDEATHSIG, SIGTERM) != 0) || (getppid() != test)) {
+            _exit(EXIT_FAILURE);
+        }
+        execl(exp_path, exp_path, "--server", (char *)NULL);
+        _exit(EXIT_FAILURE);
+    }
+    return server;
+}
+
+static i32 server_await(pid_t server) {
+    i32 status = 0;
+    if ((server < 0) || (waitpid(server, &status, 0) != server) ||
+        !WIFEXITED(status)) {
+        return EXIT_FAILURE;
+    }
+    return WEXITSTATUS(status);
+}
+
+/**
+ * @brief send the server a request of <length>, holding only <argc>,
+ * along with our stdout, stderr and working directory.
+ *
+ * @return true if the server rejected the request, by closing the
+ * connection or by responding with EXIT_FAILURE.
+ */
+static bool server_rejects(u64 length, u32 argc) {
+    i32 connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0) { return false; }
+
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    memcpy(address.sun_path, SERVER_SOCKET, sizeof(SERVER_SOCKET));
+    if (connect(connection, (struct sockaddr *)&address, sizeof(address)) !=
+        0) {
+        close(connection);
+        return false;
+    }
+
+    i32 cwd    = open(".", O_RDONLY | O_DIRECTORY);
+    i32 fds[3] = {STDOUT_FILENO, STDERR_FILENO, cwd};
+    union {
+        char           buffer[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    u8 bytes[sizeof(length) + sizeof(argc)];
+    memcpy(bytes, &length, sizeof(length));
+    memcpy(bytes + sizeof(length), &argc, sizeof(argc));
+    struct iovec  iov    = {.iov_base = bytes, .iov_len = sizeof(bytes)};
+    struct msghdr header = {
+        .msg_iov        = &iov,
+        .msg_iovlen     = 1,
+        .msg_control    = control.buffer,
+        .msg_controllen = sizeof(control.buffer),
+    };
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header);
+    cmsg->cmsg_level     = SOL_SOCKET;
+    cmsg->cmsg_type      = SCM_RIGHTS;
+    cmsg->cmsg_len       = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    bool    rejected = false;
+    i32     response = EXIT_SUCCESS;
+    ssize_t sent     = sendmsg(connection, &header, MSG_NOSIGNAL);
+    if (sent == (ssize_t)sizeof(bytes)) {
+        // the server may close without reading all of the request,
+        // which is reported as a reset rather than the end of file.
+        ssize_t count = read(connection, &response, sizeof(response));
+        rejected      = (count <= 0) || (response == EXIT_FAILURE);
+    }
+
+    close(cwd);
+    close(connection);
+    return rejected;
+}
+
+/**
+ * @brief compile <source> through the server, which must respond with
+ * the path of the executable it created.
+ */
+static bool server_returns_artifact(StringView source) {
+    char const *exp_path = EXP_BINARY_DIR "/exp/source/exp";
+    char const *args[]   = {exp_path, "--client", source.ptr, NULL};
+    String      output   = string_create();
+    i32         status =
+        process_piped(exp_path, 3, args, string_view(nullptr, 0), &output);
+
+    String executable = string_create();
+    string_assign(&executable, source);
+    string_replace_extension(&executable, SV(""));
+    file_remove(string_to_cstring(&executable));
+    string_append(&executable, SV("\n"));
+
+    bool returned = (status == EXIT_SUCCESS) &&
+                    string_view_equal(string_to_view(&output),
+                                      string_to_view(&executable));
+    string_destroy(&executable);
+    string_destroy(&output);
+    return returned;
+}
+
+i32 server_tests([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    // inherited by the server and by each client
+    setenv("EXP_SERVER_SOCKET", SERVER_SOCKET, 1);
+    unlink(SERVER_SOCKET);
+
+    char const *exp_path = EXP_BINARY_DIR "/exp/source/exp";
+    pid_t       server   = server_spawn(exp_path);
+
+    i32 result = EXIT_SUCCESS;
+    if (!server_wait_for_socket()) {
+        file_write(SV("server never listened\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    // none of these may stop the server, which must go on to serve
+    // every resource below.
+    if ((result == EXIT_SUCCESS) && !server_rejects(UINT64_MAX, 1)) {
+        file_write(SV("server accepted an oversized request\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    if ((result == EXIT_SUCCESS) && !server_rejects(sizeof(u32), UINT32_MAX)) {
+        file_write(SV("server accepted an impossible argc\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    char const *missing_args[] = {
+        exp_path, "--client", EXP_BINARY_DIR "/server_tests.missing.exp", NULL};
+    if ((result == EXIT_SUCCESS) &&
+        (process(exp_path, 3, missing_args) == EXIT_SUCCESS)) {
+        file_write(SV("server compiled a missing source\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    TestResources test_resources;
+    test_resources_initialize_isolated(&test_resources, "server_tests");
+
+    if ((result == EXIT_SUCCESS) && (test_resources.count > 0) &&
+        !server_returns_artifact(string_to_view(test_resources.buffer))) {
+        file_write(SV("server did not return the executable path\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    for (u64 index = 0;
+         (result == EXIT_SUCCESS) && (index < test_resources.count);
+         ++index) {
+        String *resource = test_resources.buffer + index;
+        file_write(SV("testing served resource: "), stderr);
+        file_write(string_to_view(resource), stderr);
+        file_write(SV("\n"), stderr);
+        // each worker reuses the interners of its previous requests
+        result |= test_source_with_option(string_to_view(resource), "--client");
+    }
+
+    test_resources_terminate(&test_resources);
+
+    if (server > 0) { kill(server, SIGTERM); }
+    result |= server_await(server);
+    return result;
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "support/allocation.h"
+#include "support/io.h"
+#include "support/process.h"
+#include "test_exp.h"
+#include "test_resources.h"
+
+/*
+ * cat(1) writes its output before it has read all of its input, which
+ * deadlocks a parent that writes the input with blocking writes once
+ * both pipes fill.
+ */
+static i32 test_piped_cat() {
+    u64   length = 1 << 20;
+    char *input  = allocate(length);
+    for (u64 index = 0; index < length; ++index) {
+        input[index] = (char)('a' + (index % 26));
+    }
+
+    char const *args[] = {"cat", nullptr};
+    String      output = string_create();
+    i32         status =
+        process_piped("cat", 1, args, string_view(input, length), &output);
+
+    i32 result = EXIT_SUCCESS;
+    if ((status != EXIT_SUCCESS) ||
+        !string_view_equal(string_to_view(&output),
+                           string_view(input, length))) {
+        file_write(SV("cat did not echo its input\n"), stderr);
+        result = EXIT_FAILURE;
+    }
+
+    string_destroy(&output);
+    deallocate(input);
+    return result;
+}
+
+i32 stream_tests([[maybe_unused]] int argc, [[maybe_unused]] char **argv) {
+    if (test_piped_cat() != EXIT_SUCCESS) { return EXIT_FAILURE; }
+
+    i32           result = EXIT_SUCCESS;
+    TestResources test_resources;
+    test_resources_initialize_isolated(&test_resources, "stream_tests");
+
+    for (u64 index = 0; index < test_resources.count; ++index) {
+        String *resource = test_resources.buffer + index;
+        file_write(SV("testing streamed resource: "), stderr);
+        file_write(string_to_view(resource), stderr);
+        file_write(SV("\n"), stderr);
+        StringView path = string_to_view(resource);
+        if ((test_source_with_option(path, "-m") != EXIT_SUCCESS) ||
+            (test_source_with_option(path, "-mb") != EXIT_SUCCESS) ||
+            (test_source_with_option(path, "-mdb") != EXIT_SUCCESS)) {
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    test_resources_terminate(&test_resources);
+    return result;
+}
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 
 #include "env/string_interner.h"
+#include "support/string.h"
 
 i32 string_interner_tests([[maybe_unused]] i32   argc,
                           [[maybe_unused]] char *argv[]) {
@@ -36,6 +37,43 @@ i32 string_interner_tests([[maybe_unused]] i32   argc,
     failure |= !string_view_equal(sv0, sv2);
     failure |= string_view_equal(sv1, sv2);
 
+    // enough strings to grow the table and fill several chunks.
+    ConstantString *numbers[4096];
+    for (u64 index = 0; index < 4096; ++index) {
+        String number = string_create();
+        string_append_u64(&number, index);
+        numbers[index] = string_interner_insert(&si, string_to_view(&number));
+        string_destroy(&number);
+    }
+
+    for (u64 index = 0; index < 4096; ++index) {
+        String number = string_create();
+        string_append_u64(&number, index);
+        ConstantString *again =
+            string_interner_insert(&si, string_to_view(&number));
+        failure |= again != numbers[index];
+        failure |= !constant_string_equal(again, string_to_view(&number));
+        failure |= again->data[again->length] != '\0';
+        string_destroy(&number);
+    }
+
+    // a string larger than any chunk.
+    String long_string = string_create();
+    for (u64 index = 0; index < 8192; ++index) {
+        string_append(&long_string, SV("x"));
+    }
+    ConstantString *long_constant =
+        string_interner_insert(&si, string_to_view(&long_string));
+    failure |= long_constant !=
+               string_interner_insert(&si, string_to_view(&long_string));
+    string_destroy(&long_string);
+
+    string_interner_clear(&si);
+    failure |= si.count != 0;
+    StringView sv3 =
+        constant_string_to_view(string_interner_insert(&si, SV("hello")));
+    failure |= !string_view_equal(sv3, SV("hello"));
+
     string_interner_destroy(&si);
     if (failure) {
         return EXIT_FAILURE;
@@ -16,10 +16,13 @@
  * You should have received a copy of the GNU General Public License
  * along with exp.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "env/symbol_table.h"
+#include "support/allocation.h"
 
 bool test_symbol_table(SymbolTable *restrict symbol_table, char const *name) {
     bool failure = 0;
@@ -34,6 +37,45 @@ bool test_symbol_table(SymbolTable *restrict symbol_table, char const *name) {
     return failure;
 }
 
+/*
+ * enough names to grow the table several times, each of which
+ * must be found again, as the same symbol, afterwards.
+ */
+bool test_symbol_table_growth() {
+    bool        failure      = 0;
+    SymbolTable symbol_table = symbol_table_create();
+    enum { COUNT = 1000 };
+    static char names[COUNT][16];
+    Symbol     *symbols[COUNT];
+
+    for (u32 i = 0; i < COUNT; ++i) {
+        snprintf(names[i], sizeof(names[i]), "f%u", i);
+        symbols[i] =
+            symbol_table_at(&symbol_table, string_view_from_cstring(names[i]));
+    }
+    failure |= symbol_table.count != COUNT;
+
+    for (u32 i = 0; i < COUNT; ++i) {
+        Symbol *symbol =
+            symbol_table_at(&symbol_table, string_view_from_cstring(names[i]));
+        failure |= symbol != symbols[i];
+    }
+    failure |= symbol_table.count != COUNT;
+
+    Symbol **sorted = symbol_table_sorted(&symbol_table);
+    for (u32 i = 1; i < COUNT; ++i) {
+        StringView a = sorted[i - 1]->name;
+        StringView b = sorted[i]->name;
+        u64        n = (a.length < b.length) ? a.length : b.length;
+        i32        c = memcmp(a.ptr, b.ptr, n);
+        failure |= (c > 0) || ((c == 0) && (a.length >= b.length));
+    }
+    deallocate(sorted);
+
+    symbol_table_destroy(&symbol_table);
+    return failure;
+}
+
 i32 symbol_table_tests([[maybe_unused]] i32   argc,
                        [[maybe_unused]] char *argv[]) {
     srand((unsigned)time(NULL));
@@ -49,6 +91,9 @@ i32 symbol_table_tests([[maybe_unused]] i32   argc,
     failure |= test_symbol_table(&symbol_table, "acb");
     failure |= test_symbol_table(&symbol_table, "cba");
     failure |= test_symbol_table(&symbol_table, "bac");
+    failure |= test_symbol_table(&symbol_table, "foo");
+    failure |= symbol_table.count != 9;
+    failure |= test_symbol_table_growth();
 
     symbol_table_destroy(&symbol_table);
     if (failure) {
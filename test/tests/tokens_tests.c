@@ -0,0 +1,184 @@
+/**
+ * Copyright (C) 2025 Cade Weinberg
+ *
+ * This file is part of exp.
+ *
+ * exp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * exp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with exp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "scanning/tokens.h"
+#include "support/allocation.h"
+#include "support/thread_pool.h"
+
+// return true on failure
+static bool test_token(Tokens const *restrict tokens,
+                       u32         index,
+                       Token       kind,
+                       char const *text,
+                       u64         line) {
+    StringView expected = string_view_from_cstring(text);
+    if ((tokens_kind(tokens, index) != kind) ||
+        !string_view_equal(tokens_text(tokens, index), expected) ||
+        (tokens_line(tokens, index) != line)) {
+        fputs("failed match: ", stderr);
+        fputs(text, stderr);
+        fputs("\n", stderr);
+        return 1;
+    }
+    return 0;
+}
+
+// return true on failure
+static bool test_chunked(char const *buffer, u64 chunk_count) {
+    Tokens whole;
+    Tokens chunked;
+    tokens_create(&whole);
+    tokens_create(&chunked);
+    tokens_scan(&whole, buffer, strlen(buffer));
+    tokens_scan_chunked(&chunked, buffer, strlen(buffer), chunk_count);
+
+    bool failed = whole.count != chunked.count;
+    for (u32 index = 0; !failed && (index < whole.count); ++index) {
+        failed = (whole.kinds[index] != chunked.kinds[index]) ||
+                 (whole.offsets[index] != chunked.offsets[index]) ||
+                 (whole.lengths[index] != chunked.lengths[index]);
+    }
+
+    if (failed) {
+        fputs("chunked scan differs: ", stderr);
+        fputs(buffer, stderr);
+        fputs("\n", stderr);
+    }
+
+    tokens_destroy(&whole);
+    tokens_destroy(&chunked);
+    return failed;
+}
+
+typedef struct TestPooledScan {
+    ThreadPool *pool;
+    char const *buffer;
+    u64         length;
+    Tokens      tokens;
+    bool        current;
+} TestPooledScan;
+
+static void test_pooled_scan_task(void *argument) {
+    TestPooledScan *scan = argument;
+    scan->current        = thread_pool_current() == scan->pool;
+    tokens_scan(&scan->tokens, scan->buffer, scan->length);
+}
+
+// return true on failure
+static bool test_pooled_scan() {
+    // large enough to be scanned in chunks, when there are threads
+    // to spare.
+    char const *line   = "let abc = 123 + \"a string\";\n";
+    u64         size   = strlen(line);
+    u64         length = 0;
+    u64         total  = (u64)5 << 20;
+    char       *buffer = allocate(total + 1);
+    while ((length + size) <= total) {
+        memcpy(buffer + length, line, size);
+        length += size;
+    }
+    buffer[length] = '\0';
+
+    // a pool as wide as the host leaves no threads to spare, so the
+    // scan within it must still be correct, without chunking.
+    ThreadPool pool;
+    thread_pool_create(&pool, thread_pool_hardware_concurrency());
+    TestPooledScan scan = {
+        .pool = &pool, .buffer = buffer, .length = length, .current = false};
+    tokens_create(&scan.tokens);
+    thread_pool_submit(&pool, test_pooled_scan_task, &scan);
+    thread_pool_wait(&pool);
+    thread_pool_destroy(&pool);
+
+    Tokens whole;
+    tokens_create(&whole);
+    tokens_scan(&whole, buffer, length);
+
+    bool failed = !scan.current || (thread_pool_current() != NULL) ||
+                  (whole.count != scan.tokens.count) ||
+                  (memcmp(whole.kinds, scan.tokens.kinds, whole.count) != 0);
+    if (failed) { fputs("pooled scan differs\n", stderr); }
+
+    tokens_destroy(&whole);
+    tokens_destroy(&scan.tokens);
+    deallocate(buffer);
+    return failed;
+}
+
+i32 tokens_tests([[maybe_unused]] i32 argc, [[maybe_unused]] char *argv[]) {
+    bool        failed = 0;
+    char const *buffer = "fn f() -> i64 {\n"
+                         "    // a comment\n"
+                         "    return 1 + x;\n"
+                         "}\n";
+
+    Tokens tokens;
+    tokens_create(&tokens);
+    tokens_scan(&tokens, buffer, strlen(buffer));
+
+    failed |= test_token(&tokens, 0, TOK_FN, "fn", 1);
+    failed |= test_token(&tokens, 1, TOK_IDENTIFIER, "f", 1);
+    failed |= test_token(&tokens, 2, TOK_NIL, "()", 1);
+    failed |= test_token(&tokens, 3, TOK_RIGHT_ARROW, "->", 1);
+    failed |= test_token(&tokens, 4, TOK_TYPE_I64, "i64", 1);
+    failed |= test_token(&tokens, 5, TOK_BEGIN_BRACE, "{", 1);
+    failed |= test_token(&tokens, 6, TOK_RETURN, "return", 3);
+    failed |= test_token(&tokens, 7, TOK_INTEGER, "1", 3);
+    failed |= test_token(&tokens, 8, TOK_PLUS, "+", 3);
+    failed |= test_token(&tokens, 9, TOK_IDENTIFIER, "x", 3);
+    failed |= test_token(&tokens, 10, TOK_SEMICOLON, ";", 3);
+    failed |= test_token(&tokens, 11, TOK_END_BRACE, "}", 4);
+    failed |= test_token(&tokens, 12, TOK_END, "", 5);
+    failed |= (tokens.count != 13);
+
+    // lookahead past the end sees the final token
+    failed |= test_token(&tokens, 100, TOK_END, "", 5);
+
+    tokens_destroy(&tokens);
+
+    // string literals which cross one or more chunk boundaries
+    char const *strings = "fn f() {\n"
+                          "  let a = \"one\n"
+                          "two\n"
+                          "three\";\n"
+                          "  // \"\n"
+                          "  let b = 12;\n"
+                          "  let c = \"\n"
+                          "\n"
+                          "\n"
+                          "\";\n"
+                          "  return a;\n"
+                          "}\n"
+                          "\"unmatched\n"
+                          "at the end\n";
+    for (u64 chunk_count = 1; chunk_count <= 24; ++chunk_count) {
+        failed |= test_chunked(buffer, chunk_count);
+        failed |= test_chunked(strings, chunk_count);
+    }
+
+    failed |= test_pooled_scan();
+
+    if (failed) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
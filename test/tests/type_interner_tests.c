@@ -34,6 +34,76 @@ i32 type_interner_tests([[maybe_unused]] i32   argc,
     failure |= type_equality(t2, t0);
     failure |= t0 == t2;
 
+    TupleType a = tuple_type_create();
+    tuple_type_append(&a, t0);
+    tuple_type_append(&a, t2);
+    TupleType b = tuple_type_create();
+    tuple_type_append(&b, t0);
+    tuple_type_append(&b, t2);
+    TupleType c = tuple_type_create();
+    tuple_type_append(&c, t2);
+    tuple_type_append(&c, t0);
+    Type const *t3 = type_interner_tuple_type(&ti, a);
+    Type const *t4 = type_interner_tuple_type(&ti, b);
+    Type const *t5 = type_interner_tuple_type(&ti, c);
+    failure |= t3 != t4;
+    failure |= t3 == t5;
+    failure |= ti.tuple_types.size != 2;
+
+    TupleType d = tuple_type_create();
+    tuple_type_append(&d, t3);
+    TupleType e = tuple_type_create();
+    tuple_type_append(&e, t4);
+    Type const *t6 = type_interner_function_type(&ti, t0, d);
+    Type const *t7 = type_interner_function_type(&ti, t0, e);
+    Type const *t8 = type_interner_function_type(&ti, t2, tuple_type_create());
+    Type const *t9 = type_interner_function_type(&ti, t2, tuple_type_create());
+    failure |= t6 != t7;
+    failure |= t8 != t9;
+    failure |= t6 == t8;
+    failure |= ti.function_types.size != 2;
+
+    // (i64, nil) is laid out without padding.
+    failure |= t3->layout.size != 9;
+    failure |= t3->layout.alignment != 1;
+    failure |= (t3->layout.size % t3->layout.alignment) != 0;
+    failure |= t3->layout.offsets[0] != 0;
+    failure |= t3->layout.offsets[1] != 8;
+    failure |= t5->layout.offsets[1] != 1;
+    failure |= t0->layout.size != 8;
+    failure |= t0->layout.offsets != NULL;
+
+    // a nested tuple is packed too, and keeps a whole size.
+    TupleType k = tuple_type_create();
+    tuple_type_append(&k, t3);
+    tuple_type_append(&k, t0);
+    Type const *t12 = type_interner_tuple_type(&ti, k);
+    failure |= t12->layout.size != 17;
+    failure |= t12->layout.alignment != 1;
+    failure |= t12->layout.offsets[1] != 9;
+
+    // the table must survive growth, and clearing.
+    Type const *t10 = t3;
+    for (u32 i = 0; i < 64; ++i) {
+        TupleType f = tuple_type_create();
+        tuple_type_append(&f, t10);
+        tuple_type_append(&f, t0);
+        t10 = type_interner_tuple_type(&ti, f);
+    }
+    TupleType g = tuple_type_create();
+    tuple_type_append(&g, t0);
+    tuple_type_append(&g, t2);
+    failure |= type_interner_tuple_type(&ti, g) != t3;
+
+    type_interner_clear(&ti);
+    failure |= ti.tuple_types.size != 0;
+    TupleType h = tuple_type_create();
+    tuple_type_append(&h, t0);
+    tuple_type_append(&h, t2);
+    Type const *t11 = type_interner_tuple_type(&ti, h);
+    failure |= ti.tuple_types.size != 1;
+    failure |= t11->tuple_type.size != 2;
+
     type_interner_destroy(&ti);
     if (failure) {
         return EXIT_FAILURE;